@@ -1,5 +1,6 @@
 #include "Game/App.hpp"
 
+#include "Game/AssetBackend.hpp"
 #include "Game/GameCommon.hpp"
 
 #include "Engine/Core/Clock.hpp"
@@ -22,6 +23,8 @@ Window* g_window = nullptr;
 BitmapFont* g_squirrelFont = nullptr;
 ModelLoader* g_modelLoader = nullptr;
 
+static EngineAssetBackend s_engineAssetBackend;
+
 double g_frameTime = 0.f;
 double g_updateTime = 0.f;
 double g_renderTime = 0.f;
@@ -124,6 +127,8 @@ void App::Startup()
 	g_audio->Startup();
 	DebugRenderSystemStartup(debugRenderConfig);
 	g_modelLoader->Startup();
+	// Definitions are read in the Game constructor, and load their models, textures and shaders through this
+	g_assetBackend = &s_engineAssetBackend;
 
 	SCREEN_SIZE_X = SCREEN_SIZE_Y * g_window->GetAspect();
 
@@ -180,6 +185,9 @@ void App::BeginFrame()
 {
 	Clock::TickSystemClock();
 
+	g_lastFrameRenderStats = g_frameRenderStats;
+	g_frameRenderStats = FrameRenderStats();
+
 	m_frameRate = 1.f / Clock::GetSystemClock().GetDeltaSeconds();
 
 	g_eventSystem->BeginFrame();
@@ -250,7 +258,7 @@ void App::Render() const
 		g_renderer->SetSamplerMode(SamplerMode::POINT_CLAMP);
 		g_renderer->BindTexture(m_showHandCursor ? m_handCursorTexture : m_defaultCursorTexture);
 		g_renderer->BindShader(nullptr);
-		g_renderer->DrawVertexArray(cursorVerts);
+		DrawVertexArray(cursorVerts);
 		g_renderer->EndCamera(m_game->m_screenCamera);
 	}
 
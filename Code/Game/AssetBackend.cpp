@@ -0,0 +1,35 @@
+#include "Game/AssetBackend.hpp"
+
+#include "Engine/Core/EngineCommon.hpp"
+
+
+// Part of the simulation library, which never links the engine's renderer, so it starts out loading nothing
+static NullAssetBackend s_nullAssetBackend;
+AssetBackend* g_assetBackend = &s_nullAssetBackend;
+
+
+Model* NullAssetBackend::CreateOrGetModel(std::string const& filePath, Mat44 const& transform)
+{
+	UNUSED(filePath);
+	UNUSED(transform);
+	return nullptr;
+}
+
+std::vector<Vertex_PCUTBN> const* NullAssetBackend::GetModelVertexes(Model const* model)
+{
+	UNUSED(model);
+	return nullptr;
+}
+
+Texture* NullAssetBackend::CreateOrGetTexture(std::string const& filePath)
+{
+	UNUSED(filePath);
+	return nullptr;
+}
+
+Shader* NullAssetBackend::CreateOrGetShader(std::string const& shaderName, bool hasPackedVertexes)
+{
+	UNUSED(shaderName);
+	UNUSED(hasPackedVertexes);
+	return nullptr;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Engine/Core/VertexUtils.hpp"
+#include "Engine/Math/Mat44.hpp"
+
+#include <string>
+#include <vector>
+
+class Model;
+class Shader;
+class Texture;
+
+
+// The asset loads made while reading definitions, so definitions can be read with or without a renderer and model loader
+class AssetBackend
+{
+public:
+	virtual ~AssetBackend() = default;
+
+	virtual Model* CreateOrGetModel(std::string const& filePath, Mat44 const& transform) = 0;
+	virtual std::vector<Vertex_PCUTBN> const* GetModelVertexes(Model const* model) = 0;
+	virtual Texture* CreateOrGetTexture(std::string const& filePath) = 0;
+	// Packed map shaders read Vertex_MapPacked, which shares the VERTEX_PCU layout; every other shader reads Vertex_PCUTBN
+	virtual Shader* CreateOrGetShader(std::string const& shaderName, bool hasPackedVertexes) = 0;
+};
+
+
+// Loads through g_modelLoader and g_renderer; App::Startup switches to it once both exist
+class EngineAssetBackend : public AssetBackend
+{
+public:
+	~EngineAssetBackend() = default;
+	EngineAssetBackend() = default;
+
+	Model* CreateOrGetModel(std::string const& filePath, Mat44 const& transform) override;
+	std::vector<Vertex_PCUTBN> const* GetModelVertexes(Model const* model) override;
+	Texture* CreateOrGetTexture(std::string const& filePath) override;
+	Shader* CreateOrGetShader(std::string const& shaderName, bool hasPackedVertexes) override;
+};
+
+
+// Loads nothing, so definitions keep their asset paths and gameplay values but no models, textures or shaders
+// This is the default, and what the simulation library runs with
+class NullAssetBackend : public AssetBackend
+{
+public:
+	~NullAssetBackend() = default;
+	NullAssetBackend() = default;
+
+	Model* CreateOrGetModel(std::string const& filePath, Mat44 const& transform) override;
+	std::vector<Vertex_PCUTBN> const* GetModelVertexes(Model const* model) override;
+	Texture* CreateOrGetTexture(std::string const& filePath) override;
+	Shader* CreateOrGetShader(std::string const& shaderName, bool hasPackedVertexes) override;
+};
+
+
+extern AssetBackend* g_assetBackend;
@@ -0,0 +1,1971 @@
+#include "Game/Benchmarks.hpp"
+
+#include "Game/App.hpp"
+#include "Game/Block.hpp"
+#include "Game/CookedMap.hpp"
+#include "Game/Enemy.hpp"
+#include "Game/EnemyDefinition.hpp"
+#include "Game/EnemySimData.hpp"
+#include "Game/Game.hpp"
+#include "Game/JobSystem.hpp"
+#include "Game/GameCommon.hpp"
+#include "Game/Map.hpp"
+#include "Game/MapDefinition.hpp"
+#include "Game/MapMesh.hpp"
+#include "Game/MeshIndexing.hpp"
+#include "Game/PackedMapVertex.hpp"
+#include "Game/ParticleSystem.hpp"
+#include "Game/RenderBackend.hpp"
+#include "Game/Tower.hpp"
+#include "Game/TowerDefinition.hpp"
+
+#include "Engine/Core/DevConsole.hpp"
+#include "Engine/Core/Models/CPUMesh.hpp"
+#include "Engine/Core/Models/Model.hpp"
+#include "Engine/Core/Time.hpp"
+
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <psapi.h>
+#include <cstdio>
+#include <cstring>
+#include <queue>
+
+
+static Map* CreateBenchmarkMap(std::string const& mapName)
+{
+	auto mapDefIter = MapDefinition::s_mapDefs.find(mapName);
+	if (mapDefIter == MapDefinition::s_mapDefs.end())
+	{
+		g_console->AddLine(Rgba8::RED, Stringf("Could not benchmark unknown map \"%s\"", mapName.c_str()));
+		return nullptr;
+	}
+
+	return new Map(g_app->m_game, mapDefIter->second, true);
+}
+
+static Vec3 GetRandomTraversablePosition(std::vector<IntVec2> const& traversableBlocks)
+{
+	IntVec2 const& blockCoords = traversableBlocks[g_RNG->RollRandomIntLessThan((int)traversableBlocks.size())];
+	return Vec3((float)blockCoords.x + g_RNG->RollRandomFloatZeroToOne(), (float)blockCoords.y + g_RNG->RollRandomFloatZeroToOne(), 0.f);
+}
+
+// Reference implementation of the targeting query as a full scan of every enemy on the map
+static Enemy* GetTargetWithinRangeLinear(Map* map, Vec3 const& towerPosition, float range)
+{
+	Enemy* target = nullptr;
+	float targetHeatValue = 99999.f;
+
+	for (int enemyIndex = 0; enemyIndex < map->m_enemies.GetCount(); enemyIndex++)
+	{
+		Enemy* const& enemy = map->m_enemies[enemyIndex];
+		if (!map->IsEnemyAlive(enemy))
+		{
+			continue;
+		}
+
+		Vec3 enemyPosition = enemy->GetPosition();
+		if (IsPointInsideDisc2D(enemyPosition.GetXY(), towerPosition.GetXY(), range))
+		{
+			IntVec2 blockCoords = map->GetBlockCoordsForPoint(enemyPosition);
+			float enemyHeatValue = map->m_heatMap.Get(blockCoords);
+			bool isEarlierAtSameHeat = target && enemyHeatValue == targetHeatValue && enemy->m_spawnIndex < target->m_spawnIndex;
+			if (enemyHeatValue < targetHeatValue || isEarlierAtSameHeat)
+			{
+				target = enemy;
+				targetHeatValue = enemyHeatValue;
+			}
+		}
+	}
+
+	return target;
+}
+
+// Per-object enemy state laid out the way Enemy stored it before the movement kernel, used as the scalar reference
+struct BenchmarkEnemyState
+{
+public:
+	Vec3 m_position;
+	EulerAngles m_orientation;
+	Vec2 m_currentGoal;
+	float m_speed = 0.f;
+	float m_turnSpeed = 0.f;
+	float m_health = 0.f;
+	float m_timeSinceSpawn = 0.f;
+	float m_wavePhaseOffset = 0.f;
+	bool m_isDead = false;
+	char m_coldData[256] = {};
+};
+
+static void MoveEnemyScalar(BenchmarkEnemyState& enemy, float deltaSeconds)
+{
+	enemy.m_timeSinceSpawn += deltaSeconds;
+	if (enemy.m_isDead)
+	{
+		return;
+	}
+
+	if (GetDistance2D(enemy.m_position.GetXY(), enemy.m_currentGoal) >= EnemySimData::GOAL_REACHED_DISTANCE)
+	{
+		Vec2 directionToGoal = (enemy.m_currentGoal - enemy.m_position.GetXY()).GetNormalized();
+		float orientationToGoal = directionToGoal.GetOrientationDegrees();
+		enemy.m_orientation.m_yawDegrees = GetTurnedTowardDegrees(enemy.m_orientation.m_yawDegrees, orientationToGoal, enemy.m_turnSpeed * deltaSeconds);
+		enemy.m_position += (enemy.m_speed * directionToGoal * deltaSeconds).ToVec3(enemy.m_position.z);
+	}
+
+	enemy.m_position.z = 0.02f + 0.05f * sinf(5.f * enemy.m_timeSinceSpawn * (1.f + enemy.m_wavePhaseOffset));
+}
+
+// Per-object particle state laid out the way Particle stored it before the particle pool, used as the scalar reference
+struct BenchmarkParticleState
+{
+public:
+	Vec3 m_position;
+	Vec3 m_velocity;
+	float m_size = 0.f;
+	Rgba8 m_color;
+	unsigned char m_opacity = 255;
+	float m_elapsedSeconds = 0.f;
+	float m_lifetime = 0.f;
+	float m_rotation = 0.f;
+	float m_rotationSpeed = 0.f;
+	bool m_isDestroyed = false;
+};
+
+static void UpdateParticleScalar(BenchmarkParticleState& particle, float deltaSeconds)
+{
+	particle.m_elapsedSeconds += deltaSeconds;
+	if (particle.m_elapsedSeconds >= particle.m_lifetime)
+	{
+		particle.m_isDestroyed = true;
+	}
+
+	particle.m_opacity = DenormalizeByte(Interpolate(1.f, 0.f, GetClamped(particle.m_elapsedSeconds / particle.m_lifetime, 0.f, 1.f)));
+	particle.m_position += particle.m_velocity * deltaSeconds;
+	particle.m_rotation += particle.m_rotationSpeed * deltaSeconds;
+}
+
+// Hashes the gameplay state a tick can change, leaving out the RNG-driven bobbing height
+static unsigned int HashSimulationState(Map* map)
+{
+	unsigned int hash = FNV_OFFSET_BASIS;
+	for (int enemyIndex = 0; enemyIndex < map->m_enemies.GetCount(); enemyIndex++)
+	{
+		Enemy* enemy = map->m_enemies[enemyIndex];
+		Vec3 position = enemy->GetPosition();
+		float health = enemy->GetHealth();
+		hash = HashBytes(hash, &position.x, sizeof(position.x));
+		hash = HashBytes(hash, &position.y, sizeof(position.y));
+		hash = HashBytes(hash, &health, sizeof(health));
+		hash = HashBytes(hash, &enemy->m_spawnIndex, sizeof(enemy->m_spawnIndex));
+		hash = HashBytes(hash, &enemy->m_isDead, sizeof(enemy->m_isDead));
+	}
+
+	for (int towerIndex = 0; towerIndex < (int)map->m_towers.size(); towerIndex++)
+	{
+		Tower* tower = map->m_towers[towerIndex];
+		hash = HashBytes(hash, &tower->m_turretZOrientation, sizeof(tower->m_turretZOrientation));
+		hash = HashBytes(hash, &tower->m_target, sizeof(tower->m_target));
+	}
+
+	hash = HashBytes(hash, &map->m_money, sizeof(map->m_money));
+	hash = HashBytes(hash, &map->m_score, sizeof(map->m_score));
+	hash = HashBytes(hash, &map->m_remainingLives, sizeof(map->m_remainingLives));
+	return hash;
+}
+
+// Bytes committed privately by the process, so allocations that are never freed show up even if they are paged out
+static size_t GetProcessMemoryUsageBytes()
+{
+	PROCESS_MEMORY_COUNTERS_EX memoryCounters = {};
+	if (!GetProcessMemoryInfo(GetCurrentProcess(), (PROCESS_MEMORY_COUNTERS*)&memoryCounters, sizeof(memoryCounters)))
+	{
+		return 0;
+	}
+
+	return memoryCounters.PrivateUsage;
+}
+
+static void KeepWorstRenderFrame(RenderRecordingStats& worstStats, RenderRecordingStats const& frameStats)
+{
+	worstStats.m_numDrawCalls = frameStats.m_numDrawCalls > worstStats.m_numDrawCalls ? frameStats.m_numDrawCalls : worstStats.m_numDrawCalls;
+	worstStats.m_numStateChanges = frameStats.m_numStateChanges > worstStats.m_numStateChanges ? frameStats.m_numStateChanges : worstStats.m_numStateChanges;
+	worstStats.m_numUploads = frameStats.m_numUploads > worstStats.m_numUploads ? frameStats.m_numUploads : worstStats.m_numUploads;
+	worstStats.m_numBytesUploaded = frameStats.m_numBytesUploaded > worstStats.m_numBytesUploaded ? frameStats.m_numBytesUploaded : worstStats.m_numBytesUploaded;
+	worstStats.m_numBuffersCreated = frameStats.m_numBuffersCreated > worstStats.m_numBuffersCreated ? frameStats.m_numBuffersCreated : worstStats.m_numBuffersCreated;
+}
+
+// The map meshing path before chunking: copies the model twice per block and only strips side faces below the block's base height, whatever the neighbor is
+static void AddBlockVertsLegacy(Block const& block, std::vector<Vertex_PCUTBN>& verts, Vec3 const& position)
+{
+	constexpr float HSR_EQUALITY_TOLERANCE = 0.001f;
+
+	std::vector<Vertex_PCUTBN>& vertexes = block.GetDefinition().m_model->m_cpuMesh->m_vertexes;
+	std::vector<Vertex_PCUTBN> allVerts;
+	for (int vertexIndex = 0; vertexIndex < (int)vertexes.size(); vertexIndex++)
+	{
+		allVerts.push_back(vertexes[vertexIndex]);
+	}
+
+	std::vector<Vertex_PCUTBN> hsrVerts;
+	for (int vertexIndex = 0; vertexIndex < (int)allVerts.size(); vertexIndex++)
+	{
+		Vertex_PCUTBN const& vertex = allVerts[vertexIndex];
+		bool isHiddenSide = (AreFloatsMostlyEqual(vertex.m_position.x, 0.5f, HSR_EQUALITY_TOLERANCE) && vertex.m_normal == Vec3::EAST) ||
+			(AreFloatsMostlyEqual(vertex.m_position.x, -0.5f, HSR_EQUALITY_TOLERANCE) && vertex.m_normal == Vec3::WEST) ||
+			(AreFloatsMostlyEqual(vertex.m_position.y, 0.5f, HSR_EQUALITY_TOLERANCE) && vertex.m_normal == Vec3::NORTH) ||
+			(AreFloatsMostlyEqual(vertex.m_position.y, -0.5f, HSR_EQUALITY_TOLERANCE) && vertex.m_normal == Vec3::SOUTH);
+		if (block.IsBridge() || vertex.m_position.z > 0.2f || !isHiddenSide)
+		{
+			hsrVerts.push_back(vertex);
+		}
+	}
+
+	TransformVertexArray3D(hsrVerts, Mat44::CreateTranslation3D(position));
+
+	for (int vertexIndex = 0; vertexIndex < (int)hsrVerts.size(); vertexIndex++)
+	{
+		verts.push_back(hsrVerts[vertexIndex]);
+	}
+}
+
+// Tiles the source map's blocks out to the requested size, so the block mix stays that of a real level
+static void TileBenchmarkBlocks(Map const* sourceMap, int size, Grid<Block>& out_blocks)
+{
+	out_blocks = Grid<Block>(IntVec2(size, size));
+	for (int blockY = 0; blockY < size; blockY++)
+	{
+		for (int blockX = 0; blockX < size; blockX++)
+		{
+			IntVec2 sourceCoords = IntVec2(blockX % sourceMap->m_dimensions.x, blockY % sourceMap->m_dimensions.y);
+			out_blocks.Get(IntVec2(blockX, blockY)) = sourceMap->m_blocks.Get(sourceCoords);
+		}
+	}
+}
+
+// Per-query search the closest path block lookup replaced, with a visited set so it stays bounded; the original search had none and could exhaust memory far from the path
+// It finishes the distance it first finds a path block at and breaks ties the way the lookup does, with the lowest row, then the lowest column
+static int GetClosestPathBlockIndexBFS(Grid<Block> const& blocks, IntVec2 const& blockCoords)
+{
+	std::vector<bool> isVisited(blocks.GetStorageSize(), false);
+	std::vector<int> blockQueue;
+	std::vector<int> blockDistances;
+	int startBlockIndex = blocks.GetIndex(blockCoords);
+	isVisited[startBlockIndex] = true;
+	blockQueue.push_back(startBlockIndex);
+	blockDistances.push_back(0);
+	int closestPathBlockIndex = -1;
+	int closestPathDistance = -1;
+	for (int queueIndex = 0; queueIndex < (int)blockQueue.size(); queueIndex++)
+	{
+		int blockIndex = blockQueue[queueIndex];
+		int blockDistance = blockDistances[queueIndex];
+		if (closestPathDistance != -1 && blockDistance > closestPathDistance)
+		{
+			break;
+		}
+		if (blocks[blockIndex].IsEnemyTraversable())
+		{
+			if (closestPathBlockIndex == -1 || blockIndex < closestPathBlockIndex)
+			{
+				closestPathBlockIndex = blockIndex;
+				closestPathDistance = blockDistance;
+			}
+			continue;
+		}
+
+		IntVec2 coords = blocks.GetCoords(blockIndex);
+		IntVec2 const neighborCoords[4] = { coords + IntVec2::WEST, coords + IntVec2::NORTH, coords + IntVec2::SOUTH, coords + IntVec2::EAST };
+		for (int neighborIndex = 0; neighborIndex < 4; neighborIndex++)
+		{
+			if (!blocks.IsInBounds(neighborCoords[neighborIndex]))
+			{
+				continue;
+			}
+
+			int neighborBlockIndex = blocks.GetIndex(neighborCoords[neighborIndex]);
+			if (!isVisited[neighborBlockIndex])
+			{
+				isVisited[neighborBlockIndex] = true;
+				blockQueue.push_back(neighborBlockIndex);
+				blockDistances.push_back(blockDistance + 1);
+			}
+		}
+	}
+
+	return closestPathBlockIndex;
+}
+
+// The heat map BFS as it was before the padded grid: flat row-major blocks, a queue of coordinates and a bounds check on every neighbor
+static void ComputeHeatMapLegacy(std::vector<Block> const& blocks, IntVec2 const& dimensions, std::vector<float>& out_heatValues)
+{
+	constexpr float HEATMAP_MAX_COST = 99999.f;
+	int numBlocks = dimensions.x * dimensions.y;
+	out_heatValues.assign(numBlocks, HEATMAP_MAX_COST);
+	std::queue<IntVec2> nextBlocks;
+	for (int blockIndex = 0; blockIndex < numBlocks; blockIndex++)
+	{
+		if (blocks[blockIndex].IsEndBlock())
+		{
+			out_heatValues[blockIndex] = 0.f;
+			nextBlocks.push(IntVec2(blockIndex % dimensions.x, blockIndex / dimensions.x));
+		}
+	}
+
+	IntVec2 const neighborDirections[] = { IntVec2::SOUTH, IntVec2::NORTH, IntVec2::EAST, IntVec2::WEST };
+	while (!nextBlocks.empty())
+	{
+		IntVec2 currentBlockCoords = nextBlocks.front();
+		int currentBlockIndex = currentBlockCoords.x + dimensions.x * currentBlockCoords.y;
+		nextBlocks.pop();
+
+		for (int directionIndex = 0; directionIndex < 4; directionIndex++)
+		{
+			IntVec2 neighborCoords = currentBlockCoords + neighborDirections[directionIndex];
+			if (neighborCoords.x < 0 || neighborCoords.y < 0 || neighborCoords.x >= dimensions.x || neighborCoords.y >= dimensions.y)
+			{
+				continue;
+			}
+
+			int neighborIndex = neighborCoords.x + dimensions.x * neighborCoords.y;
+			if (out_heatValues[neighborIndex] > out_heatValues[currentBlockIndex] + 1.f && blocks[neighborIndex].IsEnemyTraversable())
+			{
+				out_heatValues[neighborIndex] = out_heatValues[currentBlockIndex] + 1.f;
+				nextBlocks.push(neighborCoords);
+			}
+		}
+	}
+}
+
+// Map::ComputeHeatMap for a grid in Morton order, so the storage orders can be compared on the same flood fill
+static void ComputeHeatMapMorton(Grid<Block, GridOrder::MORTON> const& blocks, Grid<float, GridOrder::MORTON>& out_heatMap)
+{
+	constexpr float HEATMAP_MAX_COST = 99999.f;
+	IntVec2 dimensions = blocks.GetDimensions();
+	out_heatMap = Grid<float, GridOrder::MORTON>(dimensions, HEATMAP_MAX_COST, -1.f);
+
+	std::vector<int> blockQueue;
+	blockQueue.reserve(dimensions.x * dimensions.y);
+	for (int blockY = 0; blockY < dimensions.y; blockY++)
+	{
+		for (int blockX = 0; blockX < dimensions.x; blockX++)
+		{
+			int blockIndex = blocks.GetIndex(blockX, blockY);
+			if (blocks[blockIndex].IsEndBlock())
+			{
+				out_heatMap[blockIndex] = 0.f;
+				blockQueue.push_back(blockIndex);
+			}
+		}
+	}
+
+	FloodFillGrid(blocks, blockQueue, [&](int fromIndex, int toIndex)
+	{
+		float nextHeatValue = out_heatMap[fromIndex] + 1.f;
+		if (out_heatMap[toIndex] > nextHeatValue && blocks[toIndex].IsEnemyTraversable())
+		{
+			out_heatMap[toIndex] = nextHeatValue;
+			return true;
+		}
+		return false;
+	});
+}
+
+// Per-cell block state laid out the way Block stored it before type IDs, with roles found by comparing definition names
+struct BenchmarkLegacyBlock
+{
+public:
+	BlockDefinition m_definition;
+	Map* m_map = nullptr;
+	Tower* m_tower = nullptr;
+};
+
+struct BenchmarkBlockRoleCounts
+{
+public:
+	int m_numStartBlocks = 0;
+	int m_numEndBlocks = 0;
+	int m_numTreeBlocks = 0;
+	int m_numCrystalBlocks = 0;
+	int m_numTraversableBlocks = 0;
+	int m_numBuildableBlocks = 0;
+};
+
+static void CountBlockRolesLegacy(std::vector<BenchmarkLegacyBlock> const& blocks, BenchmarkBlockRoleCounts& out_counts)
+{
+	out_counts = BenchmarkBlockRoleCounts();
+	for (int blockIndex = 0; blockIndex < (int)blocks.size(); blockIndex++)
+	{
+		BlockDefinition const& blockDef = blocks[blockIndex].m_definition;
+		out_counts.m_numStartBlocks += (!strcmp(blockDef.m_name.c_str(), "StartLR") || !strcmp(blockDef.m_name.c_str(), "StartUD")) ? 1 : 0;
+		out_counts.m_numEndBlocks += (!strcmp(blockDef.m_name.c_str(), "EndLR") || !strcmp(blockDef.m_name.c_str(), "EndUD")) ? 1 : 0;
+		out_counts.m_numTreeBlocks += blockDef.m_name.find("Tree") != std::string::npos ? 1 : 0;
+		out_counts.m_numCrystalBlocks += !strcmp(blockDef.m_name.c_str(), "Crystal") ? 1 : 0;
+		out_counts.m_numTraversableBlocks += blockDef.m_enemyTraversable ? 1 : 0;
+		out_counts.m_numBuildableBlocks += (blockDef.m_canPlaceTower && !blocks[blockIndex].m_tower) ? 1 : 0;
+	}
+}
+
+static void CountBlockRoles(Grid<Block> const& blocks, BenchmarkBlockRoleCounts& out_counts)
+{
+	out_counts = BenchmarkBlockRoleCounts();
+	IntVec2 dimensions = blocks.GetDimensions();
+	for (int blockY = 0; blockY < dimensions.y; blockY++)
+	{
+		for (int blockX = 0; blockX < dimensions.x; blockX++)
+		{
+			Block const& block = blocks[blocks.GetIndex(blockX, blockY)];
+			out_counts.m_numStartBlocks += block.IsStartBlock() ? 1 : 0;
+			out_counts.m_numEndBlocks += block.IsEndBlock() ? 1 : 0;
+			out_counts.m_numTreeBlocks += block.IsTree() ? 1 : 0;
+			out_counts.m_numCrystalBlocks += block.IsCrystal() ? 1 : 0;
+			out_counts.m_numTraversableBlocks += block.IsEnemyTraversable() ? 1 : 0;
+			out_counts.m_numBuildableBlocks += block.CanPlaceTower() ? 1 : 0;
+		}
+	}
+}
+
+// Map image color resolution as Block's constructor did it before the palette: a walk over every definition with a redundant lookup and a copy of the match
+static BlockDefinition GetBlockDefinitionForColorLegacy(Rgba8 const& mapImageColor)
+{
+	for (auto blockDefMapIter = BlockDefinition::s_blockDefs.begin(); blockDefMapIter != BlockDefinition::s_blockDefs.end(); ++blockDefMapIter)
+	{
+		BlockDefinition& blockDef = BlockDefinition::s_blockDefs[blockDefMapIter->first];
+		if (blockDef.m_mapImageColor.r == mapImageColor.r && blockDef.m_mapImageColor.g == mapImageColor.g && blockDef.m_mapImageColor.b == mapImageColor.b)
+		{
+			return blockDef;
+		}
+	}
+
+	return BlockDefinition();
+}
+
+static float GetDegreesFromCosine(float cosine)
+{
+	return acosf(GetClamped(cosine, -1.f, 1.f)) * 180.f / 3.14159265f;
+}
+
+void Benchmarks::RegisterConsoleCommands()
+{
+	SubscribeEventCallbackFunction("BenchmarkTargeting", Event_BenchmarkTargeting, "Compares spatial grid and linear tower targeting queries");
+	SubscribeEventCallbackFunction("BenchmarkEnemyMovement", Event_BenchmarkEnemyMovement, "Compares the batched enemy movement kernel against per-enemy movement");
+	SubscribeEventCallbackFunction("BenchmarkStatusEffectSoak", Event_BenchmarkStatusEffectSoak, "Runs status effect towers against a continuous stream of enemies and reports process memory over time");
+	SubscribeEventCallbackFunction("BenchmarkParticleBatching", Event_BenchmarkParticleBatching, "Builds particle batches for every particle texture and blend mode and reports the resulting draw calls");
+	SubscribeEventCallbackFunction("BenchmarkParticleUpdate", Event_BenchmarkParticleUpdate, "Compares the particle pool update kernel against per-object particle updates");
+	SubscribeEventCallbackFunction("BenchmarkJobScaling", Event_BenchmarkJobScaling, "Times the fixed update with 1 to 16 job threads and checks that every run ends in the same state");
+	SubscribeEventCallbackFunction("BenchmarkMapMeshing", Event_BenchmarkMapMeshing, "Compares serial per-block map meshing against neighbor-aware parallel chunk meshing on a tiled map");
+	SubscribeEventCallbackFunction("BenchmarkMapMeshIndexing", Event_BenchmarkMapMeshIndexing, "Welds and cache optimizes every map chunk, checks the triangles are unchanged and compares memory and vertex cache misses");
+	SubscribeEventCallbackFunction("CheckPackedMapVertexes", Event_CheckPackedMapVertexes, "Packs and unpacks every welded map chunk vertex and checks the round trip errors and memory saved");
+	SubscribeEventCallbackFunction("BenchmarkClosestPathBlock", Event_BenchmarkClosestPathBlock, "Compares per-query closest path block searches against the precomputed lookup on a synthetic map with one winding path");
+	SubscribeEventCallbackFunction("BenchmarkBlockRoles", Event_BenchmarkBlockRoles, "Compares block grid memory and role checks of full definition copies against one byte block type IDs");
+	SubscribeEventCallbackFunction("BenchmarkMapImagePalette", Event_BenchmarkMapImagePalette, "Compares resolving map image colors by searching every block definition against the hashed palette");
+	SubscribeEventCallbackFunction("BenchmarkGridBFS", Event_BenchmarkGridBFS, "Compares heat map BFS throughput of the bounds checked flat array against the padded grid in row-major and Morton order");
+	SubscribeEventCallbackFunction("BenchmarkMapLoad", Event_BenchmarkMapLoad, "Compares loading a map from its image against loading it from the cooked map cache");
+	SubscribeEventCallbackFunction("CheckRenderBudget", Event_CheckRenderBudget, "Records map frames on a null render backend and checks draw call and buffer creation budgets");
+}
+
+bool Benchmarks::Event_BenchmarkTargeting(EventArgs& args)
+{
+	bool isHelp = args.GetValue("help", false);
+	if (isHelp)
+	{
+		g_console->AddLine("Compares spatial grid and linear tower targeting queries", false);
+		g_console->AddLine("Parameters", false);
+		g_console->AddLine(Stringf("\t\t%-20s: [int > 0] number of towers querying for a target (default 500)", "towers"), false);
+		g_console->AddLine(Stringf("\t\t%-20s: [int > 0] number of enemies spread over the path (default 20000)", "enemies"), false);
+		g_console->AddLine(Stringf("\t\t%-20s: [int > 0] number of simulated ticks (default 10)", "ticks"), false);
+		g_console->AddLine(Stringf("\t\t%-20s: [string] map to benchmark on (default Level1)", "map"), false);
+		return true;
+	}
+
+	int numTowers = args.GetValue("towers", 500);
+	int numEnemies = args.GetValue("enemies", 20000);
+	int numTicks = args.GetValue("ticks", 10);
+	std::string mapName = args.GetValue("map", "Level1");
+	float towerRange = 2.5f;
+
+	Map* map = CreateBenchmarkMap(mapName);
+	if (!map)
+	{
+		return false;
+	}
+
+	std::vector<IntVec2> traversableBlocks;
+	for (int blockIndex = 0; blockIndex < map->m_dimensions.x * map->m_dimensions.y; blockIndex++)
+	{
+		IntVec2 blockCoords = IntVec2(blockIndex % map->m_dimensions.x, blockIndex / map->m_dimensions.x);
+		if (map->m_blocks.Get(blockCoords).IsEnemyTraversable())
+		{
+			traversableBlocks.push_back(blockCoords);
+		}
+	}
+
+	std::string const& enemyName = EnemyDefinition::s_enemyDefs.begin()->first;
+	for (int enemyIndex = 0; enemyIndex < numEnemies; enemyIndex++)
+	{
+		Enemy* enemy = map->SpawnEnemy(enemyName, map->m_startBlocks[0].GetAsVec2().ToVec3());
+		enemy->SetPosition(GetRandomTraversablePosition(traversableBlocks));
+		map->m_enemyGrid.UpdateEnemy(enemy);
+	}
+
+	std::vector<Vec3> towerPositions;
+	towerPositions.reserve(numTowers);
+	for (int towerIndex = 0; towerIndex < numTowers; towerIndex++)
+	{
+		towerPositions.push_back(Vec3(g_RNG->RollRandomFloatInRange(0.f, (float)map->m_dimensions.x), g_RNG->RollRandomFloatInRange(0.f, (float)map->m_dimensions.y), 0.f));
+	}
+
+	double gridUpdateSeconds = 0.0;
+	double gridQuerySeconds = 0.0;
+	double linearQuerySeconds = 0.0;
+	int numMismatches = 0;
+	int numTargetsFound = 0;
+
+	for (int tickIndex = 0; tickIndex < numTicks; tickIndex++)
+	{
+		// Nudge every enemy along a random direction so some of them cross into neighboring cells each tick
+		for (int enemyIndex = 0; enemyIndex < map->m_enemies.GetCount(); enemyIndex++)
+		{
+			Enemy* enemy = map->m_enemies[enemyIndex];
+			float directionDegrees = g_RNG->RollRandomFloatInRange(0.f, 360.f);
+			Vec2 offset = Vec2(CosDegrees(directionDegrees), SinDegrees(directionDegrees)) * enemy->GetSpeed() * Map::FIXED_PHYSICS_TIMESTEP;
+			Vec3 enemyPosition = enemy->GetPosition();
+			enemyPosition.x = GetClamped(enemyPosition.x + offset.x, 0.f, (float)map->m_dimensions.x - 0.001f);
+			enemyPosition.y = GetClamped(enemyPosition.y + offset.y, 0.f, (float)map->m_dimensions.y - 0.001f);
+			enemy->SetPosition(enemyPosition);
+		}
+
+		double updateStartTime = GetCurrentTimeSeconds();
+		for (int enemyIndex = 0; enemyIndex < map->m_enemies.GetCount(); enemyIndex++)
+		{
+			map->m_enemyGrid.UpdateEnemy(map->m_enemies[enemyIndex]);
+		}
+		gridUpdateSeconds += GetCurrentTimeSeconds() - updateStartTime;
+
+		std::vector<Enemy*> gridTargets(numTowers, nullptr);
+		double gridStartTime = GetCurrentTimeSeconds();
+		for (int towerIndex = 0; towerIndex < numTowers; towerIndex++)
+		{
+			gridTargets[towerIndex] = map->GetTargetWithinRange(towerPositions[towerIndex], towerRange);
+		}
+		gridQuerySeconds += GetCurrentTimeSeconds() - gridStartTime;
+
+		std::vector<Enemy*> linearTargets(numTowers, nullptr);
+		double linearStartTime = GetCurrentTimeSeconds();
+		for (int towerIndex = 0; towerIndex < numTowers; towerIndex++)
+		{
+			linearTargets[towerIndex] = GetTargetWithinRangeLinear(map, towerPositions[towerIndex], towerRange);
+		}
+		linearQuerySeconds += GetCurrentTimeSeconds() - linearStartTime;
+
+		for (int towerIndex = 0; towerIndex < numTowers; towerIndex++)
+		{
+			if (gridTargets[towerIndex] != linearTargets[towerIndex])
+			{
+				numMismatches++;
+			}
+			if (gridTargets[towerIndex])
+			{
+				numTargetsFound++;
+			}
+		}
+	}
+
+	delete map;
+
+	double gridMsPerTick = (gridUpdateSeconds + gridQuerySeconds) * 1000.0 / (double)numTicks;
+	double linearMsPerTick = linearQuerySeconds * 1000.0 / (double)numTicks;
+	g_console->AddLine(Rgba8::GREEN, Stringf("Targeting: %d towers, %d enemies, %d ticks on %s", numTowers, numEnemies, numTicks, mapName.c_str()));
+	g_console->AddLine(Rgba8::WHITE, Stringf("Grid: %.3fms/tick (update %.3fms, query %.3fms)", gridMsPerTick, gridUpdateSeconds * 1000.0 / (double)numTicks, gridQuerySeconds * 1000.0 / (double)numTicks));
+	g_console->AddLine(Rgba8::WHITE, Stringf("Linear: %.3fms/tick, speedup %.1fx", linearMsPerTick, gridMsPerTick > 0.0 ? linearMsPerTick / gridMsPerTick : 0.0));
+	g_console->AddLine(numMismatches == 0 ? Rgba8::WHITE : Rgba8::RED, Stringf("Targets found: %d, mismatches against linear scan: %d", numTargetsFound, numMismatches));
+
+	return true;
+}
+
+bool Benchmarks::Event_BenchmarkEnemyMovement(EventArgs& args)
+{
+	bool isHelp = args.GetValue("help", false);
+	if (isHelp)
+	{
+		g_console->AddLine("Compares the batched enemy movement kernel against per-enemy movement", false);
+		g_console->AddLine("Parameters", false);
+		g_console->AddLine(Stringf("\t\t%-20s: [int > 0] number of enemies (default 100000)", "enemies"), false);
+		g_console->AddLine(Stringf("\t\t%-20s: [int > 0] number of simulated ticks (default 100)", "ticks"), false);
+		return true;
+	}
+
+	int numEnemies = args.GetValue("enemies", 100000);
+	int numTicks = args.GetValue("ticks", 100);
+	float deltaSeconds = Map::FIXED_PHYSICS_TIMESTEP;
+
+	EnemySimData simData;
+	std::vector<BenchmarkEnemyState> scalarEnemies(numEnemies);
+	for (int enemyIndex = 0; enemyIndex < numEnemies; enemyIndex++)
+	{
+		Vec3 position = Vec3(g_RNG->RollRandomFloatInRange(0.f, 32.f), g_RNG->RollRandomFloatInRange(0.f, 32.f), 0.f);
+		Vec2 goal = position.GetXY() + Vec2(g_RNG->RollRandomFloatInRange(-50.f, 50.f), g_RNG->RollRandomFloatInRange(-50.f, 50.f));
+		float speed = g_RNG->RollRandomFloatInRange(0.5f, 2.f);
+		float wavePhaseOffset = g_RNG->RollRandomFloatZeroToOne();
+
+		int simIndex = simData.AddEnemy(nullptr, position, 0.f, speed, 90.f, 100.f, 5.f * (1.f + wavePhaseOffset));
+		simData.SetGoal(simIndex, goal);
+
+		BenchmarkEnemyState& scalarEnemy = scalarEnemies[enemyIndex];
+		scalarEnemy.m_position = position;
+		scalarEnemy.m_currentGoal = goal;
+		scalarEnemy.m_speed = speed;
+		scalarEnemy.m_turnSpeed = 90.f;
+		scalarEnemy.m_health = 100.f;
+		scalarEnemy.m_wavePhaseOffset = wavePhaseOffset;
+	}
+
+	double kernelStartTime = GetCurrentTimeSeconds();
+	for (int tickIndex = 0; tickIndex < numTicks; tickIndex++)
+	{
+		simData.UpdateMovement(deltaSeconds);
+	}
+	double kernelSeconds = GetCurrentTimeSeconds() - kernelStartTime;
+
+	double scalarStartTime = GetCurrentTimeSeconds();
+	for (int tickIndex = 0; tickIndex < numTicks; tickIndex++)
+	{
+		for (int enemyIndex = 0; enemyIndex < numEnemies; enemyIndex++)
+		{
+			MoveEnemyScalar(scalarEnemies[enemyIndex], deltaSeconds);
+		}
+	}
+	double scalarSeconds = GetCurrentTimeSeconds() - scalarStartTime;
+
+	float maxPositionError = 0.f;
+	for (int enemyIndex = 0; enemyIndex < numEnemies; enemyIndex++)
+	{
+		float positionError = GetDistance3D(simData.GetPosition(enemyIndex), scalarEnemies[enemyIndex].m_position);
+		maxPositionError = positionError > maxPositionError ? positionError : maxPositionError;
+	}
+
+	double kernelMsPerTick = kernelSeconds * 1000.0 / (double)numTicks;
+	double scalarMsPerTick = scalarSeconds * 1000.0 / (double)numTicks;
+	g_console->AddLine(Rgba8::GREEN, Stringf("Enemy movement: %d enemies, %d ticks", numEnemies, numTicks));
+	g_console->AddLine(Rgba8::WHITE, Stringf("Kernel: %.3fms/tick, per-enemy: %.3fms/tick, speedup %.1fx", kernelMsPerTick, scalarMsPerTick, kernelMsPerTick > 0.0 ? scalarMsPerTick / kernelMsPerTick : 0.0));
+	g_console->AddLine(Rgba8::WHITE, Stringf("Max position difference: %.5f", maxPositionError));
+
+	return true;
+}
+
+bool Benchmarks::Event_BenchmarkStatusEffectSoak(EventArgs& args)
+{
+	bool isHelp = args.GetValue("help", false);
+	if (isHelp)
+	{
+		g_console->AddLine("Runs status effect towers against a continuous stream of enemies and reports process memory over time", false);
+		g_console->AddLine("Parameters", false);
+		g_console->AddLine(Stringf("\t\t%-20s: [int > 0] simulated minutes to run (default 30)", "minutes"), false);
+		g_console->AddLine(Stringf("\t\t%-20s: [float > 0] simulated seconds between enemy spawns (default 0.25)", "spawnInterval"), false);
+		g_console->AddLine(Stringf("\t\t%-20s: [string] enemy to spawn (default first enemy definition)", "enemy"), false);
+		return true;
+	}
+
+	int numMinutes = args.GetValue("minutes", 30);
+	float spawnIntervalSeconds = args.GetValue("spawnInterval", 0.25f);
+	std::string enemyName = args.GetValue("enemy", EnemyDefinition::s_enemyDefs.begin()->first);
+
+	Map* map = CreateBenchmarkMap("Level1");
+	if (!map)
+	{
+		return false;
+	}
+
+	map->m_money = 1000000;
+	map->m_remainingLives = 1000000;
+
+	// Grass blocks along the Level1 path, so every tower keeps hitting enemies as they walk past
+	struct SoakTowerPlacement
+	{
+		char const* m_towerName;
+		IntVec2 m_blockCoords;
+	};
+	SoakTowerPlacement const towerPlacements[] =
+	{
+		{ "Burn",		IntVec2(14, 16) },
+		{ "Freeze",		IntVec2(15, 19) },
+		{ "Poison",		IntVec2(17, 12) },
+		{ "Burn",		IntVec2(23, 19) },
+		{ "Freeze",		IntVec2(15, 16) },
+		{ "Poison",		IntVec2(14, 19) },
+	};
+	int numTowersPlaced = 0;
+	for (int placementIndex = 0; placementIndex < (int)(sizeof(towerPlacements) / sizeof(towerPlacements[0])); placementIndex++)
+	{
+		if (map->PlaceTowerAtBlock(towerPlacements[placementIndex].m_towerName, towerPlacements[placementIndex].m_blockCoords))
+		{
+			numTowersPlaced++;
+		}
+	}
+
+	Vec3 spawnPosition = map->m_startBlocks[0].GetAsVec2().ToVec3() + Vec3::EAST * 0.5f + Vec3::NORTH * 0.5f;
+	int ticksPerMinute = RoundDownToInt(60.f / Map::FIXED_PHYSICS_TIMESTEP);
+	int ticksPerSpawn = RoundDownToInt(spawnIntervalSeconds / Map::FIXED_PHYSICS_TIMESTEP);
+	ticksPerSpawn = ticksPerSpawn > 0 ? ticksPerSpawn : 1;
+
+	size_t startMemoryBytes = GetProcessMemoryUsageBytes();
+	size_t maxMemoryBytes = startMemoryBytes;
+	int numEnemiesSpawned = 0;
+	int maxEnemiesAlive = 0;
+	int tickIndex = 0;
+	double startTime = GetCurrentTimeSeconds();
+
+	for (int minuteIndex = 0; minuteIndex < numMinutes; minuteIndex++)
+	{
+		for (int minuteTickIndex = 0; minuteTickIndex < ticksPerMinute; minuteTickIndex++, tickIndex++)
+		{
+			if (tickIndex % ticksPerSpawn == 0)
+			{
+				map->SpawnEnemy(enemyName, spawnPosition);
+				numEnemiesSpawned++;
+			}
+
+			map->FixedUpdate(Map::FIXED_PHYSICS_TIMESTEP);
+			map->DeleteDestroyedEnemies();
+			maxEnemiesAlive = map->m_enemies.GetCount() > maxEnemiesAlive ? map->m_enemies.GetCount() : maxEnemiesAlive;
+		}
+
+		int numActiveStatusEffects = 0;
+		for (int enemyIndex = 0; enemyIndex < map->m_enemies.GetCount(); enemyIndex++)
+		{
+			EnemyStatusEffects const& statusEffects = map->m_enemies[enemyIndex]->m_statusEffects;
+			for (int typeIndex = 0; typeIndex < (int)StatusEffectType::COUNT; typeIndex++)
+			{
+				numActiveStatusEffects += statusEffects.IsActive((StatusEffectType)typeIndex) ? 1 : 0;
+			}
+		}
+
+		size_t memoryBytes = GetProcessMemoryUsageBytes();
+		maxMemoryBytes = memoryBytes > maxMemoryBytes ? memoryBytes : maxMemoryBytes;
+		g_console->AddLine(Rgba8::WHITE, Stringf("Minute %d: %.2fMB, %d enemies alive, %d active status effects", minuteIndex + 1, (double)memoryBytes / (1024.0 * 1024.0), map->m_enemies.GetCount(), numActiveStatusEffects));
+	}
+
+	double elapsedSeconds = GetCurrentTimeSeconds() - startTime;
+	size_t endMemoryBytes = GetProcessMemoryUsageBytes();
+	delete map;
+
+	double startMegabytes = (double)startMemoryBytes / (1024.0 * 1024.0);
+	double endMegabytes = (double)endMemoryBytes / (1024.0 * 1024.0);
+	double maxMegabytes = (double)maxMemoryBytes / (1024.0 * 1024.0);
+	g_console->AddLine(Rgba8::GREEN, Stringf("Status effect soak: %d simulated minutes, %d towers, %d enemies spawned, max %d alive, ran in %.2fs", numMinutes, numTowersPlaced, numEnemiesSpawned, maxEnemiesAlive, elapsedSeconds));
+	g_console->AddLine(endMemoryBytes > startMemoryBytes + 1024 * 1024 ? Rgba8::RED : Rgba8::WHITE, Stringf("Private memory: start %.2fMB, end %.2fMB, max %.2fMB, growth %.2fMB", startMegabytes, endMegabytes, maxMegabytes, endMegabytes - startMegabytes));
+
+	return true;
+}
+
+bool Benchmarks::Event_BenchmarkParticleBatching(EventArgs& args)
+{
+	bool isHelp = args.GetValue("help", false);
+	if (isHelp)
+	{
+		g_console->AddLine("Builds particle batches for every particle texture and blend mode and reports the resulting draw calls", false);
+		g_console->AddLine("Parameters", false);
+		g_console->AddLine(Stringf("\t\t%-20s: [int > 0] number of live particles (default 10000)", "particles"), false);
+		g_console->AddLine(Stringf("\t\t%-20s: [int > 0] number of frames to build (default 100)", "frames"), false);
+		return true;
+	}
+
+	int numParticles = args.GetValue("particles", 10000);
+	int numFrames = args.GetValue("frames", 100);
+
+	std::vector<Texture*> textures;
+	for (auto particleTexturesIter = ParticleSystem::s_particleTextures.begin(); particleTexturesIter != ParticleSystem::s_particleTextures.end(); ++particleTexturesIter)
+	{
+		textures.push_back(particleTexturesIter->second);
+	}
+	if (textures.empty())
+	{
+		textures.push_back(nullptr);
+	}
+
+	ParticleSystem particleSystem(numParticles);
+	for (int particleIndex = 0; particleIndex < numParticles; particleIndex++)
+	{
+		Vec3 position = Vec3(g_RNG->RollRandomFloatInRange(0.f, 32.f), g_RNG->RollRandomFloatInRange(0.f, 32.f), g_RNG->RollRandomFloatZeroToOne());
+		Texture* texture = textures[g_RNG->RollRandomIntLessThan((int)textures.size())];
+		BlendMode blendMode = g_RNG->RollRandomIntLessThan(2) == 0 ? BlendMode::ALPHA : BlendMode::ADDITIVE;
+		particleSystem.Spawn(position, Vec3::SKYWARD, g_RNG->RollRandomFloatInRange(0.f, 360.f), 90.f, 0.5f, 1000.f, texture, Rgba8::WHITE, blendMode);
+	}
+
+	Mat44 cameraModelMatrix = g_app->m_game->m_worldCamera.GetModelMatrix();
+	double buildStartTime = GetCurrentTimeSeconds();
+	for (int frameIndex = 0; frameIndex < numFrames; frameIndex++)
+	{
+		particleSystem.Update(Map::FIXED_PHYSICS_TIMESTEP);
+		particleSystem.BuildBatches(cameraModelMatrix);
+	}
+	double buildSeconds = GetCurrentTimeSeconds() - buildStartTime;
+
+	int numBatchedDrawCalls = 0;
+	int numBatchedParticles = 0;
+	for (int batchIndex = 0; batchIndex < (int)particleSystem.m_batches.size(); batchIndex++)
+	{
+		int numBatchVerts = (int)particleSystem.m_batches[batchIndex].m_verts.size();
+		numBatchedDrawCalls += numBatchVerts > 0 ? 1 : 0;
+		numBatchedParticles += numBatchVerts / 6;
+	}
+
+	g_console->AddLine(Rgba8::GREEN, Stringf("Particle batching: %d particles, %d textures, %d frames", numParticles, (int)textures.size(), numFrames));
+	g_console->AddLine(Rgba8::WHITE, Stringf("Update and build: %.3fms/frame", buildSeconds * 1000.0 / (double)numFrames));
+	g_console->AddLine(Rgba8::WHITE, Stringf("Draw calls per frame: %d batched, %d with one draw per particle", numBatchedDrawCalls, particleSystem.GetNumLiveParticles()));
+	g_console->AddLine(numBatchedParticles == particleSystem.GetNumLiveParticles() ? Rgba8::WHITE : Rgba8::RED, Stringf("Particles in batches: %d", numBatchedParticles));
+
+	return true;
+}
+
+bool Benchmarks::Event_BenchmarkParticleUpdate(EventArgs& args)
+{
+	bool isHelp = args.GetValue("help", false);
+	if (isHelp)
+	{
+		g_console->AddLine("Compares the particle pool update kernel against per-object particle updates", false);
+		g_console->AddLine("Parameters", false);
+		g_console->AddLine(Stringf("\t\t%-20s: [int > 0] number of particles (default 100000)", "particles"), false);
+		g_console->AddLine(Stringf("\t\t%-20s: [int > 0] number of simulated ticks (default 100)", "ticks"), false);
+		return true;
+	}
+
+	int numParticles = args.GetValue("particles", 100000);
+	int numTicks = args.GetValue("ticks", 100);
+	float deltaSeconds = Map::FIXED_PHYSICS_TIMESTEP;
+	float simulatedSeconds = deltaSeconds * (float)numTicks;
+
+	// Lifetimes straddle the simulated duration so about half of the particles expire and get compacted along the way
+	ParticleSystem particleSystem(numParticles);
+	std::vector<BenchmarkParticleState*> scalarParticles;
+	scalarParticles.reserve(numParticles);
+	for (int particleIndex = 0; particleIndex < numParticles; particleIndex++)
+	{
+		Vec3 position = Vec3(g_RNG->RollRandomFloatInRange(0.f, 32.f), g_RNG->RollRandomFloatInRange(0.f, 32.f), 0.f);
+		Vec3 velocity = Vec3(g_RNG->RollRandomFloatInRange(-1.f, 1.f), g_RNG->RollRandomFloatInRange(-1.f, 1.f), g_RNG->RollRandomFloatInRange(0.f, 1.f));
+		float rotationSpeed = g_RNG->RollRandomFloatInRange(-180.f, 180.f);
+		float lifetime = g_RNG->RollRandomFloatInRange(simulatedSeconds * 0.5f, simulatedSeconds * 1.5f);
+
+		particleSystem.Spawn(position, velocity, 0.f, rotationSpeed, 0.5f, lifetime, nullptr, Rgba8::WHITE);
+
+		BenchmarkParticleState* scalarParticle = new BenchmarkParticleState();
+		scalarParticle->m_position = position;
+		scalarParticle->m_velocity = velocity;
+		scalarParticle->m_size = 0.5f;
+		scalarParticle->m_color = Rgba8::WHITE;
+		scalarParticle->m_lifetime = lifetime;
+		scalarParticle->m_rotationSpeed = rotationSpeed;
+		scalarParticles.push_back(scalarParticle);
+	}
+
+	double kernelStartTime = GetCurrentTimeSeconds();
+	for (int tickIndex = 0; tickIndex < numTicks; tickIndex++)
+	{
+		particleSystem.Update(deltaSeconds);
+	}
+	double kernelSeconds = GetCurrentTimeSeconds() - kernelStartTime;
+
+	// The reference only flags expired particles; erasing them from the middle of the list like the old map did would dominate the timing
+	double scalarStartTime = GetCurrentTimeSeconds();
+	for (int tickIndex = 0; tickIndex < numTicks; tickIndex++)
+	{
+		for (int particleIndex = 0; particleIndex < numParticles; particleIndex++)
+		{
+			if (!scalarParticles[particleIndex]->m_isDestroyed)
+			{
+				UpdateParticleScalar(*scalarParticles[particleIndex], deltaSeconds);
+			}
+		}
+	}
+	double scalarSeconds = GetCurrentTimeSeconds() - scalarStartTime;
+
+	int numScalarLiveParticles = 0;
+	for (int particleIndex = 0; particleIndex < numParticles; particleIndex++)
+	{
+		numScalarLiveParticles += scalarParticles[particleIndex]->m_isDestroyed ? 0 : 1;
+		delete scalarParticles[particleIndex];
+	}
+
+	double kernelMsPerTick = kernelSeconds * 1000.0 / (double)numTicks;
+	double scalarMsPerTick = scalarSeconds * 1000.0 / (double)numTicks;
+	g_console->AddLine(Rgba8::GREEN, Stringf("Particle update: %d particles, %d ticks", numParticles, numTicks));
+	g_console->AddLine(Rgba8::WHITE, Stringf("Pool kernel: %.3fms/tick, per-object: %.3fms/tick, speedup %.1fx", kernelMsPerTick, scalarMsPerTick, kernelMsPerTick > 0.0 ? scalarMsPerTick / kernelMsPerTick : 0.0));
+	g_console->AddLine(Rgba8::WHITE, Stringf("Live particles after update: pool %d, per-object %d", particleSystem.GetNumLiveParticles(), numScalarLiveParticles));
+
+	return true;
+}
+
+bool Benchmarks::Event_BenchmarkJobScaling(EventArgs& args)
+{
+	bool isHelp = args.GetValue("help", false);
+	if (isHelp)
+	{
+		g_console->AddLine("Times the fixed update with 1 to 16 job threads and checks that every run ends in the same state", false);
+		g_console->AddLine("Parameters", false);
+		g_console->AddLine(Stringf("\t\t%-20s: [int > 0] number of enemies spread over the path (default 20000)", "enemies"), false);
+		g_console->AddLine(Stringf("\t\t%-20s: [int > 0] number of simulated ticks (default 60)", "ticks"), false);
+		g_console->AddLine(Stringf("\t\t%-20s: [string] map to benchmark on (default Level1)", "map"), false);
+		return true;
+	}
+
+	int numEnemies = args.GetValue("enemies", 20000);
+	int numTicks = args.GetValue("ticks", 60);
+	std::string mapName = args.GetValue("map", "Level1");
+
+	Map* layoutMap = CreateBenchmarkMap(mapName);
+	if (!layoutMap)
+	{
+		return false;
+	}
+
+	// Every run starts from the same enemy positions so the end states can be compared
+	std::vector<IntVec2> traversableBlocks;
+	for (int blockIndex = 0; blockIndex < layoutMap->m_dimensions.x * layoutMap->m_dimensions.y; blockIndex++)
+	{
+		IntVec2 blockCoords = IntVec2(blockIndex % layoutMap->m_dimensions.x, blockIndex / layoutMap->m_dimensions.x);
+		if (layoutMap->m_blocks.Get(blockCoords).IsEnemyTraversable())
+		{
+			traversableBlocks.push_back(blockCoords);
+		}
+	}
+	std::vector<Vec3> enemyPositions;
+	enemyPositions.reserve(numEnemies);
+	for (int enemyIndex = 0; enemyIndex < numEnemies; enemyIndex++)
+	{
+		enemyPositions.push_back(GetRandomTraversablePosition(traversableBlocks));
+	}
+	delete layoutMap;
+
+	std::vector<std::string> towerNames;
+	for (auto towerDefIter = TowerDefinition::s_towerDefs.begin(); towerDefIter != TowerDefinition::s_towerDefs.end(); ++towerDefIter)
+	{
+		towerNames.push_back(towerDefIter->first);
+	}
+	std::string const& enemyName = EnemyDefinition::s_enemyDefs.begin()->first;
+
+	g_console->AddLine(Rgba8::GREEN, Stringf("Job scaling: %d enemies, %d ticks on %s", numEnemies, numTicks, mapName.c_str()));
+
+	int const threadCounts[] = { 1, 2, 4, 8, 16 };
+	double singleThreadMsPerTick = 0.0;
+	unsigned int singleThreadHash = 0;
+	for (int threadCountIndex = 0; threadCountIndex < (int)(sizeof(threadCounts) / sizeof(threadCounts[0])); threadCountIndex++)
+	{
+		int numThreads = threadCounts[threadCountIndex];
+		JobSystem jobSystem(numThreads);
+		Map* map = CreateBenchmarkMap(mapName);
+		map->m_jobSystem = &jobSystem;
+		map->m_money = 1000000;
+		map->m_remainingLives = 1000000;
+
+		// Fill every buildable block with towers, collapsing their random rolls to fixed values so the outcome does not depend on RNG state
+		int numTowersPlaced = 0;
+		for (int blockIndex = 0; blockIndex < map->m_dimensions.x * map->m_dimensions.y; blockIndex++)
+		{
+			IntVec2 blockCoords = IntVec2(blockIndex % map->m_dimensions.x, blockIndex / map->m_dimensions.x);
+			Tower* tower = map->PlaceTowerAtBlock(towerNames[blockIndex % (int)towerNames.size()], blockCoords);
+			if (!tower)
+			{
+				continue;
+			}
+
+			TowerDefinition& towerDef = tower->m_definition;
+			towerDef.m_damage = FloatRange(towerDef.m_damage.m_min, towerDef.m_damage.m_min);
+			towerDef.m_burnDamagePerSecond = FloatRange(towerDef.m_burnDamagePerSecond.m_min, towerDef.m_burnDamagePerSecond.m_min);
+			towerDef.m_poisonDamagePerSecond = FloatRange(towerDef.m_poisonDamagePerSecond.m_min, towerDef.m_poisonDamagePerSecond.m_min);
+			numTowersPlaced++;
+		}
+
+		for (int enemyIndex = 0; enemyIndex < numEnemies; enemyIndex++)
+		{
+			Enemy* enemy = map->SpawnEnemy(enemyName, enemyPositions[enemyIndex]);
+			map->m_enemyGrid.UpdateEnemy(enemy);
+		}
+
+		double startTime = GetCurrentTimeSeconds();
+		for (int tickIndex = 0; tickIndex < numTicks; tickIndex++)
+		{
+			map->FixedUpdate(Map::FIXED_PHYSICS_TIMESTEP);
+			map->DeleteDestroyedEnemies();
+		}
+		double msPerTick = (GetCurrentTimeSeconds() - startTime) * 1000.0 / (double)numTicks;
+
+		unsigned int stateHash = HashSimulationState(map);
+		delete map;
+
+		if (numThreads == 1)
+		{
+			singleThreadMsPerTick = msPerTick;
+			singleThreadHash = stateHash;
+		}
+
+		bool isIdentical = stateHash == singleThreadHash;
+		g_console->AddLine(isIdentical ? Rgba8::WHITE : Rgba8::RED, Stringf("%2d threads: %.3fms/tick, speedup %.2fx, %d towers, state hash %08x%s", numThreads, msPerTick, msPerTick > 0.0 ? singleThreadMsPerTick / msPerTick : 0.0, numTowersPlaced, stateHash, isIdentical ? "" : " (differs from 1 thread)"));
+	}
+
+	return true;
+}
+
+bool Benchmarks::Event_CheckRenderBudget(EventArgs& args)
+{
+	bool isHelp = args.GetValue("help", false);
+	if (isHelp)
+	{
+		g_console->AddLine("Records map frames on a null render backend and checks draw call and buffer creation budgets", false);
+		g_console->AddLine("Parameters", false);
+		g_console->AddLine(Stringf("\t\t%-20s: [int >= 0] number of towers placed on buildable blocks (default 100)", "towers"), false);
+		g_console->AddLine(Stringf("\t\t%-20s: [int >= 0] number of enemies spread over the path (default 1000)", "enemies"), false);
+		g_console->AddLine(Stringf("\t\t%-20s: [int >= 0] number of live particles (default 5000)", "particles"), false);
+		g_console->AddLine(Stringf("\t\t%-20s: [int > 1] number of recorded frames, the first one warms up buffers (default 10)", "frames"), false);
+		g_console->AddLine(Stringf("\t\t%-20s: [int > 0] most draw calls allowed in a steady state frame (default 64)", "maxDraws"), false);
+		g_console->AddLine(Stringf("\t\t%-20s: [string] map to render (default Level1)", "map"), false);
+		return true;
+	}
+
+	int numTowers = args.GetValue("towers", 100);
+	int numEnemies = args.GetValue("enemies", 1000);
+	int numParticles = args.GetValue("particles", 5000);
+	int numFrames = args.GetValue("frames", 10);
+	int maxDrawCalls = args.GetValue("maxDraws", 64);
+	std::string mapName = args.GetValue("map", "Level1");
+
+	// The first frame only warms up buffers, so a single frame would leave no steady state frame to check
+	if (numFrames < 2)
+	{
+		g_console->AddLine(Rgba8::RED, Stringf("Could not check render budget over %d frames, at least 2 are needed", numFrames));
+		return false;
+	}
+
+	Map* map = CreateBenchmarkMap(mapName);
+	if (!map)
+	{
+		return false;
+	}
+	map->m_money = 1000000;
+
+	// Everything from here on goes to the null backend, so no buffer is created on the GPU and nothing is drawn
+	// The map is headless and only gets the render resources it draws from, skipping its UI, audio and assets
+	RecordingRenderBackend recordingBackend(nullptr);
+	RenderBackend* previousBackend = g_renderBackend;
+	g_renderBackend = &recordingBackend;
+
+	std::vector<CookedMapChunk> cookedChunks;
+	std::vector<CookedMapChunkView> chunkViews;
+	MapMesh::CookChunks(map->m_blocks, map->m_jobSystem, g_gameConfigBlackboard.GetValue("packedMapVertexes", true), cookedChunks);
+	MapMesh::GetChunkViews(cookedChunks, chunkViews);
+	map->CreateRenderResources(chunkViews);
+	map->GenerateClouds();
+
+	// The camera is placed where a rendered map puts it and put back afterwards
+	Game* game = g_app->m_game;
+	Camera previousWorldCamera = game->m_worldCamera;
+	FrameRenderStats previousFrameRenderStats = g_frameRenderStats;
+	game->m_worldCamera.SetTransform(Vec3(0.f, map->m_dimensions.y * 0.5f, 5.f), EulerAngles(0.f, 15.f, 0.f));
+
+	std::vector<std::string> towerNames;
+	for (auto towerDefIter = TowerDefinition::s_towerDefs.begin(); towerDefIter != TowerDefinition::s_towerDefs.end(); ++towerDefIter)
+	{
+		towerNames.push_back(towerDefIter->first);
+	}
+	int numTowersPlaced = 0;
+	for (int blockIndex = 0; blockIndex < map->m_dimensions.x * map->m_dimensions.y && numTowersPlaced < numTowers; blockIndex++)
+	{
+		IntVec2 blockCoords = IntVec2(blockIndex % map->m_dimensions.x, blockIndex / map->m_dimensions.x);
+		if (map->PlaceTowerAtBlock(towerNames[numTowersPlaced % (int)towerNames.size()], blockCoords))
+		{
+			numTowersPlaced++;
+		}
+	}
+
+	std::vector<IntVec2> traversableBlocks;
+	for (int blockIndex = 0; blockIndex < map->m_dimensions.x * map->m_dimensions.y; blockIndex++)
+	{
+		IntVec2 blockCoords = IntVec2(blockIndex % map->m_dimensions.x, blockIndex / map->m_dimensions.x);
+		if (map->m_blocks.Get(blockCoords).IsEnemyTraversable())
+		{
+			traversableBlocks.push_back(blockCoords);
+		}
+	}
+	std::string const& enemyName = EnemyDefinition::s_enemyDefs.begin()->first;
+	for (int enemyIndex = 0; enemyIndex < numEnemies; enemyIndex++)
+	{
+		Enemy* enemy = map->SpawnEnemy(enemyName, GetRandomTraversablePosition(traversableBlocks));
+		map->m_enemyGrid.UpdateEnemy(enemy);
+	}
+
+	std::vector<Texture*> textures;
+	for (auto particleTexturesIter = ParticleSystem::s_particleTextures.begin(); particleTexturesIter != ParticleSystem::s_particleTextures.end(); ++particleTexturesIter)
+	{
+		textures.push_back(particleTexturesIter->second);
+	}
+	for (int particleIndex = 0; particleIndex < numParticles && !textures.empty(); particleIndex++)
+	{
+		Vec3 position = GetRandomTraversablePosition(traversableBlocks) + Vec3(0.f, 0.f, g_RNG->RollRandomFloatZeroToOne());
+		Texture* texture = textures[g_RNG->RollRandomIntLessThan((int)textures.size())];
+		BlendMode blendMode = g_RNG->RollRandomIntLessThan(2) == 0 ? BlendMode::ALPHA : BlendMode::ADDITIVE;
+		map->m_particleSystem->Spawn(position, Vec3::ZERO, 0.f, 0.f, 0.25f, 1000.f, texture, Rgba8::WHITE, blendMode);
+	}
+
+	RenderRecordingStats warmupStats;
+	RenderRecordingStats steadyStateMaxStats;
+	for (int frameIndex = 0; frameIndex < numFrames; frameIndex++)
+	{
+		recordingBackend.BeginFrame();
+		map->Render();
+
+		RenderRecordingStats const& frameStats = recordingBackend.m_frameStats;
+		if (frameIndex == 0)
+		{
+			warmupStats = frameStats;
+			continue;
+		}
+
+		KeepWorstRenderFrame(steadyStateMaxStats, frameStats);
+	}
+
+	// Placeholder buffers only mean something to the backend that made them, so the map goes before the backend is swapped back
+	int numLiveParticles = map->m_particleSystem->GetNumLiveParticles();
+	delete map;
+	g_renderBackend = previousBackend;
+
+	game->m_worldCamera = previousWorldCamera;
+	g_frameRenderStats = previousFrameRenderStats;
+
+	bool isDrawBudgetMet = steadyStateMaxStats.m_numDrawCalls <= maxDrawCalls;
+	bool isBufferBudgetMet = steadyStateMaxStats.m_numBuffersCreated == 0;
+	g_console->AddLine(Rgba8::GREEN, Stringf("Render budget: %d towers, %d enemies, %d particles, %d frames on %s", numTowersPlaced, numEnemies, numLiveParticles, numFrames, mapName.c_str()));
+	g_console->AddLine(Rgba8::WHITE, Stringf("Warm-up frame: %d draws, %d state changes, %d uploads (%.1fKB), %d buffers created", warmupStats.m_numDrawCalls, warmupStats.m_numStateChanges, warmupStats.m_numUploads, (double)warmupStats.m_numBytesUploaded / 1024.0, warmupStats.m_numBuffersCreated));
+	g_console->AddLine(Rgba8::WHITE, Stringf("Steady state worst frame: %d state changes, %d uploads (%.1fKB)", steadyStateMaxStats.m_numStateChanges, steadyStateMaxStats.m_numUploads, (double)steadyStateMaxStats.m_numBytesUploaded / 1024.0));
+	g_console->AddLine(isDrawBudgetMet ? Rgba8::GREEN : Rgba8::RED, Stringf("%s: %d draws per frame, budget %d", isDrawBudgetMet ? "PASS" : "FAIL", steadyStateMaxStats.m_numDrawCalls, maxDrawCalls));
+	g_console->AddLine(isBufferBudgetMet ? Rgba8::GREEN : Rgba8::RED, Stringf("%s: %d buffers created per frame, budget 0", isBufferBudgetMet ? "PASS" : "FAIL", steadyStateMaxStats.m_numBuffersCreated));
+
+	return isDrawBudgetMet && isBufferBudgetMet;
+}
+
+bool Benchmarks::Event_BenchmarkMapMeshing(EventArgs& args)
+{
+	bool isHelp = args.GetValue("help", false);
+	if (isHelp)
+	{
+		g_console->AddLine("Compares serial per-block map meshing against neighbor-aware parallel chunk meshing on a tiled map, and times a full load of the map", false);
+		g_console->AddLine("Parameters", false);
+		g_console->AddLine(Stringf("\t\t%-20s: [int > 0] width and height in blocks of the tiled map (default 256)", "size"), false);
+		g_console->AddLine(Stringf("\t\t%-20s: [int > 0] number of times each mesher runs (default 5)", "repeats"), false);
+		g_console->AddLine(Stringf("\t\t%-20s: [string] map whose blocks are tiled (default Level1)", "map"), false);
+		return true;
+	}
+
+	int size = args.GetValue("size", 256);
+	int numRepeats = args.GetValue("repeats", 5);
+	std::string mapName = args.GetValue("map", "Level1");
+	if (numRepeats < 1)
+	{
+		numRepeats = 1;
+	}
+
+	Map* sourceMap = CreateBenchmarkMap(mapName);
+	if (!sourceMap)
+	{
+		return false;
+	}
+
+	Grid<Block> blocks;
+	TileBenchmarkBlocks(sourceMap, size, blocks);
+	MapDefinition sourceMapDef = sourceMap->m_definition;
+	delete sourceMap;
+
+	// A full load of the source map as a player gets it, with the cooked map cache off so the map is meshed from its image
+	// The camera the rendered map moves is put back afterwards
+	Game* game = g_app->m_game;
+	Vec3 previousCameraPosition = game->m_cameraPosition;
+	EulerAngles previousCameraOrientation = game->m_cameraOrientation;
+	Map* loadedMap = new Map(game, sourceMapDef, false, false);
+	game->m_cameraPosition = previousCameraPosition;
+	game->m_cameraOrientation = previousCameraOrientation;
+
+	double loadMs = loadedMap->m_initializeSeconds * 1000.0;
+	IntVec2 loadedDimensions = loadedMap->m_dimensions;
+	std::vector<CookedMapChunk> loadedChunks;
+	double loadMeshingStartTime = GetCurrentTimeSeconds();
+	MapMesh::CookChunks(loadedMap->m_blocks, game->m_jobSystem, g_gameConfigBlackboard.GetValue("packedMapVertexes", true), loadedChunks);
+	double loadMeshingMs = (GetCurrentTimeSeconds() - loadMeshingStartTime) * 1000.0;
+	delete loadedMap;
+
+	std::vector<Vertex_PCUTBN> legacyVerts;
+	double legacyStartTime = GetCurrentTimeSeconds();
+	for (int repeatIndex = 0; repeatIndex < numRepeats; repeatIndex++)
+	{
+		legacyVerts.clear();
+		for (int blockIndex = 0; blockIndex < size * size; blockIndex++)
+		{
+			IntVec2 blockCoords = IntVec2(blockIndex % size, blockIndex / size);
+			AddBlockVertsLegacy(blocks.Get(blockCoords), legacyVerts, Vec3((float)blockCoords.x + 0.5f, (float)blockCoords.y + 0.5f, -0.2f));
+		}
+	}
+	double legacyMs = (GetCurrentTimeSeconds() - legacyStartTime) * 1000.0 / (double)numRepeats;
+
+	std::vector<std::vector<Vertex_PCUTBN>> chunkVerts;
+	double serialStartTime = GetCurrentTimeSeconds();
+	for (int repeatIndex = 0; repeatIndex < numRepeats; repeatIndex++)
+	{
+		MapMesh::BuildAllChunkVerts(blocks, nullptr, chunkVerts);
+	}
+	double serialMs = (GetCurrentTimeSeconds() - serialStartTime) * 1000.0 / (double)numRepeats;
+
+	JobSystem* jobSystem = g_app->m_game->m_jobSystem;
+	double parallelStartTime = GetCurrentTimeSeconds();
+	for (int repeatIndex = 0; repeatIndex < numRepeats; repeatIndex++)
+	{
+		MapMesh::BuildAllChunkVerts(blocks, jobSystem, chunkVerts);
+	}
+	double parallelMs = (GetCurrentTimeSeconds() - parallelStartTime) * 1000.0 / (double)numRepeats;
+
+	int numChunkVerts = 0;
+	for (int chunkIndex = 0; chunkIndex < (int)chunkVerts.size(); chunkIndex++)
+	{
+		numChunkVerts += (int)chunkVerts[chunkIndex].size();
+	}
+
+	g_console->AddLine(Rgba8::GREEN, Stringf("Map meshing: %dx%d blocks tiled from %s, %d repeats", size, size, mapName.c_str(), numRepeats));
+	g_console->AddLine(Rgba8::WHITE, Stringf("Per-block serial: %.3fms, %d verts", legacyMs, (int)legacyVerts.size()));
+	g_console->AddLine(Rgba8::WHITE, Stringf("Neighbor-aware chunks, 1 thread: %.3fms, speedup %.2fx", serialMs, serialMs > 0.0 ? legacyMs / serialMs : 0.0));
+	g_console->AddLine(Rgba8::WHITE, Stringf("Neighbor-aware chunks, %d threads: %.3fms, speedup %.2fx", jobSystem->GetNumThreads(), parallelMs, parallelMs > 0.0 ? legacyMs / parallelMs : 0.0));
+	g_console->AddLine(Rgba8::WHITE, Stringf("Neighbor-aware verts: %d (%.1f%% of per-block)", numChunkVerts, legacyVerts.empty() ? 0.0 : 100.0 * (double)numChunkVerts / (double)legacyVerts.size()));
+	g_console->AddLine(Rgba8::WHITE, Stringf("Full load of %s (%dx%d, cooked from image): %.3fms, of which meshing %.3fms (%.1f%%)", mapName.c_str(), loadedDimensions.x, loadedDimensions.y, loadMs, loadMeshingMs, loadMs > 0.0 ? 100.0 * loadMeshingMs / loadMs : 0.0));
+
+	return true;
+}
+
+bool Benchmarks::Event_BenchmarkMapMeshIndexing(EventArgs& args)
+{
+	bool isHelp = args.GetValue("help", false);
+	if (isHelp)
+	{
+		g_console->AddLine("Welds and cache optimizes every map chunk, checks the triangles are unchanged and compares memory and vertex cache misses", false);
+		g_console->AddLine("Parameters", false);
+		g_console->AddLine(Stringf("\t\t%-20s: [int > 0] width and height in blocks of the tiled map (default 256)", "size"), false);
+		g_console->AddLine(Stringf("\t\t%-20s: [int > 0] number of times the chunks are indexed (default 5)", "repeats"), false);
+		g_console->AddLine(Stringf("\t\t%-20s: [string] map whose blocks are tiled (default Level1)", "map"), false);
+		return true;
+	}
+
+	int size = args.GetValue("size", 256);
+	int numRepeats = args.GetValue("repeats", 5);
+	std::string mapName = args.GetValue("map", "Level1");
+
+	Map* sourceMap = CreateBenchmarkMap(mapName);
+	if (!sourceMap)
+	{
+		return false;
+	}
+
+	Grid<Block> blocks;
+	TileBenchmarkBlocks(sourceMap, size, blocks);
+	delete sourceMap;
+
+	std::vector<std::vector<Vertex_PCUTBN>> chunkVerts;
+	MapMesh::BuildAllChunkVerts(blocks, g_app->m_game->m_jobSystem, chunkVerts);
+	int numChunks = (int)chunkVerts.size();
+
+	std::vector<std::vector<Vertex_PCUTBN>> chunkUniqueVerts(numChunks);
+	std::vector<std::vector<unsigned int>> chunkIndexes(numChunks);
+	double weldSeconds = 0.0;
+	double optimizeSeconds = 0.0;
+	for (int repeatIndex = 0; repeatIndex < numRepeats; repeatIndex++)
+	{
+		double weldStartTime = GetCurrentTimeSeconds();
+		for (int chunkIndex = 0; chunkIndex < numChunks; chunkIndex++)
+		{
+			WeldVertexes(chunkVerts[chunkIndex], chunkUniqueVerts[chunkIndex], chunkIndexes[chunkIndex]);
+		}
+		weldSeconds += GetCurrentTimeSeconds() - weldStartTime;
+
+		double optimizeStartTime = GetCurrentTimeSeconds();
+		for (int chunkIndex = 0; chunkIndex < numChunks; chunkIndex++)
+		{
+			OptimizeIndexOrderForVertexCache(chunkIndexes[chunkIndex], (int)chunkUniqueVerts[chunkIndex].size());
+			OptimizeVertexOrderForFetch(chunkUniqueVerts[chunkIndex], chunkIndexes[chunkIndex]);
+		}
+		optimizeSeconds += GetCurrentTimeSeconds() - optimizeStartTime;
+	}
+
+	// Miss ratios are weighted by triangle count, so they read as the whole map's average rather than the average chunk's
+	int numFlatVerts = 0;
+	int numUniqueVerts = 0;
+	int numIndexes = 0;
+	int numLargeChunks = 0;
+	double flatMisses = 0.0;
+	double indexedMisses = 0.0;
+	int numMismatchedChunks = 0;
+	for (int chunkIndex = 0; chunkIndex < numChunks; chunkIndex++)
+	{
+		std::vector<Vertex_PCUTBN> const& flatVerts = chunkVerts[chunkIndex];
+		if (flatVerts.empty())
+		{
+			continue;
+		}
+
+		if (!DoIndexedTrianglesMatch(flatVerts, chunkUniqueVerts[chunkIndex], chunkIndexes[chunkIndex]))
+		{
+			numMismatchedChunks++;
+		}
+
+		std::vector<unsigned int> flatIndexes(flatVerts.size());
+		for (int vertexIndex = 0; vertexIndex < (int)flatVerts.size(); vertexIndex++)
+		{
+			flatIndexes[vertexIndex] = (unsigned int)vertexIndex;
+		}
+
+		int numTriangles = (int)flatVerts.size() / 3;
+		flatMisses += (double)GetAverageCacheMissRatio(flatIndexes, VERTEX_CACHE_SIZE) * (double)numTriangles;
+		indexedMisses += (double)GetAverageCacheMissRatio(chunkIndexes[chunkIndex], VERTEX_CACHE_SIZE) * (double)numTriangles;
+
+		numFlatVerts += (int)flatVerts.size();
+		numUniqueVerts += (int)chunkUniqueVerts[chunkIndex].size();
+		numIndexes += (int)chunkIndexes[chunkIndex].size();
+		if (chunkUniqueVerts[chunkIndex].size() > 0xFFFF)
+		{
+			numLargeChunks++;
+		}
+	}
+
+	int numTriangles = numFlatVerts / 3;
+	size_t flatBytes = (size_t)numFlatVerts * sizeof(Vertex_PCUTBN);
+	size_t indexedBytes = (size_t)numUniqueVerts * sizeof(Vertex_PCUTBN) + (size_t)numIndexes * sizeof(unsigned int);
+	double weldMs = weldSeconds * 1000.0 / (double)numRepeats;
+	double optimizeMs = optimizeSeconds * 1000.0 / (double)numRepeats;
+
+	g_console->AddLine(Rgba8::GREEN, Stringf("Map mesh indexing: %dx%d blocks tiled from %s, %d chunks, %d repeats", size, size, mapName.c_str(), numChunks, numRepeats));
+	g_console->AddLine(Rgba8::WHITE, Stringf("Flat: %d verts, %.2fMB", numFlatVerts, (double)flatBytes / (1024.0 * 1024.0)));
+	g_console->AddLine(Rgba8::WHITE, Stringf("Indexed: %d verts, %d indexes, %.2fMB (%.1f%% of flat)", numUniqueVerts, numIndexes, (double)indexedBytes / (1024.0 * 1024.0), flatBytes > 0 ? 100.0 * (double)indexedBytes / (double)flatBytes : 0.0));
+	g_console->AddLine(Rgba8::WHITE, Stringf("Chunks that would need 32-bit indexes: %d/%d", numLargeChunks, numChunks));
+	g_console->AddLine(Rgba8::WHITE, Stringf("Vertex shader runs per triangle (%d entry FIFO): flat %.3f, optimized %.3f", VERTEX_CACHE_SIZE, numTriangles > 0 ? flatMisses / (double)numTriangles : 0.0, numTriangles > 0 ? indexedMisses / (double)numTriangles : 0.0));
+	g_console->AddLine(Rgba8::WHITE, Stringf("Weld: %.3fms, cache and fetch reorder: %.3fms", weldMs, optimizeMs));
+	if (numMismatchedChunks == 0)
+	{
+		g_console->AddLine(Rgba8::GREEN, "PASS: indexed triangles match the flat triangles in every chunk");
+	}
+	else
+	{
+		g_console->AddLine(Rgba8::RED, Stringf("FAIL: %d chunks have indexed triangles that differ from the flat triangles", numMismatchedChunks));
+	}
+
+	return numMismatchedChunks == 0;
+}
+
+bool Benchmarks::Event_CheckPackedMapVertexes(EventArgs& args)
+{
+	bool isHelp = args.GetValue("help", false);
+	if (isHelp)
+	{
+		g_console->AddLine("Packs and unpacks every welded map chunk vertex and checks the round trip errors and memory saved", false);
+		g_console->AddLine("Parameters", false);
+		g_console->AddLine(Stringf("\t\t%-20s: [int > 0] width and height in blocks of the tiled map (default 256)", "size"), false);
+		g_console->AddLine(Stringf("\t\t%-20s: [float > 0] largest normal and tangent error allowed in degrees (default 1)", "maxDegrees"), false);
+		g_console->AddLine(Stringf("\t\t%-20s: [string] map whose blocks are tiled (default Level1)", "map"), false);
+		return true;
+	}
+
+	int size = args.GetValue("size", 256);
+	float maxDegrees = args.GetValue("maxDegrees", 1.f);
+	std::string mapName = args.GetValue("map", "Level1");
+
+	Map* sourceMap = CreateBenchmarkMap(mapName);
+	if (!sourceMap)
+	{
+		return false;
+	}
+
+	Grid<Block> blocks;
+	TileBenchmarkBlocks(sourceMap, size, blocks);
+	delete sourceMap;
+
+	std::vector<std::vector<Vertex_PCUTBN>> chunkVerts;
+	MapMesh::BuildAllChunkVerts(blocks, g_app->m_game->m_jobSystem, chunkVerts);
+
+	// Directions are compared by angle; source tangents too short to have one are skipped, as are bitangents of frames that are not right handed or left handed
+	float const minCosine = CosDegrees(maxDegrees);
+	float maxPositionError = 0.f;
+	float minNormalCosine = 1.f;
+	float minTangentCosine = 1.f;
+	int numChunks = 0;
+	int numUnpackableChunks = 0;
+	int numVerts = 0;
+	int numExactMismatches = 0;
+	int numFlippedBitangents = 0;
+	int numNonNormalChunks = 0;
+	std::vector<Vertex_PCUTBN> uniqueVerts;
+	std::vector<unsigned int> indexes;
+	std::vector<Vertex_MapPacked> packedVerts;
+	for (int chunkIndex = 0; chunkIndex < (int)chunkVerts.size(); chunkIndex++)
+	{
+		if (chunkVerts[chunkIndex].empty())
+		{
+			continue;
+		}
+
+		numChunks++;
+		WeldVertexes(chunkVerts[chunkIndex], uniqueVerts, indexes);
+		Vec3 origin = GetPackedMapVertexOrigin(MapMesh::GetVertexBounds(uniqueVerts));
+		if (!EncodeMapVertexes(uniqueVerts, origin, packedVerts))
+		{
+			numUnpackableChunks++;
+			continue;
+		}
+
+		// The packed words go through float conversions on the way to the shader, which only NaNs, infinities and denormals would not survive
+		if (!AreMapVertexWordsNormal(reinterpret_cast<uint8_t const*>(packedVerts.data()), (int)packedVerts.size()))
+		{
+			numNonNormalChunks++;
+		}
+
+		numVerts += (int)uniqueVerts.size();
+		for (int vertexIndex = 0; vertexIndex < (int)uniqueVerts.size(); vertexIndex++)
+		{
+			Vertex_PCUTBN const& vert = uniqueVerts[vertexIndex];
+			Vertex_PCUTBN decodedVert = DecodeMapVertex(packedVerts[vertexIndex], origin);
+
+			Vec3 positionError = decodedVert.m_position - vert.m_position;
+			float largestAxisError = fabsf(positionError.x) > fabsf(positionError.y) ? fabsf(positionError.x) : fabsf(positionError.y);
+			largestAxisError = fabsf(positionError.z) > largestAxisError ? fabsf(positionError.z) : largestAxisError;
+			maxPositionError = largestAxisError > maxPositionError ? largestAxisError : maxPositionError;
+
+			float normalCosine = DotProduct3D(decodedVert.m_normal, vert.m_normal.GetNormalized());
+			minNormalCosine = normalCosine < minNormalCosine ? normalCosine : minNormalCosine;
+			if (vert.m_tangent.GetLength() > 0.5f)
+			{
+				float tangentCosine = DotProduct3D(decodedVert.m_tangent, vert.m_tangent.GetNormalized());
+				minTangentCosine = tangentCosine < minTangentCosine ? tangentCosine : minTangentCosine;
+			}
+
+			if (vert.m_bitangent.GetLength() > 0.5f && DotProduct3D(decodedVert.m_bitangent, vert.m_bitangent) < 0.f)
+			{
+				numFlippedBitangents++;
+			}
+
+			bool isSameColor = decodedVert.m_color.r == vert.m_color.r && decodedVert.m_color.g == vert.m_color.g && decodedVert.m_color.b == vert.m_color.b && decodedVert.m_color.a == vert.m_color.a;
+			bool isSameUV = decodedVert.m_uvTexCoords.x == vert.m_uvTexCoords.x && decodedVert.m_uvTexCoords.y == vert.m_uvTexCoords.y;
+			if (!isSameColor || !isSameUV)
+			{
+				numExactMismatches++;
+			}
+		}
+	}
+
+	size_t fullBytes = (size_t)numVerts * sizeof(Vertex_PCUTBN);
+	size_t packedBytes = (size_t)numVerts * sizeof(Vertex_MapPacked);
+	bool arePositionsWithinHalfStep = maxPositionError <= PACKED_MAP_POSITION_STEP * 0.5f + 0.0001f;
+	bool areDirectionsWithinLimit = minNormalCosine >= minCosine && minTangentCosine >= minCosine;
+	bool isPassing = arePositionsWithinHalfStep && areDirectionsWithinLimit && numExactMismatches == 0 && numFlippedBitangents == 0 && numNonNormalChunks == 0;
+
+	g_console->AddLine(Rgba8::GREEN, Stringf("Packed map vertexes: %dx%d blocks tiled from %s, %d chunks, %d could not be packed", size, size, mapName.c_str(), numChunks, numUnpackableChunks));
+	g_console->AddLine(Rgba8::WHITE, Stringf("Vertexes: %d, %.2fMB full, %.2fMB packed (%.2fx smaller)", numVerts, (double)fullBytes / (1024.0 * 1024.0), (double)packedBytes / (1024.0 * 1024.0), packedBytes > 0 ? (double)fullBytes / (double)packedBytes : 0.0));
+	g_console->AddLine(Rgba8::WHITE, Stringf("Largest position error: %.6f (step %.6f)", maxPositionError, PACKED_MAP_POSITION_STEP));
+	g_console->AddLine(Rgba8::WHITE, Stringf("Largest normal error: %.3f degrees, tangent error: %.3f degrees", GetDegreesFromCosine(minNormalCosine), GetDegreesFromCosine(minTangentCosine)));
+	g_console->AddLine(Rgba8::WHITE, Stringf("Color or UV mismatches: %d, flipped bitangents: %d", numExactMismatches, numFlippedBitangents));
+	g_console->AddLine(Rgba8::WHITE, Stringf("Chunks with packed words that are not normal floats: %d", numNonNormalChunks));
+	if (isPassing)
+	{
+		g_console->AddLine(Rgba8::GREEN, "PASS: every packed vertex decodes within tolerance");
+	}
+	else
+	{
+		g_console->AddLine(Rgba8::RED, "FAIL: some packed vertexes decode outside tolerance");
+	}
+
+	return isPassing;
+}
+
+bool Benchmarks::Event_BenchmarkClosestPathBlock(EventArgs& args)
+{
+	bool isHelp = args.GetValue("help", false);
+	if (isHelp)
+	{
+		g_console->AddLine("Compares per-query closest path block searches against the precomputed lookup on a synthetic map with one winding path", false);
+		g_console->AddLine("Parameters", false);
+		g_console->AddLine(Stringf("\t\t%-20s: [int > 0] width and height in blocks of the synthetic map (default 512)", "size"), false);
+		g_console->AddLine(Stringf("\t\t%-20s: [int > 0] number of closest path block queries at random blocks (default 1000)", "queries"), false);
+		g_console->AddLine(Stringf("\t\t%-20s: [string] map the path and ground blocks are taken from (default Level1)", "map"), false);
+		return true;
+	}
+
+	int size = args.GetValue("size", 512);
+	int numQueries = args.GetValue("queries", 1000);
+	std::string mapName = args.GetValue("map", "Level1");
+
+	Map* sourceMap = CreateBenchmarkMap(mapName);
+	if (!sourceMap)
+	{
+		return false;
+	}
+
+	Block pathBlock;
+	Block groundBlock;
+	for (int blockIndex = 0; blockIndex < sourceMap->m_dimensions.x * sourceMap->m_dimensions.y; blockIndex++)
+	{
+		Block const& block = sourceMap->m_blocks.Get(IntVec2(blockIndex % sourceMap->m_dimensions.x, blockIndex / sourceMap->m_dimensions.x));
+		if (block.IsEnemyTraversable())
+		{
+			pathBlock = block;
+		}
+		else
+		{
+			groundBlock = block;
+		}
+	}
+	delete sourceMap;
+
+	// One path wanders from the west edge to the east edge, so most blocks are far from it
+	IntVec2 dimensions = IntVec2(size, size);
+	Grid<Block> blocks(dimensions, groundBlock);
+	IntVec2 pathCoords = IntVec2(0, size / 2);
+	blocks.Get(pathCoords) = pathBlock;
+	while (pathCoords.x < size - 1)
+	{
+		int stepDirection = g_RNG->RollRandomIntLessThan(4);
+		if (stepDirection < 2)
+		{
+			pathCoords.x++;
+		}
+		else
+		{
+			pathCoords.y = GetClamped(pathCoords.y + (stepDirection == 2 ? 1 : -1), 0, size - 1);
+		}
+		blocks.Get(pathCoords) = pathBlock;
+	}
+
+	std::vector<IntVec2> queryCoords;
+	queryCoords.reserve(numQueries);
+	for (int queryIndex = 0; queryIndex < numQueries; queryIndex++)
+	{
+		queryCoords.push_back(IntVec2(g_RNG->RollRandomIntLessThan(size), g_RNG->RollRandomIntLessThan(size)));
+	}
+
+	Grid<int> closestPathBlockIndexes;
+	double transformStartTime = GetCurrentTimeSeconds();
+	Map::ComputeClosestPathBlocks(blocks, closestPathBlockIndexes);
+	double transformMs = (GetCurrentTimeSeconds() - transformStartTime) * 1000.0;
+
+	std::vector<int> lookupResults(numQueries, -1);
+	double lookupStartTime = GetCurrentTimeSeconds();
+	for (int queryIndex = 0; queryIndex < numQueries; queryIndex++)
+	{
+		lookupResults[queryIndex] = closestPathBlockIndexes.Get(queryCoords[queryIndex]);
+	}
+	double lookupMs = (GetCurrentTimeSeconds() - lookupStartTime) * 1000.0;
+
+	std::vector<int> searchResults(numQueries, -1);
+	double searchStartTime = GetCurrentTimeSeconds();
+	for (int queryIndex = 0; queryIndex < numQueries; queryIndex++)
+	{
+		searchResults[queryIndex] = GetClosestPathBlockIndexBFS(blocks, queryCoords[queryIndex]);
+	}
+	double searchMs = (GetCurrentTimeSeconds() - searchStartTime) * 1000.0;
+
+	// Both break ties between equally close path blocks the same way, so they have to find the very same block
+	int numMismatches = 0;
+	for (int queryIndex = 0; queryIndex < numQueries; queryIndex++)
+	{
+		if (lookupResults[queryIndex] == -1 || lookupResults[queryIndex] != searchResults[queryIndex])
+		{
+			numMismatches++;
+		}
+	}
+
+	size_t lookupBytes = (size_t)closestPathBlockIndexes.GetStorageSize() * sizeof(int);
+	g_console->AddLine(Rgba8::GREEN, Stringf("Closest path block: %dx%d synthetic map from %s, %d queries", size, size, mapName.c_str(), numQueries));
+	g_console->AddLine(Rgba8::WHITE, Stringf("Distance transform: %.3fms once per map, %.2fMB", transformMs, (double)lookupBytes / (1024.0 * 1024.0)));
+	g_console->AddLine(Rgba8::WHITE, Stringf("Per-query search: %.3fms total, %.3fus per query", searchMs, searchMs * 1000.0 / (double)numQueries));
+	g_console->AddLine(Rgba8::WHITE, Stringf("Lookup: %.3fms total, %.3fus per query, speedup %.1fx", lookupMs, lookupMs * 1000.0 / (double)numQueries, lookupMs > 0.0 ? searchMs / lookupMs : 0.0));
+	if (numMismatches == 0)
+	{
+		g_console->AddLine(Rgba8::GREEN, "PASS: every lookup finds the same path block as the search");
+	}
+	else
+	{
+		g_console->AddLine(Rgba8::RED, Stringf("FAIL: %d lookups find a different path block than the search", numMismatches));
+	}
+
+	return numMismatches == 0;
+}
+
+bool Benchmarks::Event_BenchmarkGridBFS(EventArgs& args)
+{
+	bool isHelp = args.GetValue("help", false);
+	if (isHelp)
+	{
+		g_console->AddLine("Compares heat map BFS throughput of the bounds checked flat array against the padded grid in row-major and Morton order", false);
+		g_console->AddLine("Parameters", false);
+		g_console->AddLine(Stringf("\t\t%-20s: [int > 0] width and height in blocks of the tiled map (default 512)", "size"), false);
+		g_console->AddLine(Stringf("\t\t%-20s: [int > 0] number of times each BFS is run (default 10)", "repeats"), false);
+		g_console->AddLine(Stringf("\t\t%-20s: [string] map that is tiled out to the requested size (default Level1)", "map"), false);
+		return true;
+	}
+
+	int size = args.GetValue("size", 512);
+	int numRepeats = args.GetValue("repeats", 10);
+	std::string mapName = args.GetValue("map", "Level1");
+
+	Map* sourceMap = CreateBenchmarkMap(mapName);
+	if (!sourceMap)
+	{
+		return false;
+	}
+
+	Grid<Block> blocks;
+	TileBenchmarkBlocks(sourceMap, size, blocks);
+	delete sourceMap;
+
+	IntVec2 dimensions = blocks.GetDimensions();
+	std::vector<Block> flatBlocks;
+	flatBlocks.reserve(size * size);
+	Grid<Block, GridOrder::MORTON> mortonBlocks(dimensions);
+	for (int blockY = 0; blockY < size; blockY++)
+	{
+		for (int blockX = 0; blockX < size; blockX++)
+		{
+			IntVec2 blockCoords = IntVec2(blockX, blockY);
+			flatBlocks.push_back(blocks.Get(blockCoords));
+			mortonBlocks.Get(blockCoords) = blocks.Get(blockCoords);
+		}
+	}
+
+	std::vector<float> legacyHeatValues;
+	double legacyStartTime = GetCurrentTimeSeconds();
+	for (int repeatIndex = 0; repeatIndex < numRepeats; repeatIndex++)
+	{
+		ComputeHeatMapLegacy(flatBlocks, dimensions, legacyHeatValues);
+	}
+	double legacyMs = (GetCurrentTimeSeconds() - legacyStartTime) * 1000.0 / (double)numRepeats;
+
+	Grid<float> heatMap;
+	double gridStartTime = GetCurrentTimeSeconds();
+	for (int repeatIndex = 0; repeatIndex < numRepeats; repeatIndex++)
+	{
+		Map::ComputeHeatMap(blocks, heatMap);
+	}
+	double gridMs = (GetCurrentTimeSeconds() - gridStartTime) * 1000.0 / (double)numRepeats;
+
+	Grid<float, GridOrder::MORTON> mortonHeatMap;
+	double mortonStartTime = GetCurrentTimeSeconds();
+	for (int repeatIndex = 0; repeatIndex < numRepeats; repeatIndex++)
+	{
+		ComputeHeatMapMorton(mortonBlocks, mortonHeatMap);
+	}
+	double mortonMs = (GetCurrentTimeSeconds() - mortonStartTime) * 1000.0 / (double)numRepeats;
+
+	int numMismatches = 0;
+	for (int blockY = 0; blockY < size; blockY++)
+	{
+		for (int blockX = 0; blockX < size; blockX++)
+		{
+			IntVec2 blockCoords = IntVec2(blockX, blockY);
+			float legacyHeatValue = legacyHeatValues[blockX + size * blockY];
+			if (heatMap.Get(blockCoords) != legacyHeatValue || mortonHeatMap.Get(blockCoords) != legacyHeatValue)
+			{
+				numMismatches++;
+			}
+		}
+	}
+
+	double numCells = (double)size * (double)size;
+	g_console->AddLine(Rgba8::GREEN, Stringf("Grid BFS: %dx%d blocks tiled from %s, %d repeats", size, size, mapName.c_str(), numRepeats));
+	g_console->AddLine(Rgba8::WHITE, Stringf("Bounds checked flat array: %.3fms, %.0f cells per ms", legacyMs, legacyMs > 0.0 ? numCells / legacyMs : 0.0));
+	g_console->AddLine(Rgba8::WHITE, Stringf("Padded grid, row-major: %.3fms, %.0f cells per ms, speedup %.2fx", gridMs, gridMs > 0.0 ? numCells / gridMs : 0.0, gridMs > 0.0 ? legacyMs / gridMs : 0.0));
+	g_console->AddLine(Rgba8::WHITE, Stringf("Padded grid, Morton: %.3fms, %.0f cells per ms, speedup %.2fx", mortonMs, mortonMs > 0.0 ? numCells / mortonMs : 0.0, mortonMs > 0.0 ? legacyMs / mortonMs : 0.0));
+	if (numMismatches == 0)
+	{
+		g_console->AddLine(Rgba8::GREEN, "PASS: every storage order produces the same heat map");
+	}
+	else
+	{
+		g_console->AddLine(Rgba8::RED, Stringf("FAIL: %d blocks differ in heat from the bounds checked BFS", numMismatches));
+	}
+
+	return numMismatches == 0;
+}
+
+bool Benchmarks::Event_BenchmarkBlockRoles(EventArgs& args)
+{
+	bool isHelp = args.GetValue("help", false);
+	if (isHelp)
+	{
+		g_console->AddLine("Compares block grid memory and role checks of full definition copies against one byte block type IDs", false);
+		g_console->AddLine("Parameters", false);
+		g_console->AddLine(Stringf("\t\t%-20s: [int > 0] width and height in blocks of the tiled map (default 256)", "size"), false);
+		g_console->AddLine(Stringf("\t\t%-20s: [int > 0] number of times every block's roles are checked (default 10)", "repeats"), false);
+		g_console->AddLine(Stringf("\t\t%-20s: [string] map that is tiled out to the requested size (default Level1)", "map"), false);
+		return true;
+	}
+
+	int size = args.GetValue("size", 256);
+	int numRepeats = args.GetValue("repeats", 10);
+	std::string mapName = args.GetValue("map", "Level1");
+
+	Map* sourceMap = CreateBenchmarkMap(mapName);
+	if (!sourceMap)
+	{
+		return false;
+	}
+
+	Grid<Block> blocks;
+	TileBenchmarkBlocks(sourceMap, size, blocks);
+	delete sourceMap;
+
+	std::vector<BenchmarkLegacyBlock> legacyBlocks;
+	legacyBlocks.reserve(size * size);
+	for (int blockY = 0; blockY < size; blockY++)
+	{
+		for (int blockX = 0; blockX < size; blockX++)
+		{
+			BenchmarkLegacyBlock legacyBlock;
+			legacyBlock.m_definition = blocks.Get(IntVec2(blockX, blockY)).GetDefinition();
+			legacyBlocks.push_back(legacyBlock);
+		}
+	}
+
+	BenchmarkBlockRoleCounts legacyCounts;
+	double legacyStartTime = GetCurrentTimeSeconds();
+	for (int repeatIndex = 0; repeatIndex < numRepeats; repeatIndex++)
+	{
+		CountBlockRolesLegacy(legacyBlocks, legacyCounts);
+	}
+	double legacyMs = (GetCurrentTimeSeconds() - legacyStartTime) * 1000.0 / (double)numRepeats;
+
+	BenchmarkBlockRoleCounts counts;
+	double flyweightStartTime = GetCurrentTimeSeconds();
+	for (int repeatIndex = 0; repeatIndex < numRepeats; repeatIndex++)
+	{
+		CountBlockRoles(blocks, counts);
+	}
+	double flyweightMs = (GetCurrentTimeSeconds() - flyweightStartTime) * 1000.0 / (double)numRepeats;
+
+	bool doCountsMatch = legacyCounts.m_numStartBlocks == counts.m_numStartBlocks && legacyCounts.m_numEndBlocks == counts.m_numEndBlocks &&
+		legacyCounts.m_numTreeBlocks == counts.m_numTreeBlocks && legacyCounts.m_numCrystalBlocks == counts.m_numCrystalBlocks &&
+		legacyCounts.m_numTraversableBlocks == counts.m_numTraversableBlocks && legacyCounts.m_numBuildableBlocks == counts.m_numBuildableBlocks;
+
+	// Definition copies also own heap memory for names too long for the small string buffer, which is not counted here
+	size_t legacyBytes = legacyBlocks.size() * sizeof(BenchmarkLegacyBlock);
+	size_t flyweightBytes = (size_t)blocks.GetStorageSize() * sizeof(Block);
+	g_console->AddLine(Rgba8::GREEN, Stringf("Block roles: %dx%d blocks tiled from %s, %d repeats, %d block types", size, size, mapName.c_str(), numRepeats, (int)BlockDefinition::s_blockTypes.size() - 1));
+	g_console->AddLine(Rgba8::WHITE, Stringf("Definition copies: %d bytes per block, %.2fMB grid, %.3fms per role scan", (int)sizeof(BenchmarkLegacyBlock), (double)legacyBytes / (1024.0 * 1024.0), legacyMs));
+	g_console->AddLine(Rgba8::WHITE, Stringf("Type IDs: %d byte per block, %.1fKB grid with border, %.3fms per role scan, speedup %.1fx", (int)sizeof(Block), (double)flyweightBytes / 1024.0, flyweightMs, flyweightMs > 0.0 ? legacyMs / flyweightMs : 0.0));
+	g_console->AddLine(Rgba8::WHITE, Stringf("Roles: %d start, %d end, %d tree, %d crystal, %d traversable, %d buildable", counts.m_numStartBlocks, counts.m_numEndBlocks, counts.m_numTreeBlocks, counts.m_numCrystalBlocks, counts.m_numTraversableBlocks, counts.m_numBuildableBlocks));
+	if (doCountsMatch)
+	{
+		g_console->AddLine(Rgba8::GREEN, "PASS: role bit tests agree with the definition name checks on every block");
+	}
+	else
+	{
+		g_console->AddLine(Rgba8::RED, "FAIL: role bit tests disagree with the definition name checks");
+	}
+
+	return doCountsMatch;
+}
+
+bool Benchmarks::Event_BenchmarkMapImagePalette(EventArgs& args)
+{
+	bool isHelp = args.GetValue("help", false);
+	if (isHelp)
+	{
+		g_console->AddLine("Compares resolving map image colors by searching every block definition against the hashed palette", false);
+		g_console->AddLine("Parameters", false);
+		g_console->AddLine(Stringf("\t\t%-20s: [int > 0] width and height in texels of the tiled map image (default 1024)", "size"), false);
+		g_console->AddLine(Stringf("\t\t%-20s: [string] map whose block colors are tiled out to the requested size (default Level1)", "map"), false);
+		return true;
+	}
+
+	int size = args.GetValue("size", 1024);
+	std::string mapName = args.GetValue("map", "Level1");
+
+	Map* sourceMap = CreateBenchmarkMap(mapName);
+	if (!sourceMap)
+	{
+		return false;
+	}
+
+	Grid<Block> sourceBlocks;
+	TileBenchmarkBlocks(sourceMap, size, sourceBlocks);
+	delete sourceMap;
+
+	// The decorations DecodeMapImage rolls are block types too, so every tiled texel has a color in the palette
+	std::vector<Rgba8> texels;
+	texels.reserve(size * size);
+	for (int texelY = 0; texelY < size; texelY++)
+	{
+		for (int texelX = 0; texelX < size; texelX++)
+		{
+			texels.push_back(sourceBlocks.Get(IntVec2(texelX, texelY)).GetDefinition().m_mapImageColor);
+		}
+	}
+
+	std::vector<uint8_t> legacyTypeIDs(texels.size(), 0);
+	double legacyStartTime = GetCurrentTimeSeconds();
+	for (int texelIndex = 0; texelIndex < (int)texels.size(); texelIndex++)
+	{
+		BlockDefinition blockDef = GetBlockDefinitionForColorLegacy(texels[texelIndex]);
+		legacyTypeIDs[texelIndex] = blockDef.m_typeID;
+	}
+	double legacyMs = (GetCurrentTimeSeconds() - legacyStartTime) * 1000.0;
+
+	Grid<Block> blocks(IntVec2(size, size));
+	double paletteStartTime = GetCurrentTimeSeconds();
+	for (int texelY = 0; texelY < size; texelY++)
+	{
+		for (int texelX = 0; texelX < size; texelX++)
+		{
+			blocks.Get(IntVec2(texelX, texelY)) = Block(texels[texelX + size * texelY]);
+		}
+	}
+	double paletteMs = (GetCurrentTimeSeconds() - paletteStartTime) * 1000.0;
+
+	int numMismatches = 0;
+	for (int texelIndex = 0; texelIndex < (int)texels.size(); texelIndex++)
+	{
+		if (blocks.Get(IntVec2(texelIndex % size, texelIndex / size)).m_typeID != legacyTypeIDs[texelIndex])
+		{
+			numMismatches++;
+		}
+	}
+
+	double numTexels = (double)texels.size();
+	g_console->AddLine(Rgba8::GREEN, Stringf("Map image palette: %dx%d texels tiled from %s, %d block types", size, size, mapName.c_str(), (int)BlockDefinition::s_blockTypes.size() - 1));
+	g_console->AddLine(Rgba8::WHITE, Stringf("Definition search: %.3fms, %.1fns per texel", legacyMs, legacyMs * 1000000.0 / numTexels));
+	g_console->AddLine(Rgba8::WHITE, Stringf("Palette: %.3fms, %.1fns per texel, speedup %.1fx", paletteMs, paletteMs * 1000000.0 / numTexels, paletteMs > 0.0 ? legacyMs / paletteMs : 0.0));
+	if (numMismatches == 0)
+	{
+		g_console->AddLine(Rgba8::GREEN, "PASS: the palette resolves every texel to the definition the search found");
+	}
+	else
+	{
+		g_console->AddLine(Rgba8::RED, Stringf("FAIL: %d texels resolve to a different block type", numMismatches));
+	}
+
+	return numMismatches == 0;
+}
+
+static bool AreCookedChunksEqual(CookedMapChunkView const& chunkA, CookedMapChunkView const& chunkB)
+{
+	Vec3 const& minsA = chunkA.m_bounds.m_mins;
+	Vec3 const& maxsA = chunkA.m_bounds.m_maxs;
+	Vec3 const& minsB = chunkB.m_bounds.m_mins;
+	Vec3 const& maxsB = chunkB.m_bounds.m_maxs;
+	bool areBoundsEqual = minsA.x == minsB.x && minsA.y == minsB.y && minsA.z == minsB.z && maxsA.x == maxsB.x && maxsA.y == maxsB.y && maxsA.z == maxsB.z;
+	bool areSizesEqual = chunkA.m_numVertexBytes == chunkB.m_numVertexBytes && chunkA.m_numIndexes == chunkB.m_numIndexes;
+	return chunkA.m_chunkCoords == chunkB.m_chunkCoords && areBoundsEqual && chunkA.m_isPacked == chunkB.m_isPacked && chunkA.m_numVerts == chunkB.m_numVerts && areSizesEqual &&
+		memcmp(chunkA.m_vertexBytes, chunkB.m_vertexBytes, chunkA.m_numVertexBytes) == 0 && memcmp(chunkA.m_indexBytes, chunkB.m_indexBytes, chunkA.m_numIndexes * sizeof(unsigned int)) == 0;
+}
+
+bool Benchmarks::Event_BenchmarkMapLoad(EventArgs& args)
+{
+	bool isHelp = args.GetValue("help", false);
+	if (isHelp)
+	{
+		g_console->AddLine("Compares loading a map with the cooked map cache off against loading it from the cache, and checks cooking and the cache give the same map", false);
+		g_console->AddLine("Parameters", false);
+		g_console->AddLine(Stringf("\t\t%-20s: [string] map to load (default Level1)", "map"), false);
+		return true;
+	}
+
+	std::string mapName = args.GetValue("map", "Level1");
+
+	auto mapDefIter = MapDefinition::s_mapDefs.find(mapName);
+	if (mapDefIter == MapDefinition::s_mapDefs.end())
+	{
+		g_console->AddLine(Rgba8::RED, Stringf("Could not benchmark loading unknown map \"%s\"", mapName.c_str()));
+		return false;
+	}
+
+	// Only rendered maps use the cache, so these are not headless; the camera they move is put back afterwards
+	Game* game = g_app->m_game;
+	Vec3 previousCameraPosition = game->m_cameraPosition;
+	EulerAngles previousCameraOrientation = game->m_cameraOrientation;
+	Camera previousWorldCamera = game->m_worldCamera;
+
+	// The uncached load is the baseline: it cooks the map without hashing the inputs or writing the file
+	// Deleting the cached file forces the cold load to cook the map and write it again for the warm one
+	Map* uncachedMap = new Map(game, mapDefIter->second, false, false);
+	std::remove(CookedMap::GetFilePath(mapName).c_str());
+	Map* coldMap = new Map(game, mapDefIter->second, false);
+	Map* warmMap = new Map(game, mapDefIter->second, false);
+
+	game->m_cameraPosition = previousCameraPosition;
+	game->m_cameraOrientation = previousCameraOrientation;
+	game->m_worldCamera = previousWorldCamera;
+
+	int numBlockMismatches = 0;
+	int numHeatMismatches = 0;
+	bool areDimensionsEqual = coldMap->m_dimensions == warmMap->m_dimensions;
+	for (int blockY = 0; blockY < coldMap->m_dimensions.y && areDimensionsEqual; blockY++)
+	{
+		for (int blockX = 0; blockX < coldMap->m_dimensions.x; blockX++)
+		{
+			IntVec2 blockCoords = IntVec2(blockX, blockY);
+			if (coldMap->m_blocks.Get(blockCoords).m_typeID != warmMap->m_blocks.Get(blockCoords).m_typeID)
+			{
+				numBlockMismatches++;
+			}
+			if (coldMap->m_heatMap.Get(blockCoords) != warmMap->m_heatMap.Get(blockCoords))
+			{
+				numHeatMismatches++;
+			}
+		}
+	}
+
+	MapMesh const* coldMesh = coldMap->m_mapMesh;
+	MapMesh const* warmMesh = warmMap->m_mapMesh;
+	bool areMeshesEqual = coldMesh->GetNumChunks() == warmMesh->GetNumChunks() && coldMesh->GetNumVerts() == warmMesh->GetNumVerts() &&
+		coldMesh->GetNumIndexes() == warmMesh->GetNumIndexes() && coldMesh->GetNumVertexBytes() == warmMesh->GetNumVertexBytes();
+
+	// The meshes only keep their GPU buffers, so the chunks the cold load uploaded are cooked again from its blocks,
+	// and the ones the warm load uploaded are read back from the file it loaded them from
+	MapDefinition const& mapDef = mapDefIter->second;
+	bool usePackedMapVertexes = g_gameConfigBlackboard.GetValue("packedMapVertexes", true);
+	std::vector<CookedMapChunk> coldChunks;
+	std::vector<CookedMapChunkView> coldChunkViews;
+	MapMesh::CookChunks(coldMap->m_blocks, coldMap->m_jobSystem, usePackedMapVertexes, coldChunks);
+	MapMesh::GetChunkViews(coldChunks, coldChunkViews);
+	CookedMap warmCookedMap;
+	uint32_t cookedMapKey = CookedMap::ComputeKey(mapDef.m_mapImageName, mapDef.m_decorationSeed, usePackedMapVertexes);
+	bool wasCookedMapRead = warmCookedMap.LoadFromFile(CookedMap::GetFilePath(mapName), cookedMapKey);
+	areMeshesEqual = areMeshesEqual && wasCookedMapRead && coldChunkViews.size() == warmCookedMap.m_chunkViews.size();
+	int numChunkMismatches = 0;
+	for (int chunkIndex = 0; chunkIndex < (int)coldChunkViews.size() && areMeshesEqual; chunkIndex++)
+	{
+		if (!AreCookedChunksEqual(coldChunkViews[chunkIndex], warmCookedMap.m_chunkViews[chunkIndex]))
+		{
+			numChunkMismatches++;
+		}
+	}
+	areMeshesEqual = areMeshesEqual && numChunkMismatches == 0;
+
+	double uncachedMs = uncachedMap->m_initializeSeconds * 1000.0;
+	double coldMs = coldMap->m_initializeSeconds * 1000.0;
+	double coldWriteMs = coldMap->m_cookedMapWriteSeconds * 1000.0;
+	double warmMs = warmMap->m_initializeSeconds * 1000.0;
+	bool wasColdLoadCooked = !coldMap->m_wasLoadedFromCookedMap;
+	bool wasWarmLoadCached = warmMap->m_wasLoadedFromCookedMap;
+	g_console->AddLine(Rgba8::GREEN, Stringf("Map load: %s, %dx%d blocks, %d chunks, %d verts, %d indexes", mapName.c_str(), coldMap->m_dimensions.x, coldMap->m_dimensions.y, coldMesh->GetNumChunks(), coldMesh->GetNumVerts(), coldMesh->GetNumIndexes()));
+	g_console->AddLine(Rgba8::WHITE, Stringf("Uncached load (cache off): %.3fms", uncachedMs));
+	g_console->AddLine(Rgba8::WHITE, Stringf("Cold load (cooked from image): %.3fms, of which writing the cache %.3fms", coldMs, coldWriteMs));
+	g_console->AddLine(Rgba8::WHITE, Stringf("Warm load (cooked cache): %.3fms, speedup %.1fx over the uncached load", warmMs, warmMs > 0.0 ? uncachedMs / warmMs : 0.0));
+
+	delete warmMap;
+	delete coldMap;
+	delete uncachedMap;
+
+	bool isPass = wasColdLoadCooked && wasWarmLoadCached && areDimensionsEqual && numBlockMismatches == 0 && numHeatMismatches == 0 && areMeshesEqual;
+	if (isPass)
+	{
+		g_console->AddLine(Rgba8::GREEN, "PASS: the cached load gives the same blocks, heat map and chunk vertexes, indexes and bounds as cooking the map");
+	}
+	else if (!wasColdLoadCooked || !wasWarmLoadCached)
+	{
+		g_console->AddLine(Rgba8::RED, "FAIL: the second load did not come from the cooked map cache; check cookedMapCache in GameConfig.xml and that Saves is writable");
+	}
+	else
+	{
+		g_console->AddLine(Rgba8::RED, Stringf("FAIL: %d block, %d heat map and %d chunk mismatches, meshes %s", numBlockMismatches, numHeatMismatches, numChunkMismatches, areMeshesEqual ? "match" : "differ"));
+	}
+
+	return isPass;
+}
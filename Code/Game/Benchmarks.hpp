@@ -0,0 +1,28 @@
+#pragma once
+
+#include "Engine/Core/EventSystem.hpp"
+
+
+// Dev console benchmarks for the hot gameplay and rendering paths
+// Benchmarks that need a level build their own headless map, so they can be run from the menu or in the middle of a level
+class Benchmarks
+{
+public:
+	static void RegisterConsoleCommands();
+
+	static bool Event_BenchmarkTargeting(EventArgs& args);
+	static bool Event_BenchmarkEnemyMovement(EventArgs& args);
+	static bool Event_BenchmarkStatusEffectSoak(EventArgs& args);
+	static bool Event_BenchmarkParticleBatching(EventArgs& args);
+	static bool Event_BenchmarkParticleUpdate(EventArgs& args);
+	static bool Event_BenchmarkJobScaling(EventArgs& args);
+	static bool Event_CheckRenderBudget(EventArgs& args);
+	static bool Event_BenchmarkMapMeshing(EventArgs& args);
+	static bool Event_BenchmarkMapMeshIndexing(EventArgs& args);
+	static bool Event_CheckPackedMapVertexes(EventArgs& args);
+	static bool Event_BenchmarkClosestPathBlock(EventArgs& args);
+	static bool Event_BenchmarkGridBFS(EventArgs& args);
+	static bool Event_BenchmarkBlockRoles(EventArgs& args);
+	static bool Event_BenchmarkMapImagePalette(EventArgs& args);
+	static bool Event_BenchmarkMapLoad(EventArgs& args);
+};
@@ -1,129 +1,133 @@
 #include "Game/Block.hpp"
 
-#include "Game/Map.hpp"
-
-#include "Engine/Core/DevConsole.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
-#include "Engine/Core/Models/CPUMesh.hpp"
-#include "Engine/Core/VertexUtils.hpp"
+#include "Engine/Core/StringUtils.hpp"
 #include "Engine/Math/MathUtils.hpp"
 
 
-Block::Block(Map* map, BlockDefinition blockDef)
-	: m_map(map)
-	, m_definition(blockDef)
+Block::Block(uint8_t typeID)
+	: m_typeID(typeID)
 {
 }
 
-Block::Block(Map* map, Rgba8 const& mapImageColor)
-	: m_map(map)
+Block::Block(Rgba8 const& mapImageColor)
+	: m_typeID(BlockDefinition::s_mapImagePalette.GetTypeID(mapImageColor))
 {
-	for (auto blockDefMapIter = BlockDefinition::s_blockDefs.begin(); blockDefMapIter != BlockDefinition::s_blockDefs.end(); ++blockDefMapIter)
+	if (m_typeID == 0)
 	{
-		BlockDefinition& blockDef = BlockDefinition::s_blockDefs[blockDefMapIter->first];
-		if (blockDef.m_mapImageColor.r == mapImageColor.r && blockDef.m_mapImageColor.g == mapImageColor.g && blockDef.m_mapImageColor.b == mapImageColor.b)
-		{
-			m_definition = blockDef;
-			return;
-		}
+		ERROR_AND_DIE(Stringf("Attempted to create BlockDefinition with mapImageColor not provided in XML: %d, %d, %d, %d", mapImageColor.r, mapImageColor.g, mapImageColor.b, mapImageColor.a));
 	}
+}
 
-	ERROR_AND_DIE(Stringf("Attempted to create BlockDefinition with mapImageColor not provided in XML: %d, %d, %d, %d", mapImageColor.r, mapImageColor.g, mapImageColor.b, mapImageColor.a));
+BlockDefinition const& Block::GetDefinition() const
+{
+	return *BlockDefinition::s_blockTypes[m_typeID];
 }
 
-void Block::AddVerts(std::vector<Vertex_PCUTBN>& verts, Vec3 const& position) const
+bool Block::HasRole(BlockRole role) const
 {
-	constexpr float HSR_EQUALITY_TOLERANCE = 0.001f;
+	return (BlockDefinition::s_blockTypes[m_typeID]->m_roleFlags & GetBlockRoleFlag(role)) != 0;
+}
 
-	std::vector<Vertex_PCUTBN>& vertexes = m_definition.m_model->m_cpuMesh->m_vertexes;
-	std::vector<Vertex_PCUTBN> allVerts;
-	for (int vertexIndex = 0; vertexIndex < (int)vertexes.size(); vertexIndex++)
+void Block::AddVerts(std::vector<Vertex_PCUTBN>& verts, Vec3 const& position, Block const* const neighbors[(int)BlockSide::COUNT]) const
+{
+	BlockDefinition const& definition = GetDefinition();
+	if (definition.m_facesIndex < 0)
 	{
-		allVerts.push_back(vertexes[vertexIndex]);
+		return;
 	}
 
-	std::vector<Vertex_PCUTBN> hsrVerts;
-	for (int vertexIndex = 0; vertexIndex < (int)allVerts.size(); vertexIndex++)
-	{
-		Vertex_PCUTBN const& vertex = allVerts[vertexIndex];
+	BlockFaces const& faces = definition.GetFaces();
+	AddTranslatedVerts(verts, faces.m_innerVerts, position);
 
-		if (IsBridge())
+	for (int sideIndex = 0; sideIndex < (int)BlockSide::COUNT; sideIndex++)
+	{
+		std::vector<Vertex_PCUTBN> const& sideVerts = faces.m_sideVerts[sideIndex];
+		Block const* neighbor = neighbors[sideIndex];
+		BlockDefinition const* neighborDefinition = neighbor ? &neighbor->GetDefinition() : nullptr;
+		if (!neighborDefinition || neighborDefinition->m_facesIndex < 0)
 		{
-			hsrVerts.push_back(vertex);
+			AddTranslatedVerts(verts, sideVerts, position);
 			continue;
 		}
 
-		if (vertex.m_position.z > 0.2f)
+		// A side triangle is hidden when the neighbor's solid wall on the facing side reaches at least as high
+		BlockFaces const& neighborFaces = neighborDefinition->GetFaces();
+		if (!neighborFaces.m_hasSolidSideWalls)
 		{
-			hsrVerts.push_back(vertex);
+			AddTranslatedVerts(verts, sideVerts, position);
 			continue;
 		}
 
-		if (AreFloatsMostlyEqual(vertex.m_position.x, 0.5f, HSR_EQUALITY_TOLERANCE) && vertex.m_normal == Vec3::EAST)
+		float neighborWallTop = neighborFaces.m_sideWallTops[(int)GetOppositeBlockSide((BlockSide)sideIndex)];
+		if (faces.m_sideWallTops[sideIndex] <= neighborWallTop)
 		{
-			//verts.push_back(vertex);
 			continue;
 		}
-		if (AreFloatsMostlyEqual(vertex.m_position.x, -0.5f, HSR_EQUALITY_TOLERANCE) && vertex.m_normal == Vec3::WEST)
-		{
-			continue;
-		}
-		if (AreFloatsMostlyEqual(vertex.m_position.y, 0.5f, HSR_EQUALITY_TOLERANCE) && vertex.m_normal == Vec3::NORTH)
-		{
-			continue;
-		}
-		if (AreFloatsMostlyEqual(vertex.m_position.y, -0.5f, HSR_EQUALITY_TOLERANCE) && vertex.m_normal == Vec3::SOUTH)
+
+		for (int triangleStart = 0; triangleStart + 2 < (int)sideVerts.size(); triangleStart += 3)
 		{
-			continue;
+			Vertex_PCUTBN const* triangle = &sideVerts[triangleStart];
+			if (triangle[0].m_position.z <= neighborWallTop && triangle[1].m_position.z <= neighborWallTop && triangle[2].m_position.z <= neighborWallTop)
+			{
+				continue;
+			}
+
+			for (int cornerIndex = 0; cornerIndex < 3; cornerIndex++)
+			{
+				verts.push_back(triangle[cornerIndex]);
+				verts.back().m_position += position;
+			}
 		}
-
-		hsrVerts.push_back(vertex);
 	}
+}
 
-	TransformVertexArray3D(hsrVerts, Mat44::CreateTranslation3D(position));
-
-	for (int vertexIndex = 0; vertexIndex < (int)hsrVerts.size(); vertexIndex++)
+void Block::AddTranslatedVerts(std::vector<Vertex_PCUTBN>& verts, std::vector<Vertex_PCUTBN> const& modelVerts, Vec3 const& position)
+{
+	size_t firstVertIndex = verts.size();
+	verts.insert(verts.end(), modelVerts.begin(), modelVerts.end());
+	for (size_t vertIndex = firstVertIndex; vertIndex < verts.size(); vertIndex++)
 	{
-		verts.push_back(hsrVerts[vertexIndex]);
+		verts[vertIndex].m_position += position;
 	}
 }
 
 bool Block::CanPlaceTower() const
 {
-	return m_definition.m_canPlaceTower;
+	return HasRole(BlockRole::CAN_PLACE_TOWER);
 }
 
 bool Block::IsEnemyTraversable() const
 {
-	return m_definition.m_enemyTraversable;
+	return HasRole(BlockRole::ENEMY_TRAVERSABLE);
 }
 
 bool Block::IsStartBlock() const
 {
-	return !strcmp(m_definition.m_name.c_str(), "StartLR") || !strcmp(m_definition.m_name.c_str(), "StartUD");
+	return HasRole(BlockRole::START);
 }
 
 bool Block::IsEndBlock() const
 {
-	return !strcmp(m_definition.m_name.c_str(), "EndLR") || !strcmp(m_definition.m_name.c_str(), "EndUD");
+	return HasRole(BlockRole::END);
 }
 
 bool Block::IsTree() const
 {
-	return m_definition.m_name.find("Tree") != std::string::npos;
+	return HasRole(BlockRole::TREE);
 }
 
 bool Block::IsCrystal() const
 {
-	return !strcmp(m_definition.m_name.c_str(), "Crystal");
+	return HasRole(BlockRole::CRYSTAL);
 }
 
 bool Block::IsInvalidBlock() const
 {
-	return m_definition.m_name.empty();
+	return m_typeID == 0;
 }
 
 bool Block::IsBridge() const
 {
-	return m_definition.m_isBridge;
+	return HasRole(BlockRole::BRIDGE);
 }
@@ -2,18 +2,22 @@
 
 #include "Game/BlockDefinition.hpp"
 
-class Map;
-class Tower;
 
+// One byte flyweight for a map cell: everything about the block lives in the definition its type ID points at
+// Towers standing on blocks are tracked by the map, since only a few blocks ever hold one
 class Block
 {
 public:
 	~Block() = default;
 	Block() = default;
-	Block(Map* map, Rgba8 const& mapImageColor);
-	Block(Map* map, BlockDefinition blockDef);
+	explicit Block(Rgba8 const& mapImageColor);
+	explicit Block(uint8_t typeID);
 
-	void AddVerts(std::vector<Vertex_PCUTBN>& verts, Vec3 const& position) const;
+	BlockDefinition const& GetDefinition() const;
+	bool HasRole(BlockRole role) const;
+
+	// Neighbors are indexed by BlockSide and are nullptr past the edge of the map
+	void AddVerts(std::vector<Vertex_PCUTBN>& verts, Vec3 const& position, Block const* const neighbors[(int)BlockSide::COUNT]) const;
 	bool CanPlaceTower() const;
 	bool IsEnemyTraversable() const;
 	bool IsStartBlock() const;
@@ -23,8 +27,10 @@ public:
 	bool IsInvalidBlock() const;
 	bool IsBridge() const;
 
+	static void AddTranslatedVerts(std::vector<Vertex_PCUTBN>& verts, std::vector<Vertex_PCUTBN> const& modelVerts, Vec3 const& position);
+
 public:
-	BlockDefinition m_definition;
-	Map* m_map = nullptr;
-	Tower* m_tower = nullptr;
+	uint8_t m_typeID = 0;
 };
+
+static_assert(sizeof(Block) == 1, "Block is stored once per map cell, so it must stay a single type ID byte");
@@ -1,10 +1,35 @@
 #include "Game/BlockDefinition.hpp"
 
-#include "Game/GameCommon.hpp"
+#include "Game/AssetBackend.hpp"
 
 #include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Math/Mat44.hpp"
+#include "Engine/Math/MathUtils.hpp"
+
+#include <cfloat>
 
 std::map<std::string, BlockDefinition> BlockDefinition::s_blockDefs;
+std::vector<BlockDefinition const*> BlockDefinition::s_blockTypes;
+std::vector<BlockFaces> BlockDefinition::s_blockFaces;
+MapImagePalette BlockDefinition::s_mapImagePalette;
+
+BlockSide GetOppositeBlockSide(BlockSide side)
+{
+	switch (side)
+	{
+		case BlockSide::EAST:		return BlockSide::WEST;
+		case BlockSide::WEST:		return BlockSide::EAST;
+		case BlockSide::NORTH:		return BlockSide::SOUTH;
+		case BlockSide::SOUTH:		return BlockSide::NORTH;
+		default:					return BlockSide::COUNT;
+	}
+}
+
+unsigned int GetBlockRoleFlag(BlockRole role)
+{
+	return 1u << (unsigned int)role;
+}
 
 void BlockDefinition::InitializeBlockDefinitions()
 {
@@ -25,6 +50,77 @@ void BlockDefinition::InitializeBlockDefinitions()
 		s_blockDefs[blockDef.m_name] = blockDef;
 		blockDefintionXmlElement = blockDefintionXmlElement->NextSiblingElement();
 	}
+
+	// Type IDs are handed out once every definition is in the map, whose nodes never move, so the table can point into it
+	static BlockDefinition const s_invalidBlockDef;
+	s_blockTypes.clear();
+	s_blockTypes.push_back(&s_invalidBlockDef);
+	if ((int)s_blockDefs.size() >= MAX_BLOCK_TYPES)
+	{
+		ERROR_AND_DIE(Stringf("Too many block definitions: %d, block type IDs only fit %d", (int)s_blockDefs.size(), MAX_BLOCK_TYPES - 1));
+	}
+
+	s_mapImagePalette.Clear();
+	for (auto blockDefMapIter = s_blockDefs.begin(); blockDefMapIter != s_blockDefs.end(); ++blockDefMapIter)
+	{
+		blockDefMapIter->second.m_typeID = (uint8_t)s_blockTypes.size();
+		s_blockTypes.push_back(&blockDefMapIter->second);
+		s_mapImagePalette.AddColor(blockDefMapIter->second.m_mapImageColor, blockDefMapIter->second.m_typeID);
+	}
+}
+
+void MapImagePalette::Clear()
+{
+	for (int slotIndex = 0; slotIndex < NUM_SLOTS; slotIndex++)
+	{
+		m_colorKeys[slotIndex] = 0;
+		m_typeIDs[slotIndex] = 0;
+	}
+}
+
+void MapImagePalette::AddColor(Rgba8 const& color, uint8_t typeID)
+{
+	// Definitions sharing a color keep the first one added, which is the one the old search over s_blockDefs found
+	uint32_t colorKey = GetColorKey(color);
+	int slotIndex = GetFirstSlot(colorKey);
+	while (m_colorKeys[slotIndex] != 0)
+	{
+		if (m_colorKeys[slotIndex] == colorKey)
+		{
+			return;
+		}
+		slotIndex = (slotIndex + 1) & (NUM_SLOTS - 1);
+	}
+
+	m_colorKeys[slotIndex] = colorKey;
+	m_typeIDs[slotIndex] = typeID;
+}
+
+uint8_t MapImagePalette::GetTypeID(Rgba8 const& color) const
+{
+	uint32_t colorKey = GetColorKey(color);
+	int slotIndex = GetFirstSlot(colorKey);
+	while (m_colorKeys[slotIndex] != 0)
+	{
+		if (m_colorKeys[slotIndex] == colorKey)
+		{
+			return m_typeIDs[slotIndex];
+		}
+		slotIndex = (slotIndex + 1) & (NUM_SLOTS - 1);
+	}
+
+	return 0;
+}
+
+uint32_t MapImagePalette::GetColorKey(Rgba8 const& color)
+{
+	return 0x01000000u | ((uint32_t)color.r << 16) | ((uint32_t)color.g << 8) | (uint32_t)color.b;
+}
+
+int MapImagePalette::GetFirstSlot(uint32_t colorKey)
+{
+	// Fibonacci hashing spreads neighboring colors over the table; the top bits of the product pick the slot
+	return (int)((colorKey * 2654435769u) >> (32 - NUM_SLOT_BITS));
 }
 
 BlockDefinition::BlockDefinition(XmlElement const* element)
@@ -37,18 +133,112 @@ BlockDefinition::BlockDefinition(XmlElement const* element)
 	}
 
 	m_name = ParseXmlAttribute(*element, "name", "INVALID_BLOCK_TYPE");
-	std::string modelName = ParseXmlAttribute(*element, "model", "");
-	if (!modelName.empty())
+	m_modelPath = ParseXmlAttribute(*element, "model", m_modelPath);
+	if (!m_modelPath.empty())
 	{
-		m_model = g_modelLoader->CreateOrGetModelFromObj(modelName.c_str(), modelTransformMatrix);
+		m_model = g_assetBackend->CreateOrGetModel(m_modelPath, modelTransformMatrix);
 	}
 	std::string textureName = ParseXmlAttribute(*element, "texture", "");
 	if (!textureName.empty())
 	{
-		m_texture = g_renderer->CreateOrGetTextureFromFile(textureName.c_str());
+		m_texture = g_assetBackend->CreateOrGetTexture(textureName);
 	}
 	m_canPlaceTower = ParseXmlAttribute(*element, "canPlaceTower", m_canPlaceTower);
 	m_enemyTraversable = ParseXmlAttribute(*element, "enemyTraversable", m_enemyTraversable);
 	m_isBridge = ParseXmlAttribute(*element, "isBridge", m_isBridge);
 	m_mapImageColor = ParseXmlAttribute(*element, "mapImageColor", m_mapImageColor);
+
+	ClassifyFaces();
+	ComputeRoleFlags();
+}
+
+BlockFaces const& BlockDefinition::GetFaces() const
+{
+	return s_blockFaces[m_facesIndex];
+}
+
+void BlockDefinition::ClassifyFaces()
+{
+	constexpr float BOUNDARY_TOLERANCE = 0.001f;
+
+	m_facesIndex = (int)s_blockFaces.size();
+	s_blockFaces.push_back(BlockFaces());
+	BlockFaces& faces = s_blockFaces.back();
+
+	// Bridges leave gaps between their planks, so they never hide the walls of the blocks next to them
+	std::vector<Vertex_PCUTBN> const* modelVertexes = g_assetBackend->GetModelVertexes(m_model);
+	faces.m_hasSolidSideWalls = modelVertexes && !m_isBridge;
+	for (int sideIndex = 0; sideIndex < (int)BlockSide::COUNT; sideIndex++)
+	{
+		faces.m_sideWallTops[sideIndex] = -FLT_MAX;
+	}
+
+	if (!modelVertexes)
+	{
+		return;
+	}
+
+	std::vector<Vertex_PCUTBN> const& vertexes = *modelVertexes;
+	float modelBottom = FLT_MAX;
+	for (int vertexIndex = 0; vertexIndex < (int)vertexes.size(); vertexIndex++)
+	{
+		modelBottom = vertexes[vertexIndex].m_position.z < modelBottom ? vertexes[vertexIndex].m_position.z : modelBottom;
+	}
+
+	Vec3 const sideNormals[(int)BlockSide::COUNT] = { Vec3::EAST, Vec3::WEST, Vec3::NORTH, Vec3::SOUTH };
+	for (int triangleStart = 0; triangleStart + 2 < (int)vertexes.size(); triangleStart += 3)
+	{
+		Vertex_PCUTBN const* triangle = &vertexes[triangleStart];
+
+		bool isBottomFace = true;
+		for (int cornerIndex = 0; cornerIndex < 3; cornerIndex++)
+		{
+			isBottomFace = isBottomFace && triangle[cornerIndex].m_normal.z < -0.99f && AreFloatsMostlyEqual(triangle[cornerIndex].m_position.z, modelBottom, BOUNDARY_TOLERANCE);
+		}
+		if (isBottomFace)
+		{
+			continue;
+		}
+
+		int triangleSide = -1;
+		for (int sideIndex = 0; sideIndex < (int)BlockSide::COUNT && triangleSide < 0; sideIndex++)
+		{
+			Vec3 const& sideNormal = sideNormals[sideIndex];
+			bool isOnSide = true;
+			for (int cornerIndex = 0; cornerIndex < 3; cornerIndex++)
+			{
+				Vertex_PCUTBN const& corner = triangle[cornerIndex];
+				float distanceAlongNormal = corner.m_position.x * sideNormal.x + corner.m_position.y * sideNormal.y;
+				isOnSide = isOnSide && corner.m_normal == sideNormal && AreFloatsMostlyEqual(distanceAlongNormal, 0.5f, BOUNDARY_TOLERANCE);
+			}
+			triangleSide = isOnSide ? sideIndex : -1;
+		}
+
+		std::vector<Vertex_PCUTBN>& destVerts = triangleSide >= 0 ? faces.m_sideVerts[triangleSide] : faces.m_innerVerts;
+		destVerts.push_back(triangle[0]);
+		destVerts.push_back(triangle[1]);
+		destVerts.push_back(triangle[2]);
+
+		if (triangleSide >= 0)
+		{
+			float& wallTop = faces.m_sideWallTops[triangleSide];
+			for (int cornerIndex = 0; cornerIndex < 3; cornerIndex++)
+			{
+				wallTop = triangle[cornerIndex].m_position.z > wallTop ? triangle[cornerIndex].m_position.z : wallTop;
+			}
+		}
+	}
+}
+
+void BlockDefinition::ComputeRoleFlags()
+{
+	// Roles that are only implied by the definition's name are resolved here once, so blocks never compare names at runtime
+	m_roleFlags = 0;
+	m_roleFlags |= (m_name == "StartLR" || m_name == "StartUD") ? GetBlockRoleFlag(BlockRole::START) : 0u;
+	m_roleFlags |= (m_name == "EndLR" || m_name == "EndUD") ? GetBlockRoleFlag(BlockRole::END) : 0u;
+	m_roleFlags |= m_name.find("Tree") != std::string::npos ? GetBlockRoleFlag(BlockRole::TREE) : 0u;
+	m_roleFlags |= m_name == "Crystal" ? GetBlockRoleFlag(BlockRole::CRYSTAL) : 0u;
+	m_roleFlags |= m_isBridge ? GetBlockRoleFlag(BlockRole::BRIDGE) : 0u;
+	m_roleFlags |= m_enemyTraversable ? GetBlockRoleFlag(BlockRole::ENEMY_TRAVERSABLE) : 0u;
+	m_roleFlags |= m_canPlaceTower ? GetBlockRoleFlag(BlockRole::CAN_PLACE_TOWER) : 0u;
 }
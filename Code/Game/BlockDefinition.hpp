@@ -1,28 +1,112 @@
 #pragma once
 
-#include "Engine/Core/Models/Model.hpp"
-#include "Engine/Renderer/Texture.hpp"
+#include "Engine/Core/Rgba8.hpp"
+#include "Engine/Core/VertexUtils.hpp"
 #include "Engine/Core/XMLUtils.hpp"
 
+#include <cstdint>
 #include <string>
 #include <map>
+#include <vector>
 
+class Model;
+class Texture;
+
+
+enum class BlockSide
+{
+	EAST,
+	WEST,
+	NORTH,
+	SOUTH,
+
+	COUNT
+};
+
+BlockSide GetOppositeBlockSide(BlockSide side);
+
+
+enum class BlockRole
+{
+	START,
+	END,
+	TREE,
+	CRYSTAL,
+	BRIDGE,
+	ENEMY_TRAVERSABLE,
+	CAN_PLACE_TOWER,
+
+	COUNT
+};
+
+unsigned int GetBlockRoleFlag(BlockRole role);
+
+
+// Triangles of a block model, sorted once at load by whether a neighboring block can hide them
+// Side triangles lie on one of the block's four vertical boundary planes; faces on the bottom of the model are never seen and are dropped
+struct BlockFaces
+{
+public:
+	std::vector<Vertex_PCUTBN> m_innerVerts;
+	std::vector<Vertex_PCUTBN> m_sideVerts[(int)BlockSide::COUNT];
+	float m_sideWallTops[(int)BlockSide::COUNT] = {};
+	bool m_hasSolidSideWalls = false;
+};
+
+
+// Open addressed hash table from the RGB of a map image texel to the block type it stands for; alpha is ignored, as it always was
+// Colors are keyed with an extra high bit so black is a valid color and a zero key marks an empty slot
+struct MapImagePalette
+{
+public:
+	static constexpr int NUM_SLOT_BITS = 10;
+	static constexpr int NUM_SLOTS = 1 << NUM_SLOT_BITS;
+
+	void Clear();
+	void AddColor(Rgba8 const& color, uint8_t typeID);
+	uint8_t GetTypeID(Rgba8 const& color) const;
+
+	static uint32_t GetColorKey(Rgba8 const& color);
+	static int GetFirstSlot(uint32_t colorKey);
+
+public:
+	uint32_t m_colorKeys[NUM_SLOTS] = {};
+	uint8_t m_typeIDs[NUM_SLOTS] = {};
+};
+
+
+// Blocks store only a type ID into s_blockTypes; type 0 is the invalid block, which is also what the map border holds
 class BlockDefinition
 {
 public:
+	static constexpr int MAX_BLOCK_TYPES = 256;
+
 	static std::map<std::string, BlockDefinition> s_blockDefs;
+	static std::vector<BlockDefinition const*> s_blockTypes;
+	static std::vector<BlockFaces> s_blockFaces;
+	static MapImagePalette s_mapImagePalette;
 
 	std::string m_name;
+	std::string m_modelPath;
 	Model* m_model = nullptr;
 	Texture* m_texture = nullptr;
 	bool m_canPlaceTower = false;
 	bool m_enemyTraversable = false;
 	bool m_isBridge = false;
 	Rgba8 m_mapImageColor = Rgba8::TRANSPARENT_BLACK;
+	int m_facesIndex = -1;
+	uint8_t m_typeID = 0;
+	unsigned int m_roleFlags = 0;
 
 public:
 	~BlockDefinition() = default;
 	BlockDefinition() = default;
 	explicit BlockDefinition(XmlElement const* element);
 	static void InitializeBlockDefinitions();
+
+	BlockFaces const& GetFaces() const;
+
+private:
+	void ClassifyFaces();
+	void ComputeRoleFlags();
 };
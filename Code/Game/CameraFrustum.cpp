@@ -0,0 +1,75 @@
+#include "Game/CameraFrustum.hpp"
+
+#include "Game/GameCommon.hpp"
+
+
+CameraFrustum::CameraFrustum(Camera const& camera)
+{
+	Vec3 cameraFwd, cameraLeft, cameraUp;
+	camera.GetOrientation().GetAsVectors_iFwd_jLeft_kUp(cameraFwd, cameraLeft, cameraUp);
+	Vec3 cameraPosition = camera.GetPosition();
+
+	// The perspective field of view is vertical, so the horizontal half angle is only known through its tangent
+	float halfFovY = camera.m_perspectiveFov * 0.5f;
+	float tanHalfFovX = TanDegrees(halfFovY) * camera.m_perspectiveAspect;
+	float cosHalfFovX = 1.f / sqrtf(1.f + tanHalfFovX * tanHalfFovX);
+	float sinHalfFovX = tanHalfFovX * cosHalfFovX;
+
+	Vec3 const normals[NUM_PLANES] =
+	{
+		cameraFwd,
+		cameraFwd * -1.f,
+		cameraFwd * sinHalfFovX - cameraLeft * cosHalfFovX,
+		cameraFwd * sinHalfFovX + cameraLeft * cosHalfFovX,
+		cameraFwd * SinDegrees(halfFovY) - cameraUp * CosDegrees(halfFovY),
+		cameraFwd * SinDegrees(halfFovY) + cameraUp * CosDegrees(halfFovY),
+	};
+	Vec3 const pointsOnPlanes[NUM_PLANES] =
+	{
+		cameraPosition + cameraFwd * camera.m_perspectiveNear,
+		cameraPosition + cameraFwd * camera.m_perspectiveFar,
+		cameraPosition,
+		cameraPosition,
+		cameraPosition,
+		cameraPosition,
+	};
+
+	for (int planeIndex = 0; planeIndex < NUM_PLANES; planeIndex++)
+	{
+		m_planes[planeIndex].m_normal = normals[planeIndex];
+		m_planes[planeIndex].m_distance = DotProduct3D(normals[planeIndex], pointsOnPlanes[planeIndex]);
+	}
+}
+
+bool CameraFrustum::IsSphereOutside(Vec3 const& center, float radius) const
+{
+	for (int planeIndex = 0; planeIndex < NUM_PLANES; planeIndex++)
+	{
+		FrustumPlane const& plane = m_planes[planeIndex];
+		if (DotProduct3D(plane.m_normal, center) - plane.m_distance < -radius)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool CameraFrustum::IsAABBOutside(AABB3 const& bounds) const
+{
+	for (int planeIndex = 0; planeIndex < NUM_PLANES; planeIndex++)
+	{
+		// The corner furthest along the plane normal is the last one to leave the volume
+		FrustumPlane const& plane = m_planes[planeIndex];
+		Vec3 furthestCorner;
+		furthestCorner.x = plane.m_normal.x >= 0.f ? bounds.m_maxs.x : bounds.m_mins.x;
+		furthestCorner.y = plane.m_normal.y >= 0.f ? bounds.m_maxs.y : bounds.m_mins.y;
+		furthestCorner.z = plane.m_normal.z >= 0.f ? bounds.m_maxs.z : bounds.m_mins.z;
+		if (DotProduct3D(plane.m_normal, furthestCorner) < plane.m_distance)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
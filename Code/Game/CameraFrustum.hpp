@@ -0,0 +1,33 @@
+#pragma once
+
+#include "Engine/Math/AABB3.hpp"
+#include "Engine/Math/Vec3.hpp"
+
+class Camera;
+
+
+struct FrustumPlane
+{
+public:
+	Vec3 m_normal = Vec3::ZERO;
+	float m_distance = 0.f;
+};
+
+
+// World space view volume of a perspective camera, with every plane normal pointing into the volume
+// Only meant for conservative culling: shapes that straddle a plane are always kept
+struct CameraFrustum
+{
+public:
+	static constexpr int NUM_PLANES = 6;
+
+	FrustumPlane m_planes[NUM_PLANES];
+
+public:
+	~CameraFrustum() = default;
+	CameraFrustum() = default;
+	explicit CameraFrustum(Camera const& camera);
+
+	bool IsSphereOutside(Vec3 const& center, float radius) const;
+	bool IsAABBOutside(AABB3 const& bounds) const;
+};
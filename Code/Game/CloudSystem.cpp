@@ -0,0 +1,163 @@
+#include "Game/CloudSystem.hpp"
+
+#include "Game/GameCommon.hpp"
+#include "Game/RenderBackend.hpp"
+#include "Game/RenderCommandList.hpp"
+
+#include "Engine/Renderer/VertexBuffer.hpp"
+
+#include <algorithm>
+
+
+constexpr float CLOUD_TEXEL_SIZE = 0.01f;
+
+
+CloudSystem::~CloudSystem()
+{
+	DestroyBuffer(m_vertexBuffer);
+}
+
+CloudSystem::CloudSystem(Vec2 const& wrapMins, Vec2 const& wrapMaxs)
+	: m_wrapMins(wrapMins)
+	, m_wrapMaxs(wrapMaxs)
+{
+}
+
+void CloudSystem::AddCloud(Vec3 const& startPosition, Vec3 const& velocity, int textureIndex, BillboardType billboardType)
+{
+	Cloud cloud;
+	cloud.m_startPosition = startPosition;
+	cloud.m_velocity = velocity;
+	cloud.m_textureIndex = textureIndex;
+	cloud.m_billboardType = billboardType;
+
+	Texture* texture = m_textures[textureIndex];
+	if (texture)
+	{
+		cloud.m_dimensions = Vec2((float)texture->GetDimensions().x, (float)texture->GetDimensions().y) * CLOUD_TEXEL_SIZE;
+	}
+
+	m_clouds.push_back(cloud);
+}
+
+void CloudSystem::SortByTexture()
+{
+	std::stable_sort(m_clouds.begin(), m_clouds.end(), [](Cloud const& cloudA, Cloud const& cloudB)
+	{
+		return cloudA.m_textureIndex < cloudB.m_textureIndex;
+	});
+
+	for (int textureIndex = 0; textureIndex < NUM_CLOUD_TEXTURES; textureIndex++)
+	{
+		m_numCloudsWithTexture[textureIndex] = 0;
+	}
+	for (int cloudIndex = 0; cloudIndex < (int)m_clouds.size(); cloudIndex++)
+	{
+		m_numCloudsWithTexture[m_clouds[cloudIndex].m_textureIndex]++;
+	}
+
+	m_verts.reserve(m_clouds.size() * 6);
+}
+
+void CloudSystem::BuildVerts(Mat44 const& cameraModelMatrix, float timeSeconds)
+{
+	m_verts.clear();
+
+	// Camera-facing billboards share one orientation, so only the world-up billboards need a matrix per cloud
+	Mat44 fullFacingMatrix = GetBillboardMatrix(BillboardType::FULL_FACING, cameraModelMatrix, Vec3::ZERO);
+	Rgba8 const cloudColor = Rgba8(255, 255, 255, 127);
+
+	for (int cloudIndex = 0; cloudIndex < (int)m_clouds.size(); cloudIndex++)
+	{
+		Cloud const& cloud = m_clouds[cloudIndex];
+		Vec3 position = GetPosition(cloud, timeSeconds);
+
+		Vec3 left;
+		Vec3 up;
+		if (cloud.m_billboardType == BillboardType::FULL_FACING)
+		{
+			left = fullFacingMatrix.GetJBasis3D();
+			up = fullFacingMatrix.GetKBasis3D();
+		}
+		else
+		{
+			Mat44 billboardMatrix = GetBillboardMatrix(cloud.m_billboardType, cameraModelMatrix, position);
+			left = billboardMatrix.GetJBasis3D();
+			up = billboardMatrix.GetKBasis3D();
+		}
+
+		Vec3 width = left * cloud.m_dimensions.x;
+		Vec3 height = up * cloud.m_dimensions.y;
+		AddVertsForQuad3D(m_verts, position, position + width, position + width + height, position + height, cloudColor);
+	}
+}
+
+void CloudSystem::AddRenderCommands(RenderCommandList& commandList, Camera const& camera, float timeSeconds)
+{
+	m_numDrawCallsLastFrame = 0;
+	if (m_clouds.empty())
+	{
+		return;
+	}
+
+	BuildVerts(camera.GetModelMatrix(), timeSeconds);
+
+	size_t const vertexSize = sizeof(Vertex_PCU);
+	if (!m_vertexBuffer || m_vertexBufferSize < m_verts.size() * vertexSize)
+	{
+		DestroyBuffer(m_vertexBuffer);
+		m_vertexBufferSize = m_verts.size() * vertexSize;
+		m_vertexBuffer = g_renderBackend->CreateVertexBuffer(m_vertexBufferSize);
+	}
+
+	RenderCommand command;
+	command.m_state.m_pass = RenderPass::BACKGROUND;
+	command.m_state.m_blendMode = BlendMode::ALPHA;
+	command.m_state.m_cullMode = RasterizerCullMode::CULL_BACK;
+	command.m_vertexBuffer = m_vertexBuffer;
+	command.m_uploadVertexBuffer = m_vertexBuffer;
+
+	// Clouds are sorted by texture, so each texture is one contiguous run of the vertex array
+	int firstVertIndex = 0;
+	for (int textureIndex = 0; textureIndex < NUM_CLOUD_TEXTURES; textureIndex++)
+	{
+		int numVerts = m_numCloudsWithTexture[textureIndex] * 6;
+		if (numVerts == 0)
+		{
+			continue;
+		}
+
+		command.m_state.m_texture = m_textures[textureIndex];
+		command.m_count = numVerts;
+		command.m_uploadData = &m_verts[firstVertIndex];
+		command.m_uploadSize = numVerts * vertexSize;
+		commandList.AddCommand(command);
+		m_numDrawCallsLastFrame++;
+		firstVertIndex += numVerts;
+	}
+}
+
+Vec3 CloudSystem::GetPosition(Cloud const& cloud, float timeSeconds) const
+{
+	Vec3 position = cloud.m_startPosition + cloud.m_velocity * timeSeconds;
+
+	// Moving clouds wrap around to the opposite edge of the bounds along the axis they move on
+	Vec2 wrapDimensions = m_wrapMaxs - m_wrapMins;
+	if (cloud.m_velocity.x != 0.f)
+	{
+		float wrappedX = fmodf(position.x - m_wrapMins.x, wrapDimensions.x);
+		position.x = m_wrapMins.x + (wrappedX < 0.f ? wrappedX + wrapDimensions.x : wrappedX);
+	}
+	if (cloud.m_velocity.y != 0.f)
+	{
+		float wrappedY = fmodf(position.y - m_wrapMins.y, wrapDimensions.y);
+		position.y = m_wrapMins.y + (wrappedY < 0.f ? wrappedY + wrapDimensions.y : wrappedY);
+	}
+
+	return position;
+}
+
+int CloudSystem::GetNumClouds() const
+{
+	return (int)m_clouds.size();
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "Engine/Core/Vertex_PCU.hpp"
+#include "Engine/Math/Mat44.hpp"
+#include "Engine/Math/Vec2.hpp"
+#include "Engine/Math/Vec3.hpp"
+#include "Engine/Renderer/Renderer.hpp"
+
+#include <vector>
+
+class Camera;
+class RenderCommandList;
+class Texture;
+class VertexBuffer;
+
+
+struct Cloud
+{
+public:
+	Vec3 m_startPosition = Vec3::ZERO;
+	Vec3 m_velocity = Vec3::ZERO;
+	Vec2 m_dimensions = Vec2::ZERO;
+	int m_textureIndex = 0;
+	BillboardType m_billboardType = BillboardType::WORLD_UP_FACING;
+};
+
+
+// Owns the clouds around a map
+// Clouds never change speed, so their position is a function of time and wraps around the cloud bounds instead of being integrated every tick
+// Clouds are kept sorted by texture and all billboards are built in one pass, so the whole cloud layer takes at most one draw per texture
+class CloudSystem
+{
+public:
+	static constexpr int NUM_CLOUD_TEXTURES = 4;
+
+public:
+	~CloudSystem();
+	CloudSystem() = default;
+	explicit CloudSystem(Vec2 const& wrapMins, Vec2 const& wrapMaxs);
+
+	void AddCloud(Vec3 const& startPosition, Vec3 const& velocity, int textureIndex, BillboardType billboardType = BillboardType::WORLD_UP_FACING);
+	void SortByTexture();
+	void BuildVerts(Mat44 const& cameraModelMatrix, float timeSeconds);
+	void AddRenderCommands(RenderCommandList& commandList, Camera const& camera, float timeSeconds);
+
+	Vec3 GetPosition(Cloud const& cloud, float timeSeconds) const;
+	int GetNumClouds() const;
+
+public:
+	Texture* m_textures[NUM_CLOUD_TEXTURES] = {};
+	std::vector<Cloud> m_clouds;
+	int m_numCloudsWithTexture[NUM_CLOUD_TEXTURES] = {};
+	Vec2 m_wrapMins = Vec2::ZERO;
+	Vec2 m_wrapMaxs = Vec2::ZERO;
+
+	std::vector<Vertex_PCU> m_verts;
+	VertexBuffer* m_vertexBuffer = nullptr;
+	size_t m_vertexBufferSize = 0;
+	int m_numDrawCallsLastFrame = 0;
+};
@@ -0,0 +1,228 @@
+#include "Game/CookedMap.hpp"
+
+#include "Game/BlockDefinition.hpp"
+#include "Game/GameCommon.hpp"
+#include "Game/PackedMapVertex.hpp"
+
+#include "Engine/Core/FileUtils.hpp"
+
+#include <cstring>
+
+
+static void AppendBytes(std::vector<uint8_t>& buffer, void const* data, size_t numBytes)
+{
+	uint8_t const* bytes = reinterpret_cast<uint8_t const*>(data);
+	buffer.insert(buffer.end(), bytes, bytes + numBytes);
+}
+
+// Reads numBytes at readOffset and advances it, failing rather than reading past the end of a truncated file
+static bool ReadBytes(std::vector<uint8_t> const& buffer, size_t& readOffset, void* out_data, size_t numBytes)
+{
+	if (numBytes > buffer.size() - readOffset)
+	{
+		return false;
+	}
+
+	memcpy(out_data, buffer.data() + readOffset, numBytes);
+	readOffset += numBytes;
+	return true;
+}
+
+// Hands out a pointer to numBytes at readOffset and advances past them, so chunk data can be uploaded without copying it out of the file first
+static bool SkipBytes(std::vector<uint8_t> const& buffer, size_t& readOffset, uint8_t const*& out_data, size_t numBytes)
+{
+	if (numBytes > buffer.size() - readOffset)
+	{
+		return false;
+	}
+
+	out_data = buffer.data() + readOffset;
+	readOffset += numBytes;
+	return true;
+}
+
+// Every index has to name one of the chunk's vertexes, or the GPU would read past the end of the vertex buffer
+static bool AreIndexesInRange(uint8_t const* indexBytes, int numIndexes, int numVerts)
+{
+	for (int indexIndex = 0; indexIndex < numIndexes; indexIndex++)
+	{
+		unsigned int index = 0;
+		memcpy(&index, indexBytes + indexIndex * sizeof(unsigned int), sizeof(index));
+		if (index >= (unsigned int)numVerts)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool CookedMap::LoadFromFile(std::string const& filePath, uint32_t key)
+{
+	m_fileContents.clear();
+	m_chunkViews.clear();
+	std::vector<uint8_t>& fileContents = m_fileContents;
+	int bytesRead = FileReadToBuffer(fileContents, filePath);
+	if (bytesRead < 12)
+	{
+		return false;
+	}
+
+	if (fileContents[0] != 'R' || fileContents[1] != 'T' || fileContents[2] != 'D' || fileContents[3] != 'M')
+	{
+		return false;
+	}
+
+	size_t readOffset = 4;
+	uint32_t fileVersion = 0;
+	uint32_t fileKey = 0;
+	ReadBytes(fileContents, readOffset, &fileVersion, sizeof(fileVersion));
+	ReadBytes(fileContents, readOffset, &fileKey, sizeof(fileKey));
+	if (fileVersion != VERSION || fileKey != key)
+	{
+		return false;
+	}
+
+	bool isValid = ReadBytes(fileContents, readOffset, &m_dimensions, sizeof(m_dimensions));
+	isValid = isValid && m_dimensions.x > 0 && m_dimensions.y > 0 && m_dimensions.x <= MAX_DIMENSION && m_dimensions.y <= MAX_DIMENSION;
+	int numBlocks = isValid ? m_dimensions.x * m_dimensions.y : 0;
+	isValid = isValid && (size_t)numBlocks * (sizeof(uint8_t) + sizeof(float)) <= fileContents.size() - readOffset;
+	if (!isValid)
+	{
+		return false;
+	}
+
+	m_blockTypeIDs.resize(numBlocks);
+	m_heatValues.resize(numBlocks);
+	isValid = isValid && ReadBytes(fileContents, readOffset, m_blockTypeIDs.data(), m_blockTypeIDs.size() * sizeof(uint8_t));
+	isValid = isValid && ReadBytes(fileContents, readOffset, m_heatValues.data(), m_heatValues.size() * sizeof(float));
+
+	IntVec2 chunkGridDimensions = MapMesh::GetChunkGridDimensions(m_dimensions);
+	int numChunks = 0;
+	isValid = isValid && ReadBytes(fileContents, readOffset, &numChunks, sizeof(numChunks));
+	isValid = isValid && numChunks >= 0 && numChunks <= chunkGridDimensions.x * chunkGridDimensions.y;
+	m_chunks.clear();
+	m_chunkViews.resize(isValid ? numChunks : 0);
+	for (int chunkIndex = 0; chunkIndex < (int)m_chunkViews.size() && isValid; chunkIndex++)
+	{
+		CookedMapChunkView& chunk = m_chunkViews[chunkIndex];
+		uint8_t isPacked = 0;
+		int numVertexBytes = 0;
+		int numIndexes = 0;
+		isValid = isValid && ReadBytes(fileContents, readOffset, &chunk.m_chunkCoords, sizeof(chunk.m_chunkCoords));
+		isValid = isValid && ReadBytes(fileContents, readOffset, &chunk.m_bounds, sizeof(chunk.m_bounds));
+		isValid = isValid && ReadBytes(fileContents, readOffset, &isPacked, sizeof(isPacked));
+		isValid = isValid && ReadBytes(fileContents, readOffset, &chunk.m_numVerts, sizeof(chunk.m_numVerts));
+		isValid = isValid && ReadBytes(fileContents, readOffset, &numVertexBytes, sizeof(numVertexBytes));
+		isValid = isValid && ReadBytes(fileContents, readOffset, &numIndexes, sizeof(numIndexes));
+		if (!isValid)
+		{
+			break;
+		}
+
+		// The vertex bytes have to be exactly the vertex count at the stride the chunk is drawn with
+		chunk.m_isPacked = isPacked != 0;
+		size_t vertexStride = chunk.m_isPacked ? sizeof(Vertex_MapPacked) : sizeof(Vertex_PCUTBN);
+		isValid = chunk.m_numVerts > 0 && numVertexBytes >= 0 && (size_t)numVertexBytes == (size_t)chunk.m_numVerts * vertexStride;
+		isValid = isValid && numIndexes > 0 && numIndexes % 3 == 0;
+		isValid = isValid && chunk.m_chunkCoords.x >= 0 && chunk.m_chunkCoords.x < chunkGridDimensions.x && chunk.m_chunkCoords.y >= 0 && chunk.m_chunkCoords.y < chunkGridDimensions.y;
+		isValid = isValid && SkipBytes(fileContents, readOffset, chunk.m_vertexBytes, numVertexBytes);
+		isValid = isValid && SkipBytes(fileContents, readOffset, chunk.m_indexBytes, numIndexes * sizeof(unsigned int));
+		isValid = isValid && AreIndexesInRange(chunk.m_indexBytes, numIndexes, chunk.m_numVerts);
+		isValid = isValid && (!chunk.m_isPacked || AreMapVertexWordsNormal(chunk.m_vertexBytes, chunk.m_numVerts));
+		chunk.m_numVertexBytes = numVertexBytes;
+		chunk.m_numIndexes = numIndexes;
+	}
+
+	// Type IDs are only meaningful for the definitions they were cooked with; the key covers that, this guards against a corrupt file
+	// Type 0 is the invalid block only the border holds, so a map with it inside is cooked again rather than trusted
+	int numBlockTypes = (int)BlockDefinition::s_blockTypes.size();
+	for (int blockIndex = 0; blockIndex < numBlocks && isValid; blockIndex++)
+	{
+		int typeID = (int)m_blockTypeIDs[blockIndex];
+		isValid = typeID >= 1 && typeID < numBlockTypes;
+	}
+
+	isValid = isValid && readOffset == fileContents.size();
+	if (!isValid)
+	{
+		m_chunkViews.clear();
+	}
+	return isValid;
+}
+
+void CookedMap::SaveToFile(std::string const& filePath, uint32_t key) const
+{
+	std::vector<uint8_t> fileContents;
+	fileContents.push_back('R');
+	fileContents.push_back('T');
+	fileContents.push_back('D');
+	fileContents.push_back('M');
+	uint32_t version = VERSION;
+	AppendBytes(fileContents, &version, sizeof(version));
+	AppendBytes(fileContents, &key, sizeof(key));
+	AppendBytes(fileContents, &m_dimensions, sizeof(m_dimensions));
+	AppendBytes(fileContents, m_blockTypeIDs.data(), m_blockTypeIDs.size() * sizeof(uint8_t));
+	AppendBytes(fileContents, m_heatValues.data(), m_heatValues.size() * sizeof(float));
+
+	int numChunks = (int)m_chunks.size();
+	AppendBytes(fileContents, &numChunks, sizeof(numChunks));
+	for (int chunkIndex = 0; chunkIndex < numChunks; chunkIndex++)
+	{
+		CookedMapChunk const& chunk = m_chunks[chunkIndex];
+		uint8_t isPacked = chunk.m_isPacked ? 1 : 0;
+		int numVertexBytes = (int)chunk.m_vertexBytes.size();
+		int numIndexes = (int)chunk.m_indexes.size();
+		AppendBytes(fileContents, &chunk.m_chunkCoords, sizeof(chunk.m_chunkCoords));
+		AppendBytes(fileContents, &chunk.m_bounds, sizeof(chunk.m_bounds));
+		AppendBytes(fileContents, &isPacked, sizeof(isPacked));
+		AppendBytes(fileContents, &chunk.m_numVerts, sizeof(chunk.m_numVerts));
+		AppendBytes(fileContents, &numVertexBytes, sizeof(numVertexBytes));
+		AppendBytes(fileContents, &numIndexes, sizeof(numIndexes));
+		AppendBytes(fileContents, chunk.m_vertexBytes.data(), chunk.m_vertexBytes.size());
+		AppendBytes(fileContents, chunk.m_indexes.data(), chunk.m_indexes.size() * sizeof(unsigned int));
+	}
+
+	FileWriteBuffer(filePath, fileContents);
+}
+
+uint32_t CookedMap::ComputeKey(std::string const& mapImagePath, unsigned int decorationSeed, bool usePackedVerts)
+{
+	// Hashing the raw files is far cheaper than decoding the image, and catches any edit to any of them
+	std::vector<uint8_t> fileContents;
+	uint32_t key = FNV_OFFSET_BASIS;
+	FileReadToBuffer(fileContents, mapImagePath);
+	key = HashBytes(key, fileContents.data(), fileContents.size());
+	fileContents.clear();
+	FileReadToBuffer(fileContents, "Data/Definitions/BlockDefinitions.xml");
+	key = HashBytes(key, fileContents.data(), fileContents.size());
+
+	// The meshes are built from the block models, so an edited model or material has to invalidate the file as well
+	for (int typeID = 1; typeID < (int)BlockDefinition::s_blockTypes.size(); typeID++)
+	{
+		std::string const& modelPath = BlockDefinition::s_blockTypes[typeID]->m_modelPath;
+		if (modelPath.empty())
+		{
+			continue;
+		}
+
+		fileContents.clear();
+		FileReadToBuffer(fileContents, modelPath + ".obj");
+		key = HashBytes(key, fileContents.data(), fileContents.size());
+		fileContents.clear();
+		FileReadToBuffer(fileContents, modelPath + ".mtl");
+		key = HashBytes(key, fileContents.data(), fileContents.size());
+	}
+
+	uint8_t packedFlag = usePackedVerts ? 1 : 0;
+	int chunkSize = MapMesh::CHUNK_SIZE;
+	key = HashBytes(key, &decorationSeed, sizeof(decorationSeed));
+	key = HashBytes(key, &packedFlag, sizeof(packedFlag));
+	key = HashBytes(key, &chunkSize, sizeof(chunkSize));
+	return key;
+}
+
+std::string CookedMap::GetFilePath(std::string const& mapName)
+{
+	return Stringf("Saves/%s.rtdmap", mapName.c_str());
+}
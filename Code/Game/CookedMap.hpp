@@ -0,0 +1,42 @@
+#pragma once
+
+#include "Game/MapMesh.hpp"
+
+#include "Engine/Math/IntVec2.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+// Everything Map::Initialize derives from the map image, the block definitions and the decoration seed, stored in a versioned binary file
+// The key hashes all of those inputs, including the block model files, so editing any of them makes the cached file stale and the next load cooks it again
+class CookedMap
+{
+public:
+	// Bump whenever the file layout or anything that produces its contents changes, such as the mesher or the vertex packing
+	static constexpr uint32_t VERSION = 2;
+
+	// Far beyond any map image, and small enough that a corrupt header cannot overflow the block count
+	static constexpr int MAX_DIMENSION = 4096;
+
+public:
+	~CookedMap() = default;
+	CookedMap() = default;
+
+	bool LoadFromFile(std::string const& filePath, uint32_t key);
+	void SaveToFile(std::string const& filePath, uint32_t key) const;
+
+	static uint32_t ComputeKey(std::string const& mapImagePath, unsigned int decorationSeed, bool usePackedVerts);
+	static std::string GetFilePath(std::string const& mapName);
+
+public:
+	IntVec2 m_dimensions = IntVec2::ZERO;
+	std::vector<uint8_t> m_blockTypeIDs;
+	std::vector<float> m_heatValues;
+	std::vector<CookedMapChunk> m_chunks;
+
+	// What the mesh uploads: views into m_chunks once they are cooked, or straight into m_fileContents once a file is loaded
+	std::vector<CookedMapChunkView> m_chunkViews;
+	std::vector<uint8_t> m_fileContents;
+};
@@ -1,11 +1,11 @@
 #include "Game/EnemyDefinition.hpp"
 
-#include "Game/GameCommon.hpp"
+#include "Game/AssetBackend.hpp"
+#include "Game/StatusEffects.hpp"
 
 #include "Engine/Core/ErrorWarningAssert.hpp"
 #include "Engine/Math/Mat44.hpp"
 #include "Engine/Math/MathUtils.hpp"
-#include "Engine/Renderer/Texture.hpp"
 
 
 std::map<std::string, EnemyDefinition> EnemyDefinition::s_enemyDefs;
@@ -40,6 +40,9 @@ EnemyDefinition::EnemyDefinition(XmlElement const* element)
 	m_immuneToBurn = ParseXmlAttribute(*element, "immuneToBurn", m_immuneToBurn);
 	m_immuneToSlow = ParseXmlAttribute(*element, "immuneToSlow", m_immuneToSlow);
 	m_immuneToPoison = ParseXmlAttribute(*element, "immuneToPoison", m_immuneToPoison);
+	m_statusEffectImmunityFlags |= m_immuneToBurn ? GetStatusEffectFlag(StatusEffectType::BURN) : 0u;
+	m_statusEffectImmunityFlags |= m_immuneToSlow ? GetStatusEffectFlag(StatusEffectType::FREEZE) : 0u;
+	m_statusEffectImmunityFlags |= m_immuneToPoison ? GetStatusEffectFlag(StatusEffectType::POISON) : 0u;
 	m_moneyMultiplier = ParseXmlAttribute(*element, "moneyMultiplier", m_moneyMultiplier);
 	m_damageMultiplier = ParseXmlAttribute(*element, "damageMultiplier", m_damageMultiplier);
 	m_slowMultiplier = ParseXmlAttribute(*element, "slowMultiplier", m_slowMultiplier);
@@ -55,13 +58,13 @@ EnemyDefinition::EnemyDefinition(XmlElement const* element)
 	std::string textureName = ParseXmlAttribute(*element, "texture", "");
 	if (!textureName.empty())
 	{
-		m_diffuseTexture = g_renderer->CreateOrGetTextureFromFile(textureName.c_str());
+		m_diffuseTexture = g_assetBackend->CreateOrGetTexture(textureName);
 	}
 
 	std::string modelName = ParseXmlAttribute(*element, "model", "");
 	if (!modelName.empty())
 	{
-		m_model = g_modelLoader->CreateOrGetModelFromObj(modelName.c_str(), modelTransformMatrix);
+		m_model = g_assetBackend->CreateOrGetModel(modelName, modelTransformMatrix);
 	}
 }
 
@@ -1,11 +1,13 @@
 #pragma once
 
-#include "Engine/Core/Models/Model.hpp"
 #include "Engine/Core/XMLUtils.hpp"
 
 #include <map>
 #include <string>
 
+class Model;
+class Texture;
+
 class EnemyDefinition
 {
 public:
@@ -16,6 +18,7 @@ public:
 	bool m_immuneToBurn = false;
 	bool m_immuneToSlow = false;
 	bool m_immuneToPoison = false;
+	unsigned int m_statusEffectImmunityFlags = 0;
 	Model* m_model = nullptr;
 	Texture* m_diffuseTexture = nullptr;
 	int m_moneyMultiplier = 1;
@@ -0,0 +1,216 @@
+#include "Game/EnemySimData.hpp"
+
+#include "Game/Enemy.hpp"
+
+#include "Engine/Math/MathUtils.hpp"
+
+#include <emmintrin.h>
+
+
+// Parabolic sine approximation (max error ~0.001) evaluated on 4 lanes, accurate enough for the bobbing animation
+static __m128 SinRadians4(__m128 radians)
+{
+	__m128 const twoPi = _mm_set1_ps(6.28318531f);
+	__m128 const invTwoPi = _mm_set1_ps(0.159154943f);
+	__m128 const signMask = _mm_set1_ps(-0.f);
+
+	// Wrap into [-pi, pi]
+	__m128 numTurns = _mm_cvtepi32_ps(_mm_cvtps_epi32(_mm_mul_ps(radians, invTwoPi)));
+	__m128 x = _mm_sub_ps(radians, _mm_mul_ps(numTurns, twoPi));
+
+	__m128 absX = _mm_andnot_ps(signMask, x);
+	__m128 y = _mm_sub_ps(_mm_mul_ps(_mm_set1_ps(1.27323954f), x), _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(0.405284735f), x), absX));
+	__m128 absY = _mm_andnot_ps(signMask, y);
+	y = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(0.225f), _mm_sub_ps(_mm_mul_ps(y, absY), y)), y);
+	return y;
+}
+
+static __m128 Select4(__m128 mask, __m128 ifTrue, __m128 ifFalse)
+{
+	return _mm_or_ps(_mm_and_ps(mask, ifTrue), _mm_andnot_ps(mask, ifFalse));
+}
+
+int EnemySimData::AddEnemy(Enemy* enemy, Vec3 const& position, float yawDegrees, float speed, float turnSpeed, float health, float bobFrequency)
+{
+	int simIndex = m_numEnemies;
+	if (simIndex >= (int)m_enemies.size())
+	{
+		ResizeLanes((int)m_enemies.size() + SIMD_WIDTH);
+	}
+	m_numEnemies++;
+
+	m_enemies[simIndex] = enemy;
+	m_positionX[simIndex] = position.x;
+	m_positionY[simIndex] = position.y;
+	m_positionZ[simIndex] = position.z;
+	m_yawDegrees[simIndex] = yawDegrees;
+	m_goalX[simIndex] = position.x;
+	m_goalY[simIndex] = position.y;
+	m_goalYawDegrees[simIndex] = yawDegrees;
+	m_speed[simIndex] = speed;
+	m_turnSpeed[simIndex] = turnSpeed;
+	m_health[simIndex] = health;
+	m_timeSinceSpawn[simIndex] = 0.f;
+	m_bobFrequency[simIndex] = bobFrequency;
+	m_isActive[simIndex] = 1.f;
+
+	return simIndex;
+}
+
+void EnemySimData::RemoveEnemy(int simIndex)
+{
+	int lastSimIndex = m_numEnemies - 1;
+	if (simIndex != lastSimIndex)
+	{
+		m_enemies[simIndex] = m_enemies[lastSimIndex];
+		m_positionX[simIndex] = m_positionX[lastSimIndex];
+		m_positionY[simIndex] = m_positionY[lastSimIndex];
+		m_positionZ[simIndex] = m_positionZ[lastSimIndex];
+		m_yawDegrees[simIndex] = m_yawDegrees[lastSimIndex];
+		m_goalX[simIndex] = m_goalX[lastSimIndex];
+		m_goalY[simIndex] = m_goalY[lastSimIndex];
+		m_goalYawDegrees[simIndex] = m_goalYawDegrees[lastSimIndex];
+		m_speed[simIndex] = m_speed[lastSimIndex];
+		m_turnSpeed[simIndex] = m_turnSpeed[lastSimIndex];
+		m_health[simIndex] = m_health[lastSimIndex];
+		m_timeSinceSpawn[simIndex] = m_timeSinceSpawn[lastSimIndex];
+		m_bobFrequency[simIndex] = m_bobFrequency[lastSimIndex];
+		m_isActive[simIndex] = m_isActive[lastSimIndex];
+		m_enemies[simIndex]->m_simIndex = simIndex;
+	}
+
+	ResetLane(lastSimIndex);
+	m_numEnemies--;
+}
+
+void EnemySimData::Clear()
+{
+	for (int simIndex = 0; simIndex < m_numEnemies; simIndex++)
+	{
+		ResetLane(simIndex);
+	}
+	m_numEnemies = 0;
+}
+
+void EnemySimData::SetGoal(int simIndex, Vec2 const& goal)
+{
+	m_goalX[simIndex] = goal.x;
+	m_goalY[simIndex] = goal.y;
+
+	// Enemies walk in a straight line to their goal, so the direction only changes when the goal does
+	Vec2 displacementToGoal = goal - Vec2(m_positionX[simIndex], m_positionY[simIndex]);
+	if (displacementToGoal.GetLengthSquared() > 0.f)
+	{
+		m_goalYawDegrees[simIndex] = displacementToGoal.GetOrientationDegrees();
+	}
+}
+
+void EnemySimData::Deactivate(int simIndex)
+{
+	m_isActive[simIndex] = 0.f;
+}
+
+bool EnemySimData::IsGoalReached(int simIndex) const
+{
+	return GetDistance2D(Vec2(m_positionX[simIndex], m_positionY[simIndex]), Vec2(m_goalX[simIndex], m_goalY[simIndex])) < GOAL_REACHED_DISTANCE;
+}
+
+void EnemySimData::UpdateMovement(float deltaSeconds)
+{
+	UpdateMovement(deltaSeconds, 0, m_numEnemies);
+}
+
+// Lanes are independent, so disjoint ranges can be updated on different threads; firstSimIndex must be a multiple of SIMD_WIDTH
+void EnemySimData::UpdateMovement(float deltaSeconds, int firstSimIndex, int endSimIndex)
+{
+	__m128 const deltaSeconds4 = _mm_set1_ps(deltaSeconds);
+	__m128 const goalReachedDistanceSq4 = _mm_set1_ps(GOAL_REACHED_DISTANCE * GOAL_REACHED_DISTANCE);
+	__m128 const zero4 = _mm_setzero_ps();
+	__m128 const fullTurn4 = _mm_set1_ps(360.f);
+	__m128 const invFullTurn4 = _mm_set1_ps(1.f / 360.f);
+	__m128 const bobBase4 = _mm_set1_ps(0.02f);
+	__m128 const bobAmplitude4 = _mm_set1_ps(0.05f);
+
+	for (int laneStart = firstSimIndex; laneStart < endSimIndex; laneStart += SIMD_WIDTH)
+	{
+		__m128 timeSinceSpawn = _mm_add_ps(_mm_loadu_ps(&m_timeSinceSpawn[laneStart]), deltaSeconds4);
+		_mm_storeu_ps(&m_timeSinceSpawn[laneStart], timeSinceSpawn);
+
+		__m128 isActive = _mm_cmpgt_ps(_mm_loadu_ps(&m_isActive[laneStart]), zero4);
+		__m128 positionX = _mm_loadu_ps(&m_positionX[laneStart]);
+		__m128 positionY = _mm_loadu_ps(&m_positionY[laneStart]);
+		__m128 displacementX = _mm_sub_ps(_mm_loadu_ps(&m_goalX[laneStart]), positionX);
+		__m128 displacementY = _mm_sub_ps(_mm_loadu_ps(&m_goalY[laneStart]), positionY);
+		__m128 distanceSq = _mm_add_ps(_mm_mul_ps(displacementX, displacementX), _mm_mul_ps(displacementY, displacementY));
+		__m128 isMoving = _mm_and_ps(isActive, _mm_cmpge_ps(distanceSq, goalReachedDistanceSq4));
+
+		// Move along the normalized direction to the goal
+		__m128 distance = _mm_sqrt_ps(_mm_max_ps(distanceSq, goalReachedDistanceSq4));
+		__m128 stepOverDistance = _mm_div_ps(_mm_mul_ps(_mm_loadu_ps(&m_speed[laneStart]), deltaSeconds4), distance);
+		positionX = Select4(isMoving, _mm_add_ps(positionX, _mm_mul_ps(displacementX, stepOverDistance)), positionX);
+		positionY = Select4(isMoving, _mm_add_ps(positionY, _mm_mul_ps(displacementY, stepOverDistance)), positionY);
+		_mm_storeu_ps(&m_positionX[laneStart], positionX);
+		_mm_storeu_ps(&m_positionY[laneStart], positionY);
+
+		// Turn toward the goal by the shortest angular displacement, clamped to the turn speed
+		__m128 yawDegrees = _mm_loadu_ps(&m_yawDegrees[laneStart]);
+		__m128 angularDisp = _mm_sub_ps(_mm_loadu_ps(&m_goalYawDegrees[laneStart]), yawDegrees);
+		angularDisp = _mm_sub_ps(angularDisp, _mm_mul_ps(_mm_cvtepi32_ps(_mm_cvtps_epi32(_mm_mul_ps(angularDisp, invFullTurn4))), fullTurn4));
+		__m128 maxTurnDegrees = _mm_mul_ps(_mm_loadu_ps(&m_turnSpeed[laneStart]), deltaSeconds4);
+		__m128 turnDegrees = _mm_min_ps(_mm_max_ps(angularDisp, _mm_sub_ps(zero4, maxTurnDegrees)), maxTurnDegrees);
+		_mm_storeu_ps(&m_yawDegrees[laneStart], Select4(isMoving, _mm_add_ps(yawDegrees, turnDegrees), yawDegrees));
+
+		// Bob up and down while alive
+		__m128 bobPhase = _mm_mul_ps(_mm_loadu_ps(&m_bobFrequency[laneStart]), timeSinceSpawn);
+		__m128 positionZ = _mm_add_ps(bobBase4, _mm_mul_ps(bobAmplitude4, SinRadians4(bobPhase)));
+		_mm_storeu_ps(&m_positionZ[laneStart], Select4(isActive, positionZ, _mm_loadu_ps(&m_positionZ[laneStart])));
+	}
+}
+
+Vec3 EnemySimData::GetPosition(int simIndex) const
+{
+	return Vec3(m_positionX[simIndex], m_positionY[simIndex], m_positionZ[simIndex]);
+}
+
+void EnemySimData::SetPosition(int simIndex, Vec3 const& position)
+{
+	m_positionX[simIndex] = position.x;
+	m_positionY[simIndex] = position.y;
+	m_positionZ[simIndex] = position.z;
+}
+
+void EnemySimData::ResizeLanes(int numLanes)
+{
+	m_enemies.resize(numLanes, nullptr);
+	m_positionX.resize(numLanes, 0.f);
+	m_positionY.resize(numLanes, 0.f);
+	m_positionZ.resize(numLanes, 0.f);
+	m_yawDegrees.resize(numLanes, 0.f);
+	m_goalX.resize(numLanes, 0.f);
+	m_goalY.resize(numLanes, 0.f);
+	m_goalYawDegrees.resize(numLanes, 0.f);
+	m_speed.resize(numLanes, 0.f);
+	m_turnSpeed.resize(numLanes, 0.f);
+	m_health.resize(numLanes, 0.f);
+	m_timeSinceSpawn.resize(numLanes, 0.f);
+	m_bobFrequency.resize(numLanes, 0.f);
+	m_isActive.resize(numLanes, 0.f);
+}
+
+void EnemySimData::ResetLane(int simIndex)
+{
+	m_enemies[simIndex] = nullptr;
+	m_positionX[simIndex] = 0.f;
+	m_positionY[simIndex] = 0.f;
+	m_positionZ[simIndex] = 0.f;
+	m_yawDegrees[simIndex] = 0.f;
+	m_goalX[simIndex] = 0.f;
+	m_goalY[simIndex] = 0.f;
+	m_goalYawDegrees[simIndex] = 0.f;
+	m_speed[simIndex] = 0.f;
+	m_turnSpeed[simIndex] = 0.f;
+	m_health[simIndex] = 0.f;
+	m_timeSinceSpawn[simIndex] = 0.f;
+	m_bobFrequency[simIndex] = 0.f;
+	m_isActive[simIndex] = 0.f;
+}
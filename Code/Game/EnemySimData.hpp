@@ -0,0 +1,54 @@
+#pragma once
+
+#include "Engine/Math/Vec2.hpp"
+#include "Engine/Math/Vec3.hpp"
+
+#include <vector>
+
+class Enemy;
+
+
+// Hot per-enemy simulation state stored as parallel arrays so movement, turning and bobbing can run 4 enemies at a time
+// Arrays are padded to a multiple of 4 lanes; unused lanes are inactive and never move
+struct EnemySimData
+{
+public:
+	static constexpr int SIMD_WIDTH = 4;
+	static constexpr float GOAL_REACHED_DISTANCE = 0.1f;
+
+public:
+	int AddEnemy(Enemy* enemy, Vec3 const& position, float yawDegrees, float speed, float turnSpeed, float health, float bobFrequency);
+	void RemoveEnemy(int simIndex);
+	void Clear();
+
+	void SetGoal(int simIndex, Vec2 const& goal);
+	void Deactivate(int simIndex);
+	bool IsGoalReached(int simIndex) const;
+
+	void UpdateMovement(float deltaSeconds);
+	void UpdateMovement(float deltaSeconds, int firstSimIndex, int endSimIndex);
+
+	Vec3 GetPosition(int simIndex) const;
+	void SetPosition(int simIndex, Vec3 const& position);
+
+public:
+	int m_numEnemies = 0;
+	std::vector<Enemy*> m_enemies;
+	std::vector<float> m_positionX;
+	std::vector<float> m_positionY;
+	std::vector<float> m_positionZ;
+	std::vector<float> m_yawDegrees;
+	std::vector<float> m_goalX;
+	std::vector<float> m_goalY;
+	std::vector<float> m_goalYawDegrees;
+	std::vector<float> m_speed;
+	std::vector<float> m_turnSpeed;
+	std::vector<float> m_health;
+	std::vector<float> m_timeSinceSpawn;
+	std::vector<float> m_bobFrequency;
+	std::vector<float> m_isActive;
+
+private:
+	void ResizeLanes(int numLanes);
+	void ResetLane(int simIndex);
+};
@@ -0,0 +1,113 @@
+#include "Game/EnemySlotMap.hpp"
+
+
+bool EnemyHandle::IsValid() const
+{
+	return m_slotIndex >= 0;
+}
+
+bool EnemyHandle::operator==(EnemyHandle const& compare) const
+{
+	return m_slotIndex == compare.m_slotIndex && m_generation == compare.m_generation;
+}
+
+bool EnemyHandle::operator!=(EnemyHandle const& compare) const
+{
+	return !(*this == compare);
+}
+
+EnemyHandle EnemySlotMap::Add(Enemy* enemy)
+{
+	int slotIndex = -1;
+	if (!m_freeSlotIndexes.empty())
+	{
+		slotIndex = m_freeSlotIndexes.back();
+		m_freeSlotIndexes.pop_back();
+	}
+	else
+	{
+		slotIndex = (int)m_slots.size();
+		m_slots.push_back(Slot());
+	}
+
+	Slot& slot = m_slots[slotIndex];
+	slot.m_denseIndex = (int)m_denseEnemies.size();
+	m_denseEnemies.push_back(enemy);
+	m_denseToSlotIndex.push_back(slotIndex);
+
+	EnemyHandle handle;
+	handle.m_slotIndex = slotIndex;
+	handle.m_generation = slot.m_generation;
+	return handle;
+}
+
+void EnemySlotMap::Remove(EnemyHandle const& handle)
+{
+	if (!Get(handle))
+	{
+		return;
+	}
+
+	Slot& slot = m_slots[handle.m_slotIndex];
+	int denseIndex = slot.m_denseIndex;
+	int lastDenseIndex = (int)m_denseEnemies.size() - 1;
+
+	m_denseEnemies[denseIndex] = m_denseEnemies[lastDenseIndex];
+	m_denseToSlotIndex[denseIndex] = m_denseToSlotIndex[lastDenseIndex];
+	m_slots[m_denseToSlotIndex[denseIndex]].m_denseIndex = denseIndex;
+	m_denseEnemies.pop_back();
+	m_denseToSlotIndex.pop_back();
+
+	// Bumping the generation invalidates every handle still pointing at this slot
+	slot.m_denseIndex = -1;
+	slot.m_generation++;
+	m_freeSlotIndexes.push_back(handle.m_slotIndex);
+}
+
+void EnemySlotMap::Clear()
+{
+	for (int slotIndex = 0; slotIndex < (int)m_slots.size(); slotIndex++)
+	{
+		Slot& slot = m_slots[slotIndex];
+		if (slot.m_denseIndex >= 0)
+		{
+			slot.m_denseIndex = -1;
+			slot.m_generation++;
+			m_freeSlotIndexes.push_back(slotIndex);
+		}
+	}
+
+	m_denseEnemies.clear();
+	m_denseToSlotIndex.clear();
+}
+
+Enemy* EnemySlotMap::Get(EnemyHandle const& handle) const
+{
+	if (handle.m_slotIndex < 0 || handle.m_slotIndex >= (int)m_slots.size())
+	{
+		return nullptr;
+	}
+
+	Slot const& slot = m_slots[handle.m_slotIndex];
+	if (slot.m_generation != handle.m_generation || slot.m_denseIndex < 0)
+	{
+		return nullptr;
+	}
+
+	return m_denseEnemies[slot.m_denseIndex];
+}
+
+int EnemySlotMap::GetCount() const
+{
+	return (int)m_denseEnemies.size();
+}
+
+bool EnemySlotMap::IsEmpty() const
+{
+	return m_denseEnemies.empty();
+}
+
+Enemy* EnemySlotMap::operator[](int denseIndex) const
+{
+	return m_denseEnemies[denseIndex];
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <vector>
+
+class Enemy;
+
+
+// Weak reference to an enemy that resolves to nullptr once the enemy has been removed, even if its slot gets reused
+struct EnemyHandle
+{
+public:
+	int m_slotIndex = -1;
+	unsigned int m_generation = 0;
+
+public:
+	bool IsValid() const;
+	bool operator==(EnemyHandle const& compare) const;
+	bool operator!=(EnemyHandle const& compare) const;
+};
+
+
+// Generational slot map owning the enemies of a map
+// Enemies are kept densely packed for iteration; removal swaps the last enemy into the hole so it is O(1)
+class EnemySlotMap
+{
+public:
+	~EnemySlotMap() = default;
+	EnemySlotMap() = default;
+
+	EnemyHandle Add(Enemy* enemy);
+	void Remove(EnemyHandle const& handle);
+	void Clear();
+
+	Enemy* Get(EnemyHandle const& handle) const;
+	int GetCount() const;
+	bool IsEmpty() const;
+	Enemy* operator[](int denseIndex) const;
+
+public:
+	struct Slot
+	{
+		int m_denseIndex = -1;
+		unsigned int m_generation = 0;
+	};
+
+	std::vector<Enemy*> m_denseEnemies;
+	std::vector<int> m_denseToSlotIndex;
+	std::vector<Slot> m_slots;
+	std::vector<int> m_freeSlotIndexes;
+};
@@ -0,0 +1,86 @@
+#include "Game/EnemySpatialGrid.hpp"
+
+#include "Game/Enemy.hpp"
+
+#include "Engine/Math/MathUtils.hpp"
+
+
+EnemySpatialGrid::EnemySpatialGrid(IntVec2 const& dimensions)
+	: m_dimensions(dimensions)
+{
+	m_cells.resize(m_dimensions.x * m_dimensions.y);
+}
+
+int EnemySpatialGrid::GetCellIndexForPoint(Vec2 const& point) const
+{
+	// Enemies walking off the edge of the map (start and end blocks are on the border) stay in the border cells
+	int cellX = GetClamped(RoundDownToInt(point.x), 0, m_dimensions.x - 1);
+	int cellY = GetClamped(RoundDownToInt(point.y), 0, m_dimensions.y - 1);
+	return cellX + cellY * m_dimensions.x;
+}
+
+IntVec2 EnemySpatialGrid::GetCellCoordsFromIndex(int cellIndex) const
+{
+	return IntVec2(cellIndex % m_dimensions.x, cellIndex / m_dimensions.x);
+}
+
+void EnemySpatialGrid::AddEnemy(Enemy* enemy)
+{
+	int cellIndex = GetCellIndexForPoint(enemy->GetPosition().GetXY());
+	std::vector<Enemy*>& cell = m_cells[cellIndex];
+	enemy->m_spatialCellIndex = cellIndex;
+	enemy->m_indexInSpatialCell = (int)cell.size();
+	cell.push_back(enemy);
+	m_numEnemies++;
+}
+
+void EnemySpatialGrid::RemoveEnemy(Enemy* enemy)
+{
+	if (enemy->m_spatialCellIndex < 0)
+	{
+		return;
+	}
+
+	std::vector<Enemy*>& cell = m_cells[enemy->m_spatialCellIndex];
+	Enemy* lastEnemyInCell = cell.back();
+	cell[enemy->m_indexInSpatialCell] = lastEnemyInCell;
+	lastEnemyInCell->m_indexInSpatialCell = enemy->m_indexInSpatialCell;
+	cell.pop_back();
+
+	enemy->m_spatialCellIndex = -1;
+	enemy->m_indexInSpatialCell = -1;
+	m_numEnemies--;
+}
+
+void EnemySpatialGrid::UpdateEnemy(Enemy* enemy)
+{
+	if (enemy->m_spatialCellIndex == GetCellIndexForPoint(enemy->GetPosition().GetXY()))
+	{
+		return;
+	}
+
+	RemoveEnemy(enemy);
+	AddEnemy(enemy);
+}
+
+void EnemySpatialGrid::Clear()
+{
+	for (int cellIndex = 0; cellIndex < (int)m_cells.size(); cellIndex++)
+	{
+		m_cells[cellIndex].clear();
+	}
+	m_numEnemies = 0;
+}
+
+void EnemySpatialGrid::GetCellBoundsForDisc(Vec2 const& discCenter, float discRadius, IntVec2& out_mins, IntVec2& out_maxs) const
+{
+	out_mins.x = GetClamped(RoundDownToInt(discCenter.x - discRadius), 0, m_dimensions.x - 1);
+	out_mins.y = GetClamped(RoundDownToInt(discCenter.y - discRadius), 0, m_dimensions.y - 1);
+	out_maxs.x = GetClamped(RoundDownToInt(discCenter.x + discRadius), 0, m_dimensions.x - 1);
+	out_maxs.y = GetClamped(RoundDownToInt(discCenter.y + discRadius), 0, m_dimensions.y - 1);
+}
+
+std::vector<Enemy*> const& EnemySpatialGrid::GetEnemiesInCell(int cellX, int cellY) const
+{
+	return m_cells[cellX + cellY * m_dimensions.x];
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "Engine/Math/IntVec2.hpp"
+#include "Engine/Math/Vec2.hpp"
+
+#include <vector>
+
+class Enemy;
+
+
+// Buckets enemies by the block they are standing on so range queries only visit nearby blocks
+class EnemySpatialGrid
+{
+public:
+	~EnemySpatialGrid() = default;
+	EnemySpatialGrid() = default;
+	explicit EnemySpatialGrid(IntVec2 const& dimensions);
+
+	int GetCellIndexForPoint(Vec2 const& point) const;
+	IntVec2 GetCellCoordsFromIndex(int cellIndex) const;
+
+	void AddEnemy(Enemy* enemy);
+	void RemoveEnemy(Enemy* enemy);
+	void UpdateEnemy(Enemy* enemy);
+	void Clear();
+
+	void GetCellBoundsForDisc(Vec2 const& discCenter, float discRadius, IntVec2& out_mins, IntVec2& out_maxs) const;
+	std::vector<Enemy*> const& GetEnemiesInCell(int cellX, int cellY) const;
+
+public:
+	IntVec2 m_dimensions = IntVec2::ZERO;
+	std::vector<std::vector<Enemy*>> m_cells;
+	int m_numEnemies = 0;
+};
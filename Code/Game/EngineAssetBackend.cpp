@@ -0,0 +1,27 @@
+#include "Game/AssetBackend.hpp"
+
+#include "Game/GameCommon.hpp"
+
+#include "Engine/Core/Models/CPUMesh.hpp"
+#include "Engine/Core/Models/Model.hpp"
+
+
+Model* EngineAssetBackend::CreateOrGetModel(std::string const& filePath, Mat44 const& transform)
+{
+	return g_modelLoader->CreateOrGetModelFromObj(filePath.c_str(), transform);
+}
+
+std::vector<Vertex_PCUTBN> const* EngineAssetBackend::GetModelVertexes(Model const* model)
+{
+	return model ? &model->m_cpuMesh->m_vertexes : nullptr;
+}
+
+Texture* EngineAssetBackend::CreateOrGetTexture(std::string const& filePath)
+{
+	return g_renderer->CreateOrGetTextureFromFile(filePath.c_str());
+}
+
+Shader* EngineAssetBackend::CreateOrGetShader(std::string const& shaderName, bool hasPackedVertexes)
+{
+	return g_renderer->CreateOrGetShader(shaderName.c_str(), hasPackedVertexes ? VertexType::VERTEX_PCU : VertexType::VERTEX_PCUTBN);
+}
@@ -0,0 +1,60 @@
+#include "Game/FixedStepTimer.hpp"
+
+
+FixedStepTimer::FixedStepTimer(float duration)
+	: m_duration(duration)
+{
+}
+
+void FixedStepTimer::Start()
+{
+	m_elapsedTime = 0.f;
+	m_isStopped = false;
+}
+
+void FixedStepTimer::Stop()
+{
+	m_elapsedTime = 0.f;
+	m_isStopped = true;
+}
+
+void FixedStepTimer::Advance(float deltaSeconds)
+{
+	if (m_isStopped)
+	{
+		return;
+	}
+
+	m_elapsedTime += deltaSeconds;
+}
+
+bool FixedStepTimer::IsStopped() const
+{
+	return m_isStopped;
+}
+
+bool FixedStepTimer::HasDurationElapsed() const
+{
+	return !m_isStopped && m_elapsedTime >= m_duration;
+}
+
+bool FixedStepTimer::DecrementDurationIfElapsed()
+{
+	if (!HasDurationElapsed())
+	{
+		return false;
+	}
+
+	m_elapsedTime -= m_duration;
+	return true;
+}
+
+float FixedStepTimer::GetElapsedFraction() const
+{
+	if (m_isStopped || m_duration == 0.f)
+	{
+		return 0.f;
+	}
+
+	return m_elapsedTime / m_duration;
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+
+// Stopwatch-like timer that only advances when the owner steps it, so gameplay timers
+// follow the fixed simulation step instead of reading time from a Clock
+struct FixedStepTimer
+{
+public:
+	float m_duration = 0.f;
+	float m_elapsedTime = 0.f;
+	bool m_isStopped = true;
+
+public:
+	~FixedStepTimer() = default;
+	FixedStepTimer() = default;
+	explicit FixedStepTimer(float duration);
+
+	void Start();
+	void Stop();
+	void Advance(float deltaSeconds);
+
+	bool IsStopped() const;
+	bool HasDurationElapsed() const;
+	bool DecrementDurationIfElapsed();
+	float GetElapsedFraction() const;
+};
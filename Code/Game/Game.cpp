@@ -5,15 +5,24 @@
 #include "UI/UISlider.hpp"
 
 #include "Game/App.hpp"
+#include "Game/Benchmarks.hpp"
 #include "Game/GameCommon.hpp"
+#include "Game/HealthBarRenderer.hpp"
+#include "Game/InstancedModelRenderer.hpp"
+#include "Game/JobSystem.hpp"
 #include "Game/BlockDefinition.hpp"
+#include "Game/CloudSystem.hpp"
 #include "Game/TowerDefinition.hpp"
 #include "Game/EnemyDefinition.hpp"
 #include "Game/Map.hpp"
+#include "Game/MapMesh.hpp"
+#include "Game/ParticleSystem.hpp"
+#include "Game/SimulationScript.hpp"
 #include "Game/Tower.hpp"
 
 #include "Engine/Core/DevConsole.hpp"
 #include "Engine/Core/FileUtils.hpp"
+#include "Engine/Core/Models/Model.hpp"
 #include "Engine/Math/Plane3.hpp"
 #include "Engine/Math/RaycastUtils.hpp"
 #include "Engine/Renderer/BitmapFont.hpp"
@@ -58,22 +67,68 @@ bool Game::Event_GameClock(EventArgs& args)
 	return true;
 }
 
+bool Game::Event_SimulateLevel(EventArgs& args)
+{
+	bool isHelp = args.GetValue("help", false);
+	if (isHelp)
+	{
+		g_console->AddLine("Runs a scripted level without rendering or audio and reports the outcome", false);
+		g_console->AddLine("Parameters", false);
+		g_console->AddLine(Stringf("\t\t%-20s: [string] path to a simulation script XML file", "script"), false);
+		g_console->AddLine(Stringf("\t\t%-20s: [string] overrides the map named in the script", "map"), false);
+		return true;
+	}
+
+	std::string scriptPath = args.GetValue("script", "Data/Simulations/Level1.xml");
+	XmlDocument scriptXmlFile;
+	XmlResult fileLoadResult = scriptXmlFile.LoadFile(scriptPath.c_str());
+	if (fileLoadResult != XmlResult::XML_SUCCESS)
+	{
+		g_console->AddLine(Rgba8::RED, Stringf("Could not find or open simulation script \"%s\"", scriptPath.c_str()));
+		return false;
+	}
+
+	SimulationScript script(scriptXmlFile.RootElement());
+	script.m_mapName = args.GetValue("map", script.m_mapName);
+
+	SimulationResult result = script.Run(g_app->m_game->m_jobSystem);
+	if (result.m_outcome == SimulationOutcome::INVALID)
+	{
+		g_console->AddLine(Rgba8::RED, Stringf("Could not simulate unknown map \"%s\"", script.m_mapName.c_str()));
+		return false;
+	}
+
+	double ticksPerSecond = result.m_wallSeconds > 0.0 ? (double)result.m_numTicks / result.m_wallSeconds : 0.0;
+	g_console->AddLine(Rgba8::GREEN, Stringf("%s: %s after %.2fs simulated (%d ticks)", script.m_mapName.c_str(), SimulationScript::GetOutcomeName(result.m_outcome), result.m_simulatedSeconds, result.m_numTicks));
+	g_console->AddLine(Rgba8::WHITE, Stringf("Lives: %d, Money: %d, Score: %d, Stars: %d, Towers placed: %d", result.m_remainingLives, result.m_money, result.m_score, result.m_stars, result.m_numTowersPlaced));
+	g_console->AddLine(Rgba8::WHITE, Stringf("Wall time: %.3fms, %.0f ticks/sec", result.m_wallSeconds * 1000.0, ticksPerSecond));
+
+	return true;
+}
+
 Game::Game()
 {
 	BlockDefinition::InitializeBlockDefinitions();
 	MapDefinition::InitializeMapDefinitions();
 	TowerDefinition::InitializeTowerDefinitions();
 	EnemyDefinition::InitializeEnemyDefinitions();
-	Particle::InitializeParticleTextures();
+	ParticleSystem::InitializeParticleTextures();
+
+	int numJobThreads = g_gameConfigBlackboard.GetValue("numJobThreads", (int)std::thread::hardware_concurrency());
+	m_jobSystem = new JobSystem(numJobThreads);
 
 	LoadSaveFile();
 	LoadAssets();
 	SubscribeEventCallbackFunction("Gameclock", Event_GameClock, "Modifies settings for the game clock");
+	SubscribeEventCallbackFunction("SimulateLevel", Game::Event_SimulateLevel, "Runs a scripted level without rendering or audio");
+	Benchmarks::RegisterConsoleCommands();
 	m_worldCamera.SetRenderBasis(Vec3::SKYWARD, Vec3::WEST, Vec3::NORTH);
 }
 
 Game::~Game()
 {
+	delete m_jobSystem;
+	m_jobSystem = nullptr;
 }
 
 void Game::LoadAssets()
@@ -317,6 +372,7 @@ extern double g_frameTime;
 extern double g_updateTime;
 extern double g_renderTime;
 extern double g_mapRenderTime;
+extern double g_towerRenderTime;
 
 void Game::Render() const
 {
@@ -343,7 +399,25 @@ void Game::Render() const
 		DebugAddMessage(Stringf("Update time: %f", g_updateTime), 0.f, Rgba8::YELLOW, Rgba8::YELLOW);
 		DebugAddMessage(Stringf("Render time: %f", g_renderTime), 0.f, Rgba8::CYAN, Rgba8::CYAN);
 		DebugAddMessage(Stringf("Map Render time: %f", g_mapRenderTime), 0.f, Rgba8::ORANGE, Rgba8::ORANGE);
-		DebugAddMessage(Stringf("Tower Render time: %f", g_mapRenderTime), 0.f, Rgba8::MAROON, Rgba8::MAROON);
+		DebugAddMessage(Stringf("Tower Render time: %f", g_towerRenderTime), 0.f, Rgba8::MAROON, Rgba8::MAROON);
+		DebugAddMessage(Stringf("Bytes uploaded: %d", (int)g_lastFrameRenderStats.m_numBytesUploaded), 0.f, Rgba8::WHITE, Rgba8::WHITE);
+		DebugAddMessage(Stringf("Draw calls: %d, state changes: %d", g_lastFrameRenderStats.m_numDrawCalls, g_lastFrameRenderStats.m_numStateChanges), 0.f, Rgba8::WHITE, Rgba8::WHITE);
+		if (m_currentMap)
+		{
+			ParticleSystem const* particleSystem = m_currentMap->m_particleSystem;
+			DebugAddMessage(Stringf("Particles: %d, draw calls: %d", particleSystem->GetNumLiveParticles(), particleSystem->m_numDrawCallsLastFrame), 0.f, Rgba8::WHITE, Rgba8::WHITE);
+			InstancedModelRenderer const* towerRenderer = m_currentMap->m_towerRenderer;
+			DebugAddMessage(Stringf("Tower instances: %d, draw calls: %d, model copies: %.2fMB", towerRenderer->GetNumInstances(), towerRenderer->m_numDrawCallsLastFrame, (double)towerRenderer->GetNumCopyBytes() / (1024.0 * 1024.0)), 0.f, Rgba8::WHITE, Rgba8::WHITE);
+			InstancedModelRenderer const* enemyRenderer = m_currentMap->m_enemyRenderer;
+			DebugAddMessage(Stringf("Enemy instances: %d, draw calls: %d, model copies: %.2fMB", enemyRenderer->GetNumInstances(), enemyRenderer->m_numDrawCallsLastFrame, (double)enemyRenderer->GetNumCopyBytes() / (1024.0 * 1024.0)), 0.f, Rgba8::WHITE, Rgba8::WHITE);
+			DebugAddMessage(Stringf("Health bars: %d", m_currentMap->m_healthBarRenderer->m_numBarsLastFrame), 0.f, Rgba8::WHITE, Rgba8::WHITE);
+			MapMesh const* mapMesh = m_currentMap->m_mapMesh;
+			DebugAddMessage(Stringf("Map chunks drawn: %d/%d, verts: %d, indexes: %d", mapMesh->m_numChunksDrawnLastFrame, mapMesh->GetNumChunks(), mapMesh->GetNumVerts(), mapMesh->GetNumIndexes()), 0.f, Rgba8::WHITE, Rgba8::WHITE);
+			DebugAddMessage(Stringf("Map chunks packed: %d/%d, vertex memory: %.2fMB", mapMesh->GetNumPackedChunks(), mapMesh->GetNumChunks(), (double)mapMesh->GetNumVertexBytes() / (1024.0 * 1024.0)), 0.f, Rgba8::WHITE, Rgba8::WHITE);
+			DebugAddMessage(Stringf("Map load: %.1fms (%s)", m_currentMap->m_initializeSeconds * 1000.0, m_currentMap->m_wasLoadedFromCookedMap ? "cooked cache" : "cooked from image"), 0.f, Rgba8::WHITE, Rgba8::WHITE);
+			CloudSystem const* cloudSystem = m_currentMap->m_cloudSystem;
+			DebugAddMessage(Stringf("Clouds: %d, draw calls: %d", cloudSystem->GetNumClouds(), cloudSystem->m_numDrawCallsLastFrame), 0.f, Rgba8::WHITE, Rgba8::WHITE);
+		}
 	}
 
 	DebugRenderWorld(m_worldCamera);
@@ -531,11 +605,11 @@ void Game::RenderFModSplashScreen() const
 	g_squirrelFont->AddVertsForTextInBox2D(fmodSplashScreenTextVerts, AABB2(Vec2(0.f, 100.f), Vec2(SCREEN_SIZE_X, 120.f)), 20.f, "Audio Powered by FMOD", Rgba8::WHITE, 1.f, Vec2(0.5f, 0.f), TextBoxMode::OVERRUN, glyphsToDraw);
 	
 	g_renderer->BindTexture(m_fmodLogoTexture);
-	g_renderer->DrawVertexArray(fmodSplashScreenVerts);
+	DrawVertexArray(fmodSplashScreenVerts);
 	
 	g_renderer->BindTexture(g_squirrelFont->GetTexture());
 	g_renderer->SetSamplerMode(SamplerMode::BILINEAR_WRAP);
-	g_renderer->DrawVertexArray(fmodSplashScreenTextVerts);
+	DrawVertexArray(fmodSplashScreenTextVerts);
 
 	g_renderer->EndCamera(m_screenCamera);
 }
@@ -575,12 +649,12 @@ void Game::RenderIntroScreen() const
 		AddVertsForAABB2(introScreenVertexes, animatedLogoBox, Rgba8::WHITE, currentSprite.GetUVs().m_mins, currentSprite.GetUVs().m_maxs);
 	}
 	g_renderer->BindTexture(m_logoTexture);
-	g_renderer->DrawVertexArray(introScreenVertexes);
+	DrawVertexArray(introScreenVertexes);
 	g_renderer->BindTexture(nullptr);
 	g_renderer->SetSamplerMode(SamplerMode::BILINEAR_WRAP);
-	g_renderer->DrawVertexArray(introScreenFadeOutVertexes);
+	DrawVertexArray(introScreenFadeOutVertexes);
 	g_renderer->BindTexture(g_squirrelFont->GetTexture());
-	g_renderer->DrawVertexArray(introScreenTextVerts);
+	DrawVertexArray(introScreenTextVerts);
 
 	g_renderer->EndCamera(m_screenCamera);
 }
@@ -602,7 +676,7 @@ void Game::RenderAttractScreen() const
 	g_renderer->SetSamplerMode(SamplerMode::POINT_CLAMP);
 	g_renderer->BindShader(nullptr);
 	g_renderer->BindTexture(nullptr);
-	g_renderer->DrawVertexArray(attractScreenVerts);
+	DrawVertexArray(attractScreenVerts);
 	g_renderer->EndCamera(m_screenCamera);
 
 	Mat44 modelTransformMatrix = Mat44::CreateTranslation3D(Vec3(3.f, 2.f, -0.5f));
@@ -697,7 +771,7 @@ void Game::RenderAttractScreen() const
 	g_renderer->SetSamplerMode(SamplerMode::BILINEAR_WRAP);
 	g_renderer->BindShader(nullptr);
 	g_renderer->BindTexture(g_squirrelFont->GetTexture());
-	g_renderer->DrawVertexArray(attractScreenTextVertexes);
+	DrawVertexArray(attractScreenTextVertexes);
 	g_renderer->EndCamera(m_screenCamera);
 }
 
@@ -732,11 +806,11 @@ void Game::RenderHUD() const
 
 	g_renderer->SetSamplerMode(SamplerMode::BILINEAR_WRAP);
 	g_renderer->BindTexture(g_squirrelFont->GetTexture());
-	g_renderer->DrawVertexArray(costTextVerts);
+	DrawVertexArray(costTextVerts);
 
 	g_renderer->SetSamplerMode(SamplerMode::POINT_CLAMP);
 	g_renderer->BindTexture(m_currentMap->m_coinTexture);
-	g_renderer->DrawVertexArray(costImageVerts);
+	DrawVertexArray(costImageVerts);
 
 	//m_exitGameConfirmationPopup->Render();
 }
@@ -812,7 +886,7 @@ void Game::RenderOutroTransition() const
 	g_renderer->SetSamplerMode(SamplerMode::POINT_CLAMP);
 	g_renderer->BindTexture(nullptr);
 	g_renderer->BindShader(nullptr);
-	g_renderer->DrawVertexArray(transitionVerts);
+	DrawVertexArray(transitionVerts);
 	g_renderer->EndCamera(m_screenCamera);
 }
 
@@ -838,7 +912,7 @@ void Game::RenderIntroTransition() const
 	g_renderer->SetSamplerMode(SamplerMode::POINT_CLAMP);
 	g_renderer->BindTexture(nullptr);
 	g_renderer->BindShader(nullptr);
-	g_renderer->DrawVertexArray(transitionVerts);
+	DrawVertexArray(transitionVerts);
 	g_renderer->EndCamera(m_screenCamera);
 }
 
@@ -933,7 +1007,7 @@ void Game::RenderMenu() const
 	g_renderer->SetSamplerMode(SamplerMode::POINT_CLAMP);
 	g_renderer->BindShader(nullptr);
 	g_renderer->BindTexture(nullptr);
-	g_renderer->DrawVertexArray(menuVerts);
+	DrawVertexArray(menuVerts);
 	g_renderer->EndCamera(m_screenCamera);
 
 
@@ -981,7 +1055,7 @@ void Game::RenderMenu() const
 	g_renderer->SetSamplerMode(SamplerMode::BILINEAR_WRAP);
 	g_renderer->BindShader(nullptr);
 	g_renderer->BindTexture(g_squirrelFont->GetTexture());
-	g_renderer->DrawVertexArray(menuTextVerts);
+	DrawVertexArray(menuTextVerts);
 	for (int buttonIndex = 0; buttonIndex < (int)m_menuButtons.size(); buttonIndex++)
 	{
 		m_menuButtons[buttonIndex]->Render();
@@ -1007,7 +1081,7 @@ void Game::RenderHowToPlay() const
 	g_renderer->SetSamplerMode(SamplerMode::POINT_CLAMP);
 	g_renderer->BindShader(nullptr);
 	g_renderer->BindTexture(nullptr);
-	g_renderer->DrawVertexArray(howToPlayVerts);
+	DrawVertexArray(howToPlayVerts);
 	g_renderer->EndCamera(m_screenCamera);
 
 
@@ -1032,7 +1106,7 @@ void Game::RenderHowToPlay() const
 
 	g_renderer->SetSamplerMode(SamplerMode::BILINEAR_WRAP);
 	g_renderer->BindTexture(g_squirrelFont->GetTexture());
-	g_renderer->DrawVertexArray(howToPlayTextVerts);
+	DrawVertexArray(howToPlayTextVerts);
 
 	switch (m_howToPlaySection)
 	{
@@ -1053,37 +1127,37 @@ void Game::RenderHowToPlayControls() const
 		AABB2 qKeyBounds(Vec2(SCREEN_SIZE_X * 0.1f, 5.75f * SCREEN_SIZE_Y / 10.f), Vec2(SCREEN_SIZE_X * 0.1f + SCREEN_SIZE_Y * 0.06f, 6.35f * SCREEN_SIZE_Y / 10.f));
 		AddVertsForAABB2(imageVerts, qKeyBounds, Rgba8::WHITE);
 		g_renderer->BindTexture(m_qKeyOutlineTexture);
-		g_renderer->DrawVertexArray(imageVerts);
+		DrawVertexArray(imageVerts);
 		imageVerts.clear();
 
 		AABB2 wKeyBounds(Vec2(SCREEN_SIZE_X * 0.1f + SCREEN_SIZE_Y * 0.06f, 5.75f * SCREEN_SIZE_Y / 10.f), Vec2(SCREEN_SIZE_X * 0.1f + 2.f * SCREEN_SIZE_Y * 0.06f, 6.35f * SCREEN_SIZE_Y / 10.f));
 		AddVertsForAABB2(imageVerts, wKeyBounds, Rgba8::WHITE);
 		g_renderer->BindTexture(m_wKeyTexture);
-		g_renderer->DrawVertexArray(imageVerts);
+		DrawVertexArray(imageVerts);
 		imageVerts.clear();
 
 		AABB2 eKeyBounds(Vec2(SCREEN_SIZE_X * 0.1f + 2.f * SCREEN_SIZE_Y * 0.06f, 5.75f * SCREEN_SIZE_Y / 10.f), Vec2(SCREEN_SIZE_X * 0.1f + 3.f * SCREEN_SIZE_Y * 0.06f, 6.35f * SCREEN_SIZE_Y / 10.f));
 		AddVertsForAABB2(imageVerts, eKeyBounds, Rgba8::WHITE);
 		g_renderer->BindTexture(m_eKeyOutlineTexture);
-		g_renderer->DrawVertexArray(imageVerts);
+		DrawVertexArray(imageVerts);
 		imageVerts.clear();
 
 		AABB2 aKeyBounds(Vec2(SCREEN_SIZE_X * 0.1f, 5.75f * SCREEN_SIZE_Y / 10.f - SCREEN_SIZE_Y * 0.06f), Vec2(SCREEN_SIZE_X * 0.1f + SCREEN_SIZE_Y * 0.06f, 6.35f * SCREEN_SIZE_Y / 10.f - SCREEN_SIZE_Y * 0.06f));
 		AddVertsForAABB2(imageVerts, aKeyBounds, Rgba8::WHITE);
 		g_renderer->BindTexture(m_aKeyTexture);
-		g_renderer->DrawVertexArray(imageVerts);
+		DrawVertexArray(imageVerts);
 		imageVerts.clear();
 
 		AABB2 sKeyBounds(Vec2(SCREEN_SIZE_X * 0.1f + SCREEN_SIZE_Y * 0.06f, 5.75f * SCREEN_SIZE_Y / 10.f - SCREEN_SIZE_Y * 0.06f), Vec2(SCREEN_SIZE_X * 0.1f + 2.f * SCREEN_SIZE_Y * 0.06f, 6.35f * SCREEN_SIZE_Y / 10.f - SCREEN_SIZE_Y * 0.06f));
 		AddVertsForAABB2(imageVerts, sKeyBounds, Rgba8::WHITE);
 		g_renderer->BindTexture(m_sKeyTexture);
-		g_renderer->DrawVertexArray(imageVerts);
+		DrawVertexArray(imageVerts);
 		imageVerts.clear();
 
 		AABB2 dKeyBounds(Vec2(SCREEN_SIZE_X * 0.1f + 2.f * SCREEN_SIZE_Y * 0.06f, 5.75f * SCREEN_SIZE_Y / 10.f - SCREEN_SIZE_Y * 0.06f), Vec2(SCREEN_SIZE_X * 0.1f + 3.f * SCREEN_SIZE_Y * 0.06f, 6.35f * SCREEN_SIZE_Y / 10.f - SCREEN_SIZE_Y * 0.06f));
 		AddVertsForAABB2(imageVerts, dKeyBounds, Rgba8::WHITE);
 		g_renderer->BindTexture(m_dKeyTexture);
-		g_renderer->DrawVertexArray(imageVerts);
+		DrawVertexArray(imageVerts);
 		imageVerts.clear();
 	}
 
@@ -1096,37 +1170,37 @@ void Game::RenderHowToPlayControls() const
 		AABB2 qKeyBounds(Vec2(SCREEN_SIZE_X * 0.6f, 5.75f * SCREEN_SIZE_Y / 10.f), Vec2(SCREEN_SIZE_X * 0.6f + SCREEN_SIZE_Y * 0.06f, 6.35f * SCREEN_SIZE_Y / 10.f));
 		AddVertsForAABB2(imageVerts, qKeyBounds, Rgba8::WHITE);
 		g_renderer->BindTexture(m_qKeyTexture);
-		g_renderer->DrawVertexArray(imageVerts);
+		DrawVertexArray(imageVerts);
 		imageVerts.clear();
 
 		AABB2 wKeyBounds(Vec2(SCREEN_SIZE_X * 0.6f + SCREEN_SIZE_Y * 0.06f, 5.75f * SCREEN_SIZE_Y / 10.f), Vec2(SCREEN_SIZE_X * 0.6f + 2.f * SCREEN_SIZE_Y * 0.06f, 6.35f * SCREEN_SIZE_Y / 10.f));
 		AddVertsForAABB2(imageVerts, wKeyBounds, Rgba8::WHITE);
 		g_renderer->BindTexture(m_wKeyOutlineTexture);
-		g_renderer->DrawVertexArray(imageVerts);
+		DrawVertexArray(imageVerts);
 		imageVerts.clear();
 
 		AABB2 eKeyBounds(Vec2(SCREEN_SIZE_X * 0.6f + 2.f * SCREEN_SIZE_Y * 0.06f, 5.75f * SCREEN_SIZE_Y / 10.f), Vec2(SCREEN_SIZE_X * 0.6f + 3.f * SCREEN_SIZE_Y * 0.06f, 6.35f * SCREEN_SIZE_Y / 10.f));
 		AddVertsForAABB2(imageVerts, eKeyBounds, Rgba8::WHITE);
 		g_renderer->BindTexture(m_eKeyTexture);
-		g_renderer->DrawVertexArray(imageVerts);
+		DrawVertexArray(imageVerts);
 		imageVerts.clear();
 
 		AABB2 aKeyBounds(Vec2(SCREEN_SIZE_X * 0.6f, 5.75f * SCREEN_SIZE_Y / 10.f - SCREEN_SIZE_Y * 0.06f), Vec2(SCREEN_SIZE_X * 0.6f + SCREEN_SIZE_Y * 0.06f, 6.35f * SCREEN_SIZE_Y / 10.f - SCREEN_SIZE_Y * 0.06f));
 		AddVertsForAABB2(imageVerts, aKeyBounds, Rgba8::WHITE);
 		g_renderer->BindTexture(m_aKeyOutlineTexture);
-		g_renderer->DrawVertexArray(imageVerts);
+		DrawVertexArray(imageVerts);
 		imageVerts.clear();
 
 		AABB2 sKeyBounds(Vec2(SCREEN_SIZE_X * 0.6f + SCREEN_SIZE_Y * 0.06f, 5.75f * SCREEN_SIZE_Y / 10.f - SCREEN_SIZE_Y * 0.06f), Vec2(SCREEN_SIZE_X * 0.6f + 2.f * SCREEN_SIZE_Y * 0.06f, 6.35f * SCREEN_SIZE_Y / 10.f - SCREEN_SIZE_Y * 0.06f));
 		AddVertsForAABB2(imageVerts, sKeyBounds, Rgba8::WHITE);
 		g_renderer->BindTexture(m_sKeyOutlineTexture);
-		g_renderer->DrawVertexArray(imageVerts);
+		DrawVertexArray(imageVerts);
 		imageVerts.clear();
 
 		AABB2 dKeyBounds(Vec2(SCREEN_SIZE_X * 0.6f + 2.f * SCREEN_SIZE_Y * 0.06f, 5.75f * SCREEN_SIZE_Y / 10.f - SCREEN_SIZE_Y * 0.06f), Vec2(SCREEN_SIZE_X * 0.6f + 3.f * SCREEN_SIZE_Y * 0.06f, 6.35f * SCREEN_SIZE_Y / 10.f - SCREEN_SIZE_Y * 0.06f));
 		AddVertsForAABB2(imageVerts, dKeyBounds, Rgba8::WHITE);
 		g_renderer->BindTexture(m_dKeyOutlineTexture);
-		g_renderer->DrawVertexArray(imageVerts);
+		DrawVertexArray(imageVerts);
 		imageVerts.clear();
 	}
 	{
@@ -1137,13 +1211,13 @@ void Game::RenderHowToPlayControls() const
 		AABB2 rmbBounds(Vec2(SCREEN_SIZE_X * 0.1f, 2.75f * SCREEN_SIZE_Y / 10.f), Vec2(SCREEN_SIZE_X * 0.1f + SCREEN_SIZE_Y * 0.075f, 3.5f * SCREEN_SIZE_Y / 10.f));
 		AddVertsForAABB2(imageVerts, rmbBounds, Rgba8::WHITE);
 		g_renderer->BindTexture(m_rmbTexture);
-		g_renderer->DrawVertexArray(imageVerts);
+		DrawVertexArray(imageVerts);
 		imageVerts.clear();
 
 		AABB2 mouseMoveBounds(Vec2(SCREEN_SIZE_X * 0.1f + SCREEN_SIZE_Y * 0.075f, 2.75f * SCREEN_SIZE_Y / 10.f), Vec2(SCREEN_SIZE_X * 0.1f + 2.f * SCREEN_SIZE_Y * 0.075f, 3.5f * SCREEN_SIZE_Y / 10.f));
 		AddVertsForAABB2(imageVerts, mouseMoveBounds, Rgba8::WHITE);
 		g_renderer->BindTexture(m_mouseMoveTexture);
-		g_renderer->DrawVertexArray(imageVerts);
+		DrawVertexArray(imageVerts);
 		imageVerts.clear();
 	}
 	{
@@ -1154,7 +1228,7 @@ void Game::RenderHowToPlayControls() const
 		AABB2 lmbBounds(Vec2(SCREEN_SIZE_X * 0.6f, 2.75f * SCREEN_SIZE_Y / 10.f), Vec2(SCREEN_SIZE_X * 0.6f + SCREEN_SIZE_Y * 0.075f, 3.5f * SCREEN_SIZE_Y / 10.f));
 		AddVertsForAABB2(imageVerts, lmbBounds, Rgba8::WHITE);
 		g_renderer->BindTexture(m_lmbTexture);
-		g_renderer->DrawVertexArray(imageVerts);
+		DrawVertexArray(imageVerts);
 		imageVerts.clear();
 	}
 	{
@@ -1164,7 +1238,7 @@ void Game::RenderHowToPlayControls() const
 
 	g_renderer->SetSamplerMode(SamplerMode::BILINEAR_WRAP);
 	g_renderer->BindTexture(g_squirrelFont->GetTexture());
-	g_renderer->DrawVertexArray(textVerts);
+	DrawVertexArray(textVerts);
 }
 
 void Game::RenderHowToPlayTowers() const
@@ -1180,7 +1254,7 @@ void Game::RenderHowToPlayTowers() const
 	AABB2 towerImageBounds(Vec2(SCREEN_SIZE_X * 0.2f, 1.5f * SCREEN_SIZE_Y / 10.f), Vec2(SCREEN_SIZE_X * 0.5f, 1.5f * SCREEN_SIZE_Y / 10.f + SCREEN_SIZE_X * 0.3f));
 	AddVertsForAABB2(imageVerts, towerImageBounds, Rgba8::WHITE);
 	g_renderer->BindTexture(towerTexture);
-	g_renderer->DrawVertexArray(imageVerts);
+	DrawVertexArray(imageVerts);
 
 	AABB2 towerInfoBounds(Vec2(SCREEN_SIZE_X * 0.5f, 1.5f * SCREEN_SIZE_Y / 10.f), Vec2(SCREEN_SIZE_X * 0.8f, 4.5f * SCREEN_SIZE_Y / 10.f + SCREEN_SIZE_X * 0.1f));
 	//std::string towerInfoText = Stringf("%s\n\nRange:%.0f\nRefire Time: %.2f seconds\nDamage per Shot: %.2f-%.2f HP\n\nBurn Damage per Second: %.0f-%.0f HP\nBurn Duration: %.0f seconds\n\nPoison Damage per Second: %.0f-%.0f HP\nPoison Duration: %.0f seconds\n\nTarget Speed Multiplier: %.1f\nTarget freeze duration:%.0f seconds\n\nCost: %d", towerDef.m_name.c_str(), towerDef.m_range, towerDef.m_refireTime, towerDef.m_damage.m_min, towerDef.m_damage.m_max, towerDef.m_burnDamagePerSecond.m_min, towerDef.m_burnDamagePerSecond.m_max, towerDef.m_burnDuration, towerDef.m_poisonDamagePerSecond.m_min, towerDef.m_poisonDamagePerSecond.m_max, towerDef.m_poisonDuration, towerDef.m_slowDownFactor, towerDef.m_slowDownDuration, towerDef.m_cost);
@@ -1203,7 +1277,7 @@ void Game::RenderHowToPlayTowers() const
 
 	g_renderer->SetSamplerMode(SamplerMode::BILINEAR_WRAP);
 	g_renderer->BindTexture(g_squirrelFont->GetTexture());
-	g_renderer->DrawVertexArray(textVerts);
+	DrawVertexArray(textVerts);
 }
 
 void Game::RenderHowToPlayEnemies() const
@@ -1219,7 +1293,7 @@ void Game::RenderHowToPlayEnemies() const
 	AABB2 enemyImageBounds(Vec2(SCREEN_SIZE_X * 0.2f, 1.5f * SCREEN_SIZE_Y / 10.f), Vec2(SCREEN_SIZE_X * 0.5f, 1.5f * SCREEN_SIZE_Y / 10.f + SCREEN_SIZE_X * 0.3f));
 	AddVertsForAABB2(imageVerts, enemyImageBounds, Rgba8::WHITE);
 	g_renderer->BindTexture(enemyTexture);
-	g_renderer->DrawVertexArray(imageVerts);
+	DrawVertexArray(imageVerts);
 
 	AABB2 enemyInfoBounds(Vec2(SCREEN_SIZE_X * 0.5f, 1.5f * SCREEN_SIZE_Y / 10.f), Vec2(SCREEN_SIZE_X * 0.8f, 4.5f * SCREEN_SIZE_Y / 10.f + SCREEN_SIZE_X * 0.1f));
 	std::string enemyName = enemyDef.m_name;
@@ -1229,7 +1303,7 @@ void Game::RenderHowToPlayEnemies() const
 
 	g_renderer->SetSamplerMode(SamplerMode::BILINEAR_WRAP);
 	g_renderer->BindTexture(g_squirrelFont->GetTexture());
-	g_renderer->DrawVertexArray(textVerts);
+	DrawVertexArray(textVerts);
 }
 
 void Game::RenderSettings() const
@@ -1248,7 +1322,7 @@ void Game::RenderSettings() const
 	g_renderer->SetSamplerMode(SamplerMode::POINT_CLAMP);
 	g_renderer->BindShader(nullptr);
 	g_renderer->BindTexture(nullptr);
-	g_renderer->DrawVertexArray(settingsVerts);
+	DrawVertexArray(settingsVerts);
 	g_renderer->EndCamera(m_screenCamera);
 
 	g_renderer->BeginCamera(m_screenCamera);
@@ -1282,7 +1356,7 @@ void Game::RenderSettings() const
 
 	g_renderer->SetSamplerMode(SamplerMode::BILINEAR_WRAP);
 	g_renderer->BindTexture(g_squirrelFont->GetTexture());
-	g_renderer->DrawVertexArray(settingsTextVertexes);
+	DrawVertexArray(settingsTextVertexes);
 	g_renderer->EndCamera(m_screenCamera);
 }
 
@@ -1304,7 +1378,7 @@ void Game::RenderCredits() const
 	g_renderer->BindShader(nullptr);
 	
 	g_renderer->BindTexture(nullptr);
-	g_renderer->DrawVertexArray(creditsVerts);
+	DrawVertexArray(creditsVerts);
 	
 	for (int buttonIndex = 0; buttonIndex < (int)m_creditsButtons.size(); buttonIndex++)
 	{
@@ -1322,7 +1396,7 @@ void Game::RenderCredits() const
 	g_renderer->SetRasterizerFillMode(RasterizerFillMode::SOLID);
 	g_renderer->BindShader(nullptr);
 	g_renderer->BindTexture(g_squirrelFont->GetTexture());
-	g_renderer->DrawVertexArray(creditsScreenTextVertexes);
+	DrawVertexArray(creditsScreenTextVertexes);
 	g_renderer->EndCamera(m_screenCamera);
 }
 
@@ -1342,7 +1416,7 @@ void Game::RenderLevelSelect() const
 	g_renderer->SetSamplerMode(SamplerMode::POINT_CLAMP);
 	g_renderer->BindShader(nullptr);
 	g_renderer->BindTexture(nullptr);
-	g_renderer->DrawVertexArray(levelSelectVerts);
+	DrawVertexArray(levelSelectVerts);
 	g_renderer->EndCamera(m_screenCamera);
 
 
@@ -1386,7 +1460,7 @@ void Game::RenderLevelSelect() const
 			//g_theRenderer->SetModelConstants(Mat44::IDENTITY, Rgba8::WHITE);
 			g_renderer->BindTexture(m_starOutlineTexture);
 		}
-		g_renderer->DrawVertexArray(levelSelectStarVerts);
+		DrawVertexArray(levelSelectStarVerts);
 		levelSelectStarVerts.clear();
 
 		AddVertsForAABB2(levelSelectStarVerts, levelStarsBounds.GetBoxAtUVs(Vec2(0.33f, 0.f), Vec2(0.67f, 1.f)), Rgba8::WHITE);
@@ -1400,7 +1474,7 @@ void Game::RenderLevelSelect() const
 			//g_theRenderer->SetModelConstants(Mat44::IDENTITY, Rgba8::WHITE);
 			g_renderer->BindTexture(m_starOutlineTexture);
 		}
-		g_renderer->DrawVertexArray(levelSelectStarVerts);
+		DrawVertexArray(levelSelectStarVerts);
 		levelSelectStarVerts.clear();
 
 		AddVertsForAABB2(levelSelectStarVerts, levelStarsBounds.GetBoxAtUVs(Vec2(0.67f, 0.f), Vec2(1.f, 1.f)), Rgba8::WHITE);
@@ -1414,7 +1488,7 @@ void Game::RenderLevelSelect() const
 			//g_theRenderer->SetModelConstants(Mat44::IDENTITY, Rgba8::WHITE);
 			g_renderer->BindTexture(m_starOutlineTexture);
 		}
-		g_renderer->DrawVertexArray(levelSelectStarVerts);
+		DrawVertexArray(levelSelectStarVerts);
 	}
 
 	std::vector<Vertex_PCU> levelSelectTextVerts;
@@ -1423,7 +1497,7 @@ void Game::RenderLevelSelect() const
 	g_squirrelFont->AddVertsForTextInBox2D(levelSelectTextVerts, levelSelectTextBox, SCREEN_SIZE_Y * 0.05f, "Level Select", UI_ACCENT_COLOR, 0.7f, Vec2(0.5f, 0.5f));
 	g_renderer->SetSamplerMode(SamplerMode::BILINEAR_WRAP);
 	g_renderer->BindTexture(g_squirrelFont->GetTexture());
-	g_renderer->DrawVertexArray(levelSelectTextVerts);
+	DrawVertexArray(levelSelectTextVerts);
 
 	g_renderer->EndCamera(m_screenCamera);
 }
@@ -12,6 +12,7 @@
 #include "Game/GameCommon.hpp"
 
 class		App;
+class		JobSystem;
 class		Map;
 class		Texture;
 class		UIButton;
@@ -84,6 +85,7 @@ public:
 	void						AddCameraShake(float trauma);
 
 	static bool					Event_GameClock										(EventArgs& args);
+	static bool					Event_SimulateLevel									(EventArgs& args);
 	static bool					Event_StartButtonClick(EventArgs& args);
 	static bool					Event_SettingsButtonClick(EventArgs& args);
 	static bool					Event_HowToPlayButtonClick(EventArgs& args);
@@ -125,6 +127,7 @@ public:
 #endif
 	HowToPlaySection			m_howToPlaySection = HowToPlaySection::INVALID;
 	Clock						m_gameClock = Clock();
+	JobSystem*					m_jobSystem = nullptr;
 
 	Map*						m_currentMap = nullptr;
 	Map*						m_nextMap = nullptr;
@@ -1,5 +1,7 @@
 #include "Game/GameCommon.hpp"
 
+#include "Game/RenderBackend.hpp"
+
 
 char const* START_BUTTON_TEXT = "Start";
 char const* HOWTOPLAY_BUTTON_TEXT = "How to Play";
@@ -10,6 +12,61 @@ char const* BACK_BUTTON_TEXT = "Back";
 
 float SCREEN_SIZE_X = 1600.f;
 
+FrameRenderStats g_frameRenderStats;
+FrameRenderStats g_lastFrameRenderStats;
+
+// The map render path talks to this instead of g_renderer, so it can be swapped for a recording backend
+static RendererBackend s_rendererBackend;
+RenderBackend* g_renderBackend = &s_rendererBackend;
+
+void DrawVertexArray(std::vector<Vertex_PCU> const& verts)
+{
+	g_frameRenderStats.m_numBytesUploaded += verts.size() * sizeof(Vertex_PCU);
+	g_renderBackend->DrawVertexArray(verts);
+}
+
+void DrawVertexArray(std::vector<Vertex_PCUTBN> const& verts)
+{
+	g_frameRenderStats.m_numBytesUploaded += verts.size() * sizeof(Vertex_PCUTBN);
+	g_renderBackend->DrawVertexArray(verts);
+}
+
+void CopyCPUToGPU(void const* data, size_t size, VertexBuffer* vbo)
+{
+	g_frameRenderStats.m_numBytesUploaded += size;
+	g_renderBackend->CopyCPUToGPU(data, size, vbo);
+}
+
+void CopyCPUToGPU(void const* data, size_t size, IndexBuffer* ibo)
+{
+	g_frameRenderStats.m_numBytesUploaded += size;
+	g_renderBackend->CopyCPUToGPU(data, size, ibo);
+}
+
+void CopyCPUToGPU(void const* data, size_t size, ConstantBuffer* cbo)
+{
+	g_frameRenderStats.m_numBytesUploaded += size;
+	g_renderBackend->CopyCPUToGPU(data, size, cbo);
+}
+
+void DestroyBuffer(VertexBuffer*& vbo)
+{
+	g_renderBackend->DestroyVertexBuffer(vbo);
+	vbo = nullptr;
+}
+
+void DestroyBuffer(IndexBuffer*& ibo)
+{
+	g_renderBackend->DestroyIndexBuffer(ibo);
+	ibo = nullptr;
+}
+
+void DestroyBuffer(ConstantBuffer*& cbo)
+{
+	g_renderBackend->DestroyConstantBuffer(cbo);
+	cbo = nullptr;
+}
+
 RasterizerCullMode GetCullModeFromString(std::string const& cullModeStr)
 {
 	if (!strcmp(cullModeStr.c_str(), "Front"))
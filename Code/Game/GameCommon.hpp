@@ -1,5 +1,7 @@
 #pragma once
 
+#include "Game/SimulationCommon.hpp"
+
 #include "Engine/Audio/AudioSystem.hpp"
 #include "Engine/Core/EngineCommon.hpp"
 #include "Engine/Core/ErrorWarningAssert.hpp"
@@ -10,6 +12,7 @@
 #include "Engine/Core/Vertex_PCU.hpp"
 #include "Engine/Core/VertexUtils.hpp"
 #include "Engine/Math/AABB2.hpp"
+#include "Engine/Math/Mat44.hpp"
 #include "Engine/Math/MathUtils.hpp"
 #include "Engine/Math/RandomNumberGenerator.hpp"
 #include "Engine/Math/Vec2.hpp"
@@ -21,7 +24,11 @@
 #include "Engine/Renderer/Texture.hpp"
 
 class App;
+class ConstantBuffer;
 class Enemy;
+class IndexBuffer;
+class RenderBackend;
+class VertexBuffer;
 
 extern App*							g_app;
 extern RandomNumberGenerator*		g_RNG;
@@ -30,6 +37,7 @@ extern AudioSystem*					g_audio;
 extern Window*						g_window;
 extern BitmapFont*					g_squirrelFont;
 extern ModelLoader*					g_modelLoader;
+extern RenderBackend*				g_renderBackend;
 
 //constexpr float SCREEN_SIZE_X		= 1600.f;
 extern float SCREEN_SIZE_X;
@@ -38,6 +46,29 @@ constexpr float SCREEN_SIZE_Y		= 800.f;
 constexpr float MAX_CAMERA_SHAKE_X	= 10.f;
 constexpr float MAX_CAMERA_SHAKE_Y	= 5.f;
 
+// Counters for the data the game hands to the renderer, collected over a frame and reset in App::BeginFrame
+struct FrameRenderStats
+{
+public:
+	size_t m_numBytesUploaded = 0;
+	int m_numDrawCalls = 0;
+	int m_numStateChanges = 0;
+};
+
+extern FrameRenderStats				g_frameRenderStats;
+extern FrameRenderStats				g_lastFrameRenderStats;
+
+// Forward to the render backend and count the bytes copied to the GPU, so per-frame uploads show up in the debug overlay
+void DrawVertexArray(std::vector<Vertex_PCU> const& verts);
+void DrawVertexArray(std::vector<Vertex_PCUTBN> const& verts);
+void CopyCPUToGPU(void const* data, size_t size, VertexBuffer* vbo);
+void CopyCPUToGPU(void const* data, size_t size, IndexBuffer* ibo);
+void CopyCPUToGPU(void const* data, size_t size, ConstantBuffer* cbo);
+// Buffers go back to the backend that created them, which deletes them and clears the pointer
+void DestroyBuffer(VertexBuffer*& vbo);
+void DestroyBuffer(IndexBuffer*& ibo);
+void DestroyBuffer(ConstantBuffer*& cbo);
+
 RasterizerCullMode GetCullModeFromString(std::string const& cullModeStr);
 BlendMode GetBlendModeFromString(std::string const& blendModeStr);
 std::string GetTimeString(int timeInSeconds);
@@ -71,3 +102,22 @@ public:
 	float padding0;
 };
 
+// Per-instance data read by the instanced map shaders, one block of it per draw
+// A draw repeats the model's triangle list once per instance it covers, so the shaders find the instance of vertex v at v / m_numVertsPerInstance
+constexpr int SHADER_INSTANCE_CONSTANTS_SLOT = 9;
+constexpr int MAX_INSTANCES_PER_DRAW = 32;
+struct InstanceShaderConstants
+{
+public:
+	Mat44 m_modelMatrix;
+	float m_modelColor[4];
+};
+
+struct InstanceDrawShaderConstants
+{
+public:
+	InstanceShaderConstants m_instances[MAX_INSTANCES_PER_DRAW];
+	int m_numVertsPerInstance = 0;
+	int m_padding[3] = {};
+};
+
@@ -0,0 +1,255 @@
+#pragma once
+
+#include "Engine/Math/IntVec2.hpp"
+
+#include <cstdint>
+#include <vector>
+
+
+// Cardinal directions come first, in BlockSide order, so loops over the first NUM_CARDINAL_GRID_DIRECTIONS only visit edge neighbors
+enum class GridDirection
+{
+	EAST,
+	WEST,
+	NORTH,
+	SOUTH,
+	NORTHEAST,
+	NORTHWEST,
+	SOUTHEAST,
+	SOUTHWEST,
+
+	COUNT
+};
+
+constexpr int NUM_CARDINAL_GRID_DIRECTIONS = 4;
+
+
+enum class GridOrder
+{
+	ROW_MAJOR,
+	MORTON,
+};
+
+
+// Spreads the low 16 bits of value out to the even bits, so x and y can be interleaved into a Morton index
+inline uint32_t SpreadBitsForMorton(uint32_t value)
+{
+	value &= 0x0000FFFF;
+	value = (value | (value << 8)) & 0x00FF00FF;
+	value = (value | (value << 4)) & 0x0F0F0F0F;
+	value = (value | (value << 2)) & 0x33333333;
+	value = (value | (value << 1)) & 0x55555555;
+	return value;
+}
+
+inline uint32_t CompactBitsForMorton(uint32_t value)
+{
+	value &= 0x55555555;
+	value = (value | (value >> 1)) & 0x33333333;
+	value = (value | (value >> 2)) & 0x0F0F0F0F;
+	value = (value | (value >> 4)) & 0x00FF00FF;
+	value = (value | (value >> 8)) & 0x0000FFFF;
+	return value;
+}
+
+
+// 2D array of cells surrounded by a one cell border of sentinel values, so every neighbor of an interior cell is a valid cell to read
+// Loops that walk neighbors can then test the neighbor's value instead of its coordinates, as long as the border value fails the test
+// Cells are addressed by storage index: row-major grids step to neighbors with precomputed offsets, Morton grids with dilated integer arithmetic
+template <typename T, GridOrder ORDER = GridOrder::ROW_MAJOR>
+class Grid
+{
+public:
+	~Grid() = default;
+	Grid() = default;
+	explicit Grid(IntVec2 const& dimensions, T const& initialValue = T(), T const& borderValue = T());
+
+	IntVec2 GetDimensions() const;
+	int GetStorageSize() const;
+	bool IsInBounds(IntVec2 const& coords) const;
+
+	// Coordinates from -1 to the dimensions are valid, the outermost ones being the border
+	int GetIndex(int x, int y) const;
+	int GetIndex(IntVec2 const& coords) const;
+	IntVec2 GetCoords(int index) const;
+
+	// Only valid for interior cells; stepping off the border leaves the grid
+	int GetNeighborIndex(int index, GridDirection direction) const;
+
+	T& Get(IntVec2 const& coords);
+	T const& Get(IntVec2 const& coords) const;
+	T& operator[](int index);
+	T const& operator[](int index) const;
+
+public:
+	IntVec2 m_dimensions = IntVec2::ZERO;
+	int m_storageWidth = 0;
+	std::vector<T> m_cells;
+	int m_neighborOffsets[(int)GridDirection::COUNT] = {};
+};
+
+
+// Multi-source breadth-first flood fill over the cardinal neighbors of each cell, starting from the cells already in the queue
+// visit(fromIndex, toIndex) records whatever it needs and returns whether toIndex should be queued; it must reject border cells
+// The queue is a flat array that is only ever appended to, so every cell the fill entered is left in it in visiting order
+template <typename T, GridOrder ORDER, typename VISIT_FUNC>
+void FloodFillGrid(Grid<T, ORDER> const& grid, std::vector<int>& cellQueue, VISIT_FUNC visit)
+{
+	for (int queueIndex = 0; queueIndex < (int)cellQueue.size(); queueIndex++)
+	{
+		int cellIndex = cellQueue[queueIndex];
+		for (int directionIndex = 0; directionIndex < NUM_CARDINAL_GRID_DIRECTIONS; directionIndex++)
+		{
+			int neighborIndex = grid.GetNeighborIndex(cellIndex, (GridDirection)directionIndex);
+			if (visit(cellIndex, neighborIndex))
+			{
+				cellQueue.push_back(neighborIndex);
+			}
+		}
+	}
+}
+
+
+template <typename T, GridOrder ORDER>
+Grid<T, ORDER>::Grid(IntVec2 const& dimensions, T const& initialValue, T const& borderValue)
+	: m_dimensions(dimensions)
+{
+	int paddedWidth = dimensions.x + 2;
+	int paddedHeight = dimensions.y + 2;
+	if constexpr (ORDER == GridOrder::MORTON)
+	{
+		// Morton indexes cover a power of two square; the cells past the padded grid are never neighbors of interior cells
+		m_storageWidth = 1;
+		while (m_storageWidth < paddedWidth || m_storageWidth < paddedHeight)
+		{
+			m_storageWidth *= 2;
+		}
+		m_cells.assign(m_storageWidth * m_storageWidth, borderValue);
+	}
+	else
+	{
+		m_storageWidth = paddedWidth;
+		m_cells.assign(paddedWidth * paddedHeight, borderValue);
+		m_neighborOffsets[(int)GridDirection::EAST] = 1;
+		m_neighborOffsets[(int)GridDirection::WEST] = -1;
+		m_neighborOffsets[(int)GridDirection::NORTH] = m_storageWidth;
+		m_neighborOffsets[(int)GridDirection::SOUTH] = -m_storageWidth;
+		m_neighborOffsets[(int)GridDirection::NORTHEAST] = m_storageWidth + 1;
+		m_neighborOffsets[(int)GridDirection::NORTHWEST] = m_storageWidth - 1;
+		m_neighborOffsets[(int)GridDirection::SOUTHEAST] = -m_storageWidth + 1;
+		m_neighborOffsets[(int)GridDirection::SOUTHWEST] = -m_storageWidth - 1;
+	}
+
+	for (int y = 0; y < dimensions.y; y++)
+	{
+		for (int x = 0; x < dimensions.x; x++)
+		{
+			m_cells[GetIndex(x, y)] = initialValue;
+		}
+	}
+}
+
+template <typename T, GridOrder ORDER>
+IntVec2 Grid<T, ORDER>::GetDimensions() const
+{
+	return m_dimensions;
+}
+
+template <typename T, GridOrder ORDER>
+int Grid<T, ORDER>::GetStorageSize() const
+{
+	return (int)m_cells.size();
+}
+
+template <typename T, GridOrder ORDER>
+bool Grid<T, ORDER>::IsInBounds(IntVec2 const& coords) const
+{
+	return coords.x >= 0 && coords.y >= 0 && coords.x < m_dimensions.x && coords.y < m_dimensions.y;
+}
+
+template <typename T, GridOrder ORDER>
+int Grid<T, ORDER>::GetIndex(int x, int y) const
+{
+	if constexpr (ORDER == GridOrder::MORTON)
+	{
+		return (int)(SpreadBitsForMorton((uint32_t)(x + 1)) | (SpreadBitsForMorton((uint32_t)(y + 1)) << 1));
+	}
+	else
+	{
+		return (x + 1) + m_storageWidth * (y + 1);
+	}
+}
+
+template <typename T, GridOrder ORDER>
+int Grid<T, ORDER>::GetIndex(IntVec2 const& coords) const
+{
+	return GetIndex(coords.x, coords.y);
+}
+
+template <typename T, GridOrder ORDER>
+IntVec2 Grid<T, ORDER>::GetCoords(int index) const
+{
+	if constexpr (ORDER == GridOrder::MORTON)
+	{
+		return IntVec2((int)CompactBitsForMorton((uint32_t)index) - 1, (int)CompactBitsForMorton((uint32_t)index >> 1) - 1);
+	}
+	else
+	{
+		return IntVec2(index % m_storageWidth - 1, index / m_storageWidth - 1);
+	}
+}
+
+template <typename T, GridOrder ORDER>
+int Grid<T, ORDER>::GetNeighborIndex(int index, GridDirection direction) const
+{
+	if constexpr (ORDER == GridOrder::MORTON)
+	{
+		// x lives in the even bits and y in the odd ones; filling the other axis' bits with ones lets a carry ripple straight through them
+		constexpr uint32_t X_BITS = 0x55555555;
+		constexpr uint32_t Y_BITS = 0xAAAAAAAA;
+		uint32_t mortonIndex = (uint32_t)index;
+		uint32_t xBits = mortonIndex & X_BITS;
+		uint32_t yBits = mortonIndex & Y_BITS;
+		switch (direction)
+		{
+			case GridDirection::EAST:		xBits = ((mortonIndex | Y_BITS) + 1) & X_BITS;		break;
+			case GridDirection::WEST:		xBits = (xBits - 1) & X_BITS;						break;
+			case GridDirection::NORTH:		yBits = ((mortonIndex | X_BITS) + 2) & Y_BITS;		break;
+			case GridDirection::SOUTH:		yBits = (yBits - 2) & Y_BITS;						break;
+			case GridDirection::NORTHEAST:	return GetNeighborIndex(GetNeighborIndex(index, GridDirection::NORTH), GridDirection::EAST);
+			case GridDirection::NORTHWEST:	return GetNeighborIndex(GetNeighborIndex(index, GridDirection::NORTH), GridDirection::WEST);
+			case GridDirection::SOUTHEAST:	return GetNeighborIndex(GetNeighborIndex(index, GridDirection::SOUTH), GridDirection::EAST);
+			case GridDirection::SOUTHWEST:	return GetNeighborIndex(GetNeighborIndex(index, GridDirection::SOUTH), GridDirection::WEST);
+			default:						break;
+		}
+		return (int)(xBits | yBits);
+	}
+	else
+	{
+		return index + m_neighborOffsets[(int)direction];
+	}
+}
+
+template <typename T, GridOrder ORDER>
+T& Grid<T, ORDER>::Get(IntVec2 const& coords)
+{
+	return m_cells[GetIndex(coords)];
+}
+
+template <typename T, GridOrder ORDER>
+T const& Grid<T, ORDER>::Get(IntVec2 const& coords) const
+{
+	return m_cells[GetIndex(coords)];
+}
+
+template <typename T, GridOrder ORDER>
+T& Grid<T, ORDER>::operator[](int index)
+{
+	return m_cells[index];
+}
+
+template <typename T, GridOrder ORDER>
+T const& Grid<T, ORDER>::operator[](int index) const
+{
+	return m_cells[index];
+}
@@ -0,0 +1,86 @@
+#include "Game/HealthBarRenderer.hpp"
+
+#include "Game/CameraFrustum.hpp"
+#include "Game/Enemy.hpp"
+#include "Game/EnemySlotMap.hpp"
+#include "Game/GameCommon.hpp"
+#include "Game/RenderBackend.hpp"
+#include "Game/RenderCommandList.hpp"
+
+#include "Engine/Renderer/VertexBuffer.hpp"
+
+
+HealthBarRenderer::~HealthBarRenderer()
+{
+	DestroyBuffer(m_vertexBuffer);
+}
+
+void HealthBarRenderer::AddRenderCommands(RenderCommandList& commandList, Camera const& camera, EnemySlotMap const& enemies)
+{
+	m_verts.clear();
+	m_numBarsLastFrame = 0;
+
+	// Bars stay upright and turn with the camera's yaw, so the basis is flattened onto the ground plane
+	Vec3 cameraFwd, cameraLeft, cameraUp;
+	camera.GetOrientation().GetAsVectors_iFwd_jLeft_kUp(cameraFwd, cameraLeft, cameraUp);
+	Vec3 towardCamera = Vec3(-cameraFwd.x, -cameraFwd.y, 0.f);
+	if (towardCamera.GetLengthSquared() == 0.f)
+	{
+		towardCamera = Vec3(-cameraUp.x, -cameraUp.y, 0.f);
+	}
+	towardCamera = towardCamera.GetNormalized();
+	Vec3 barLeft = CrossProduct3D(Vec3::SKYWARD, towardCamera);
+	CameraFrustum frustum(camera);
+
+	for (int enemyIndex = 0; enemyIndex < enemies.GetCount(); enemyIndex++)
+	{
+		Enemy const* enemy = enemies[enemyIndex];
+		if (!enemy->HasHealthBar() || frustum.IsSphereOutside(enemy->GetHealthBarPosition(), CULL_RADIUS))
+		{
+			continue;
+		}
+
+		AddVertsForHealthBar(*enemy, towardCamera, barLeft, Vec3::SKYWARD);
+		m_numBarsLastFrame++;
+	}
+
+	if (m_verts.empty())
+	{
+		return;
+	}
+
+	size_t vertsSize = m_verts.size() * sizeof(Vertex_PCU);
+	if (!m_vertexBuffer || m_vertexBufferSize < vertsSize)
+	{
+		DestroyBuffer(m_vertexBuffer);
+		m_vertexBufferSize = vertsSize * 2;
+		m_vertexBuffer = g_renderBackend->CreateVertexBuffer(m_vertexBufferSize);
+	}
+
+	RenderCommand command;
+	command.m_vertexBuffer = m_vertexBuffer;
+	command.m_count = (int)m_verts.size();
+	command.m_uploadData = m_verts.data();
+	command.m_uploadSize = vertsSize;
+	command.m_uploadVertexBuffer = m_vertexBuffer;
+	commandList.AddCommand(command);
+}
+
+void HealthBarRenderer::AddVertsForHealthBar(Enemy const& enemy, Vec3 const& towardCamera, Vec3 const& left, Vec3 const& up)
+{
+	// Offsets are in the bar's billboard space: X toward the camera, Y along the bar and Z up
+	Vec3 healthBarPosition = enemy.GetHealthBarPosition();
+	Vec3 outerHalfLength = left * BAR_HALF_LENGTH;
+	Vec3 outerHalfHeight = up * BAR_HALF_HEIGHT;
+	Vec3 innerHalfLength = left * 0.285f;
+	Vec3 innerHalfHeight = up * 0.025f;
+	Vec3 innerCenter = healthBarPosition + towardCamera * 0.001f;
+	Vec3 fillCenter = healthBarPosition + towardCamera * FILL_DEPTH_OFFSET;
+
+	float healthFraction = GetClamped(enemy.GetHealth() / enemy.m_definition->m_health, 0.f, 1.f);
+	Vec3 fillLength = innerHalfLength * 2.f * healthFraction;
+
+	AddVertsForQuad3D(m_verts, healthBarPosition - outerHalfLength - outerHalfHeight, healthBarPosition + outerHalfLength - outerHalfHeight, healthBarPosition + outerHalfLength + outerHalfHeight, healthBarPosition - outerHalfLength + outerHalfHeight, Rgba8::WHITE);
+	AddVertsForQuad3D(m_verts, innerCenter - innerHalfLength - innerHalfHeight, innerCenter + innerHalfLength - innerHalfHeight, innerCenter + innerHalfLength + innerHalfHeight, innerCenter - innerHalfLength + innerHalfHeight, Rgba8::RED);
+	AddVertsForQuad3D(m_verts, fillCenter - innerHalfLength - innerHalfHeight, fillCenter - innerHalfLength + fillLength - innerHalfHeight, fillCenter - innerHalfLength + fillLength + innerHalfHeight, fillCenter - innerHalfLength + innerHalfHeight, Rgba8::GREEN);
+}
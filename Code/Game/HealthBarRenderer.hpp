@@ -0,0 +1,39 @@
+#pragma once
+
+#include "Engine/Core/Vertex_PCU.hpp"
+#include "Engine/Math/Vec3.hpp"
+
+#include <vector>
+
+class Camera;
+class Enemy;
+class EnemySlotMap;
+class RenderCommandList;
+class VertexBuffer;
+
+
+// Draws the world space health bars of every damaged enemy on screen with a single draw call
+// Bars all share one camera-facing basis, so building them is plain vertex math with no per-enemy billboard matrix
+class HealthBarRenderer
+{
+public:
+	// Outer extents of a bar around its center; the inner quads are smaller and sit at most FILL_DEPTH_OFFSET toward the camera
+	static constexpr float BAR_HALF_LENGTH = 0.3f;
+	static constexpr float BAR_HALF_HEIGHT = 0.03f;
+	static constexpr float FILL_DEPTH_OFFSET = 0.002f;
+	// Sum of the extents bounds the bar's corner distance, so a bar is only culled once it is entirely off screen
+	static constexpr float CULL_RADIUS = BAR_HALF_LENGTH + BAR_HALF_HEIGHT + FILL_DEPTH_OFFSET;
+
+public:
+	~HealthBarRenderer();
+	HealthBarRenderer() = default;
+
+	void AddRenderCommands(RenderCommandList& commandList, Camera const& camera, EnemySlotMap const& enemies);
+	void AddVertsForHealthBar(Enemy const& enemy, Vec3 const& towardCamera, Vec3 const& left, Vec3 const& up);
+
+public:
+	std::vector<Vertex_PCU> m_verts;
+	VertexBuffer* m_vertexBuffer = nullptr;
+	size_t m_vertexBufferSize = 0;
+	int m_numBarsLastFrame = 0;
+};
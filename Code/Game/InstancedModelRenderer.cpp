@@ -0,0 +1,211 @@
+#include "Game/InstancedModelRenderer.hpp"
+
+#include "Game/Enemy.hpp"
+#include "Game/RenderBackend.hpp"
+#include "Game/RenderCommandList.hpp"
+#include "Game/Tower.hpp"
+
+#include "Engine/Core/Models/CPUMesh.hpp"
+#include "Engine/Core/Models/Model.hpp"
+#include "Engine/Renderer/ConstantBuffer.hpp"
+#include "Engine/Renderer/VertexBuffer.hpp"
+
+#include <cstring>
+
+
+InstancedModelRenderer::~InstancedModelRenderer()
+{
+	for (int batchIndex = 0; batchIndex < (int)m_batches.size(); batchIndex++)
+	{
+		DestroyBuffer(m_batches[batchIndex].m_copiesVertexBuffer);
+	}
+
+	DestroyBuffer(m_instanceConstantBuffer);
+}
+
+void InstancedModelRenderer::BeginFrame()
+{
+	for (int batchIndex = 0; batchIndex < (int)m_batches.size(); batchIndex++)
+	{
+		m_batches[batchIndex].m_instances.clear();
+	}
+}
+
+void InstancedModelRenderer::AddInstance(Model* model, Texture* texture, Mat44 const& modelMatrix, Rgba8 const& color)
+{
+	InstanceShaderConstants instance;
+	instance.m_modelMatrix = modelMatrix;
+	color.GetAsFloats(instance.m_modelColor);
+	m_batches[GetBatchIndex(model, texture)].m_instances.push_back(instance);
+}
+
+void InstancedModelRenderer::AddTowerInstances(Tower const& tower)
+{
+	Mat44 transformMatrix = Mat44::CreateTranslation3D(tower.m_position);
+	AddInstance(tower.m_definition.m_model, nullptr, transformMatrix);
+
+	Mat44 turretTransformMatrix(transformMatrix);
+	turretTransformMatrix.AppendZRotation(tower.m_turretZOrientation);
+	turretTransformMatrix.AppendScaleNonUniform3D(Vec3(tower.m_turretScaleXY, tower.m_turretScaleXY, tower.m_turretScaleZ));
+	AddInstance(tower.m_definition.m_turretModel, nullptr, turretTransformMatrix);
+}
+
+void InstancedModelRenderer::AddEnemyInstance(Enemy const& enemy)
+{
+	if (enemy.m_isDestroyed)
+	{
+		return;
+	}
+
+	// The squash scales ride in the instance matrix and the tint in the instance color, both per-instance constants rather than model geometry
+	Mat44 transformMatrix = Mat44::CreateTranslation3D(enemy.GetPosition());
+	transformMatrix.AppendZRotation(enemy.GetYawDegrees());
+	transformMatrix.AppendScaleNonUniform3D(Vec3(enemy.m_modelScaleXY, enemy.m_modelScaleXY, enemy.m_modelScaleZ));
+	AddInstance(enemy.m_definition->m_model, enemy.m_definition->m_diffuseTexture, transformMatrix, enemy.m_modelColor);
+}
+
+void InstancedModelRenderer::AddRenderCommands(RenderCommandList& commandList, RenderState const& state)
+{
+	m_numDrawCallsLastFrame = 0;
+
+	if (!m_instanceConstantBuffer)
+	{
+		m_instanceConstantBuffer = g_renderBackend->CreateConstantBuffer(sizeof(InstanceDrawShaderConstants));
+	}
+
+	RenderCommand command;
+	command.m_state = state;
+	command.m_type = RenderCommandType::DRAW_VERTEX_BUFFER;
+	command.m_uploadConstantBuffer = m_instanceConstantBuffer;
+	command.m_uploadConstantBufferSlot = SHADER_INSTANCE_CONSTANTS_SLOT;
+
+	for (int batchIndex = 0; batchIndex < (int)m_batches.size(); batchIndex++)
+	{
+		ModelInstanceBatch& batch = m_batches[batchIndex];
+		if (batch.m_instances.empty())
+		{
+			continue;
+		}
+
+		ReserveCopies(batch, (int)batch.m_instances.size());
+		command.m_state.m_texture = batch.m_texture;
+		command.m_vertexBuffer = batch.m_copiesVertexBuffer;
+
+		// A draw covers at most one instance per model copy, so larger batches are drawn in chunks
+		// Each chunk gets its own block of constants, sized before any is filled so the upload pointers stay valid until submission
+		int numInstances = (int)batch.m_instances.size();
+		int numDraws = (numInstances + batch.m_numCopies - 1) / batch.m_numCopies;
+		if ((int)batch.m_drawConstants.size() < numDraws)
+		{
+			batch.m_drawConstants.resize(numDraws);
+		}
+
+		for (int drawIndex = 0; drawIndex < numDraws; drawIndex++)
+		{
+			int firstInstanceIndex = drawIndex * batch.m_numCopies;
+			int numDrawInstances = numInstances - firstInstanceIndex;
+			if (numDrawInstances > batch.m_numCopies)
+			{
+				numDrawInstances = batch.m_numCopies;
+			}
+
+			InstanceDrawShaderConstants& drawConstants = batch.m_drawConstants[drawIndex];
+			memcpy(drawConstants.m_instances, &batch.m_instances[firstInstanceIndex], numDrawInstances * sizeof(InstanceShaderConstants));
+			drawConstants.m_numVertsPerInstance = batch.m_numVertsPerCopy;
+
+			command.m_count = numDrawInstances * batch.m_numVertsPerCopy;
+			command.m_uploadData = &drawConstants;
+			command.m_uploadSize = sizeof(InstanceDrawShaderConstants);
+			commandList.AddCommand(command);
+			m_numDrawCallsLastFrame++;
+		}
+	}
+}
+
+int InstancedModelRenderer::GetBatchIndex(Model* model, Texture* texture)
+{
+	for (int batchIndex = 0; batchIndex < (int)m_batches.size(); batchIndex++)
+	{
+		if (m_batches[batchIndex].m_model == model && m_batches[batchIndex].m_texture == texture)
+		{
+			return batchIndex;
+		}
+	}
+
+	ModelInstanceBatch batch;
+	batch.m_model = model;
+	batch.m_texture = texture;
+	m_batches.push_back(batch);
+	return (int)m_batches.size() - 1;
+}
+
+// Copies grow in powers of two up to MAX_INSTANCES_PER_DRAW, so the buffer is only rebuilt a handful of times over a level
+// and never holds more than that many copies of the model, nor more than MAX_COPY_BYTES_PER_BATCH beyond a single copy
+void InstancedModelRenderer::ReserveCopies(ModelInstanceBatch& batch, int numCopies)
+{
+	std::vector<Vertex_PCUTBN> const& modelVerts = batch.m_model->m_cpuMesh->m_vertexes;
+	size_t numBytesPerCopy = modelVerts.size() * sizeof(Vertex_PCUTBN);
+	int maxCopies = numBytesPerCopy > 0 ? (int)(MAX_COPY_BYTES_PER_BATCH / numBytesPerCopy) : MAX_INSTANCES_PER_DRAW;
+	if (maxCopies > MAX_INSTANCES_PER_DRAW)
+	{
+		maxCopies = MAX_INSTANCES_PER_DRAW;
+	}
+	if (maxCopies < 1)
+	{
+		maxCopies = 1;
+	}
+
+	if (numCopies > maxCopies)
+	{
+		numCopies = maxCopies;
+	}
+	if (numCopies <= batch.m_numCopies)
+	{
+		return;
+	}
+
+	int numCopiesToBuild = batch.m_numCopies > 0 ? batch.m_numCopies : 1;
+	while (numCopiesToBuild < numCopies)
+	{
+		numCopiesToBuild *= 2;
+	}
+	if (numCopiesToBuild > maxCopies)
+	{
+		numCopiesToBuild = maxCopies;
+	}
+
+	// Model vertexes are a plain triangle list, copied as they are; the shaders tell the copies apart by vertex index
+	std::vector<Vertex_PCUTBN> copiesVerts;
+	copiesVerts.reserve(modelVerts.size() * numCopiesToBuild);
+	for (int copyIndex = 0; copyIndex < numCopiesToBuild; copyIndex++)
+	{
+		copiesVerts.insert(copiesVerts.end(), modelVerts.begin(), modelVerts.end());
+	}
+
+	DestroyBuffer(batch.m_copiesVertexBuffer);
+	batch.m_copiesVertexBuffer = g_renderBackend->CreateVertexBuffer(copiesVerts.size() * sizeof(Vertex_PCUTBN), VertexType::VERTEX_PCUTBN);
+	CopyCPUToGPU(copiesVerts.data(), copiesVerts.size() * sizeof(Vertex_PCUTBN), batch.m_copiesVertexBuffer);
+	batch.m_numCopies = numCopiesToBuild;
+	batch.m_numVertsPerCopy = (int)modelVerts.size();
+}
+
+int InstancedModelRenderer::GetNumInstances() const
+{
+	int numInstances = 0;
+	for (int batchIndex = 0; batchIndex < (int)m_batches.size(); batchIndex++)
+	{
+		numInstances += (int)m_batches[batchIndex].m_instances.size();
+	}
+	return numInstances;
+}
+
+size_t InstancedModelRenderer::GetNumCopyBytes() const
+{
+	size_t numCopyBytes = 0;
+	for (int batchIndex = 0; batchIndex < (int)m_batches.size(); batchIndex++)
+	{
+		ModelInstanceBatch const& batch = m_batches[batchIndex];
+		numCopyBytes += (size_t)batch.m_numCopies * batch.m_numVertsPerCopy * sizeof(Vertex_PCUTBN);
+	}
+	return numCopyBytes;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "Game/GameCommon.hpp"
+
+#include <vector>
+
+class ConstantBuffer;
+class Enemy;
+class Model;
+class RenderCommandList;
+struct RenderState;
+class Texture;
+class Tower;
+class VertexBuffer;
+
+
+// Instances of one model with one texture, drawn together with one draw per MAX_INSTANCES_PER_DRAW instances
+// The model's vertexes are copied back to back into one vertex buffer at most MAX_INSTANCES_PER_DRAW times, so a single
+// vertex buffer draw covers as many instances as there are copies and the buffer stays a small multiple of the model
+struct ModelInstanceBatch
+{
+public:
+	Model* m_model = nullptr;
+	Texture* m_texture = nullptr;
+	std::vector<InstanceShaderConstants> m_instances;
+	std::vector<InstanceDrawShaderConstants> m_drawConstants;
+	VertexBuffer* m_copiesVertexBuffer = nullptr;
+	int m_numCopies = 0;
+	int m_numVertsPerCopy = 0;
+};
+
+
+// Collects model instances over a frame and draws each model in batches instead of one draw per object
+// Per-instance transforms and colors go through a constant buffer that the instanced map shaders index with the vertex index of the draw
+// Batches are kept between frames so their instance arrays and model copies only grow when a frame has more instances than any before it
+class InstancedModelRenderer
+{
+public:
+	// Large models such as the evolved enemies take over a megabyte per copy, so they get fewer copies and more draws
+	static constexpr size_t MAX_COPY_BYTES_PER_BATCH = 4 * 1024 * 1024;
+
+public:
+	~InstancedModelRenderer();
+	InstancedModelRenderer() = default;
+
+	void BeginFrame();
+	void AddInstance(Model* model, Texture* texture, Mat44 const& modelMatrix, Rgba8 const& color = Rgba8::WHITE);
+	void AddTowerInstances(Tower const& tower);
+	void AddEnemyInstance(Enemy const& enemy);
+	void AddRenderCommands(RenderCommandList& commandList, RenderState const& state);
+
+	int GetBatchIndex(Model* model, Texture* texture);
+	void ReserveCopies(ModelInstanceBatch& batch, int numCopies);
+	int GetNumInstances() const;
+	size_t GetNumCopyBytes() const;
+
+public:
+	std::vector<ModelInstanceBatch> m_batches;
+	ConstantBuffer* m_instanceConstantBuffer = nullptr;
+	int m_numDrawCallsLastFrame = 0;
+};
@@ -0,0 +1,146 @@
+#include "Game/JobSystem.hpp"
+
+
+JobSystem::~JobSystem()
+{
+	m_isQuitting = true;
+	{
+		std::lock_guard<std::mutex> wakeLock(m_wakeMutex);
+	}
+	m_wakeCondition.notify_all();
+
+	for (int threadIndex = 0; threadIndex < (int)m_workerThreads.size(); threadIndex++)
+	{
+		m_workerThreads[threadIndex].join();
+	}
+	m_workerThreads.clear();
+
+	for (int queueIndex = 0; queueIndex < (int)m_queues.size(); queueIndex++)
+	{
+		delete m_queues[queueIndex];
+	}
+	m_queues.clear();
+}
+
+JobSystem::JobSystem(int numThreads)
+	: m_numThreads(numThreads > 1 ? numThreads : 1)
+{
+	// Queue 0 belongs to the thread calling ParallelFor, the rest to the worker threads
+	for (int queueIndex = 0; queueIndex < m_numThreads; queueIndex++)
+	{
+		m_queues.push_back(new JobQueue());
+	}
+
+	for (int queueIndex = 1; queueIndex < m_numThreads; queueIndex++)
+	{
+		m_workerThreads.emplace_back(&JobSystem::WorkerThreadMain, this, queueIndex);
+	}
+}
+
+void JobSystem::ParallelFor(int count, int batchSize, std::function<void(int, int)> const& rangeFunction)
+{
+	if (count <= 0)
+	{
+		return;
+	}
+
+	batchSize = batchSize > 1 ? batchSize : 1;
+	if (m_numThreads == 1 || count <= batchSize)
+	{
+		rangeFunction(0, count);
+		return;
+	}
+
+	int numBatches = (count + batchSize - 1) / batchSize;
+	std::atomic<int> numRemainingJobs(numBatches);
+
+	// Deal consecutive batches to consecutive queues so each thread starts on its own part of the range
+	for (int batchIndex = 0; batchIndex < numBatches; batchIndex++)
+	{
+		Job job;
+		job.m_rangeFunction = &rangeFunction;
+		job.m_start = batchIndex * batchSize;
+		job.m_end = job.m_start + batchSize < count ? job.m_start + batchSize : count;
+		job.m_numRemainingJobs = &numRemainingJobs;
+
+		JobQueue* queue = m_queues[(batchIndex * m_numThreads) / numBatches];
+		std::lock_guard<std::mutex> queueLock(queue->m_mutex);
+		queue->m_jobs.push_back(job);
+	}
+
+	{
+		std::lock_guard<std::mutex> wakeLock(m_wakeMutex);
+		m_numQueuedJobs += numBatches;
+	}
+	m_wakeCondition.notify_all();
+
+	while (numRemainingJobs.load(std::memory_order_acquire) > 0)
+	{
+		Job job;
+		if (TakeJob(0, job))
+		{
+			RunJob(job);
+		}
+		else
+		{
+			std::this_thread::yield();
+		}
+	}
+}
+
+int JobSystem::GetNumThreads() const
+{
+	return m_numThreads;
+}
+
+void JobSystem::WorkerThreadMain(int queueIndex)
+{
+	while (!m_isQuitting)
+	{
+		Job job;
+		if (TakeJob(queueIndex, job))
+		{
+			RunJob(job);
+			continue;
+		}
+
+		std::unique_lock<std::mutex> wakeLock(m_wakeMutex);
+		m_wakeCondition.wait(wakeLock, [this]() { return m_isQuitting || m_numQueuedJobs > 0; });
+	}
+}
+
+bool JobSystem::TakeJob(int queueIndex, Job& out_job)
+{
+	{
+		JobQueue* ownQueue = m_queues[queueIndex];
+		std::lock_guard<std::mutex> queueLock(ownQueue->m_mutex);
+		if (!ownQueue->m_jobs.empty())
+		{
+			out_job = ownQueue->m_jobs.back();
+			ownQueue->m_jobs.pop_back();
+			m_numQueuedJobs--;
+			return true;
+		}
+	}
+
+	for (int offset = 1; offset < m_numThreads; offset++)
+	{
+		JobQueue* victimQueue = m_queues[(queueIndex + offset) % m_numThreads];
+		std::lock_guard<std::mutex> queueLock(victimQueue->m_mutex);
+		if (!victimQueue->m_jobs.empty())
+		{
+			out_job = victimQueue->m_jobs.front();
+			victimQueue->m_jobs.pop_front();
+			m_numQueuedJobs--;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void JobSystem::RunJob(Job const& job)
+{
+	(*job.m_rangeFunction)(job.m_start, job.m_end);
+	job.m_numRemainingJobs->fetch_sub(1, std::memory_order_release);
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+// Fixed pool of worker threads with one job queue per thread
+// A thread pops jobs from the back of its own queue and steals from the front of the others when it runs dry
+// The thread calling ParallelFor works through the batches as well, so a system with one thread runs everything inline
+class JobSystem
+{
+public:
+	~JobSystem();
+	JobSystem() = default;
+	explicit JobSystem(int numThreads);
+
+	// Splits [0, count) into batches of at most batchSize and calls rangeFunction(start, end) for each batch, returning once all batches are done
+	void ParallelFor(int count, int batchSize, std::function<void(int, int)> const& rangeFunction);
+	int GetNumThreads() const;
+
+public:
+	struct Job
+	{
+		std::function<void(int, int)> const* m_rangeFunction = nullptr;
+		int m_start = 0;
+		int m_end = 0;
+		std::atomic<int>* m_numRemainingJobs = nullptr;
+	};
+
+	struct JobQueue
+	{
+		std::mutex m_mutex;
+		std::deque<Job> m_jobs;
+	};
+
+	int m_numThreads = 1;
+	std::vector<JobQueue*> m_queues;
+	std::vector<std::thread> m_workerThreads;
+	std::atomic<int> m_numQueuedJobs{ 0 };
+	std::atomic<bool> m_isQuitting{ false };
+	std::mutex m_wakeMutex;
+	std::condition_variable m_wakeCondition;
+
+private:
+	void WorkerThreadMain(int queueIndex);
+	bool TakeJob(int queueIndex, Job& out_job);
+	void RunJob(Job const& job);
+};
@@ -0,0 +1,62 @@
+#include "Game/BlockDefinition.hpp"
+#include "Game/EnemyDefinition.hpp"
+#include "Game/JobSystem.hpp"
+#include "Game/MapDefinition.hpp"
+#include "Game/SimulationScript.hpp"
+#include "Game/TowerDefinition.hpp"
+
+#include "Engine/Core/XMLUtils.hpp"
+
+#include <cstdio>
+#include <string>
+#include <thread>
+
+
+// reytd-sim: plays a simulation script at full speed with no renderer, audio or window, and prints the outcome
+// Run it from Run/ so the Data/ paths in the definitions resolve; g_assetBackend stays on the null backend, so no assets load
+int main(int argc, char* argv[])
+{
+	if (argc < 2)
+	{
+		printf("Usage: reytd-sim <script.xml> [mapName]\n");
+		return 2;
+	}
+
+	BlockDefinition::InitializeBlockDefinitions();
+	MapDefinition::InitializeMapDefinitions();
+	TowerDefinition::InitializeTowerDefinitions();
+	EnemyDefinition::InitializeEnemyDefinitions();
+
+	char const* scriptPath = argv[1];
+	XmlDocument scriptXmlFile;
+	XmlResult fileLoadResult = scriptXmlFile.LoadFile(scriptPath);
+	if (fileLoadResult != XmlResult::XML_SUCCESS)
+	{
+		printf("Could not find or open simulation script \"%s\"\n", scriptPath);
+		return 1;
+	}
+
+	SimulationScript script(scriptXmlFile.RootElement());
+	if (argc >= 3)
+	{
+		script.m_mapName = argv[2];
+	}
+
+	JobSystem* jobSystem = new JobSystem((int)std::thread::hardware_concurrency());
+	SimulationResult result = script.Run(jobSystem);
+	delete jobSystem;
+	jobSystem = nullptr;
+
+	if (result.m_outcome == SimulationOutcome::INVALID)
+	{
+		printf("Could not simulate unknown map \"%s\"\n", script.m_mapName.c_str());
+		return 1;
+	}
+
+	double ticksPerSecond = result.m_wallSeconds > 0.0 ? (double)result.m_numTicks / result.m_wallSeconds : 0.0;
+	printf("%s: %s after %.2fs simulated (%d ticks)\n", script.m_mapName.c_str(), SimulationScript::GetOutcomeName(result.m_outcome), result.m_simulatedSeconds, result.m_numTicks);
+	printf("Lives: %d, Money: %d, Score: %d, Stars: %d, Towers placed: %d\n", result.m_remainingLives, result.m_money, result.m_score, result.m_stars, result.m_numTowersPlaced);
+	printf("Wall time: %.3fms, %.0f ticks/sec\n", result.m_wallSeconds * 1000.0, ticksPerSecond);
+
+	return 0;
+}
@@ -9,14 +9,26 @@
 
 #include "Game/App.hpp"
 #include "Game/Block.hpp"
+#include "Game/CloudSystem.hpp"
+#include "Game/CookedMap.hpp"
 #include "Game/Enemy.hpp"
 #include "Game/Game.hpp"
+#include "Game/HealthBarRenderer.hpp"
+#include "Game/InstancedModelRenderer.hpp"
+#include "Game/JobSystem.hpp"
+#include "Game/MapMesh.hpp"
+#include "Game/ParticleSystem.hpp"
+#include "Game/RenderBackend.hpp"
+#include "Game/RenderCommandList.hpp"
+#include "Game/RenderStateCache.hpp"
+#include "Game/SimulationEvents.hpp"
+#include "Game/StatusEffects.hpp"
 #include "Game/TowerDefinition.hpp"
 #include "Game/EnemyDefinition.hpp"
 #include "Game/Tower.hpp"
 
 #include "Engine/Core/Models/CPUMesh.hpp"
-#include "Engine/Core/Image.hpp"
+#include "Engine/Core/Models/Model.hpp"
 #include "Engine/Math/MathUtils.hpp"
 #include "Engine/Math/RaycastUtils.hpp"
 #include "Engine/Renderer/BitmapFont.hpp"
@@ -26,115 +38,89 @@
 
 #include "ThirdParty/Squirrel/SmoothNoise.hpp"
 
-#include <queue>
 
 
 
 Map::~Map()
 {
-	delete m_vertexBuffer;
-	m_vertexBuffer = nullptr;
+	delete m_mapMesh;
+	m_mapMesh = nullptr;
 
-	delete m_heatMap;
-	m_heatMap = nullptr;
-
-	m_blocks = nullptr;
+	DestroyBuffer(m_skyVertexBuffer);
+	DestroyBuffer(m_rangeIndicatorVertexBuffer);
 
 	m_game->m_gameClock.RemoveChild(&m_mapClock);
 
-	delete m_reyTDConstantBuffer;
-	m_reyTDConstantBuffer = nullptr;
+	DestroyBuffer(m_reyTDConstantBuffer);
 
-	DeleteAllEnemies();
-	DeleteAllTowers();
 	DeleteAllParticles();
 
-}
-
-void Map::DeleteAllEnemies()
-{
-	for (int enemyIndex = (int)m_enemies.size() - 1; enemyIndex >= 0; enemyIndex--)
-	{
-		delete m_enemies[enemyIndex];
-		m_enemies[enemyIndex] = nullptr;
-	}
-	m_enemies.clear();
-}
+	delete m_particleSystem;
+	m_particleSystem = nullptr;
 
-void Map::DeleteAllTowers()
-{
-	for (int towerIndex = (int)m_towers.size() - 1; towerIndex >= 0; towerIndex--)
-	{
-		delete m_towers[towerIndex];
-		m_towers[towerIndex] = nullptr;
-	}
-	m_towers.clear();
-}
+	delete m_cloudSystem;
+	m_cloudSystem = nullptr;
 
-void Map::DeleteAllParticles()
-{
-	for (int particleIndex = 0; particleIndex < (int)m_particles.size(); particleIndex++)
-	{
-		delete m_particles[particleIndex];
-	}
-	m_particles.clear();
-}
+	delete m_towerRenderer;
+	m_towerRenderer = nullptr;
 
-void Map::DeleteDestroyedEnemies()
-{
-	for (int enemyIndex = 0; enemyIndex < (int)m_enemies.size(); enemyIndex++)
-	{
-		if (m_enemies[enemyIndex] && m_enemies[enemyIndex]->m_isDestroyed)
-		{
-			delete m_enemies[enemyIndex];
-			m_enemies[enemyIndex] = nullptr;
-			m_enemies.erase(m_enemies.begin() + enemyIndex);
-			enemyIndex--;
-		}
-	}
+	delete m_enemyRenderer;
+	m_enemyRenderer = nullptr;
 
-	if (m_remainingLives >= 0 && m_enemies.empty() && m_nextWaveIndex == (int)m_definition.m_waves.size())
-	{
-		g_audio->StartSound(m_levelCompleteSFX, false, m_game->m_sfxUserVolume);
+	delete m_healthBarRenderer;
+	m_healthBarRenderer = nullptr;
 
-		m_score /= m_numEnemiesInLevel;
-		m_stars = (int)GetClamped(float(m_score / 25), 0.f, 3.f);
-		g_app->m_showHandCursor = false;
-		m_levelCompletePopup->SetStars(m_stars)->SetVisible(true);
-		m_canTogglePause = false;
-		m_mapClock.Pause();
+	delete m_renderCommandList;
+	m_renderCommandList = nullptr;
 
-		m_game->SaveToFile();
-	}
+	delete m_renderStateCache;
+	m_renderStateCache = nullptr;
 }
 
-void Map::DeleteDestroyedParticles()
+
+
+void Map::DeleteAllParticles()
 {
-	for (int particleIndex = 0; particleIndex < (int)m_particles.size(); particleIndex++)
-	{
-		if (m_particles[particleIndex]->m_isDestroyed)
-		{
-			delete m_particles[particleIndex];
-			m_particles.erase(m_particles.begin() + particleIndex);
-			particleIndex--;
-		}
-	}
+	m_particleSystem->Clear();
 }
 
-Map::Map(Game* game, MapDefinition mapDef)
-	: m_game(game)
-	, m_definition(mapDef)
+
+Map::Map(Game* game, MapDefinition mapDef, bool isHeadless, bool allowCookedMapCache)
+	: MapSimulation(mapDef, game->m_jobSystem)
+	, m_game(game)
+	, m_isHeadless(isHeadless)
+	, m_allowCookedMapCache(allowCookedMapCache)
 	, m_mapClock(game->m_gameClock)
 	, m_moneyBlinkTimer(&m_mapClock, 2.f)
 {
-	g_audio->SetNumListeners(1);
 	m_fixedUpdateTimer = Stopwatch(&m_mapClock, FIXED_PHYSICS_TIMESTEP);
 	m_fixedUpdateTimer.Start();
 
+	m_particleSystem = new ParticleSystem(ParticleSystem::DEFAULT_CAPACITY);
+	m_cloudSystem = new CloudSystem();
+	m_towerRenderer = new InstancedModelRenderer();
+	m_enemyRenderer = new InstancedModelRenderer();
+	m_healthBarRenderer = new HealthBarRenderer();
+	m_renderCommandList = new RenderCommandList();
+	m_renderStateCache = new RenderStateCache();
+
+	// Headless maps keep the simulation's null events, so nothing the simulation does reaches audio, particles or the UI
+	if (m_isHeadless)
+	{
+		LoadOrCookMap();
+		return;
+	}
+
+	m_events = this;
+	g_audio->SetNumListeners(1);
 	LoadAssets();
-	Initialize();
+	LoadOrCookMap();
 	GenerateClouds();
+	CreateUI();
+}
 
+void Map::CreateUI()
+{
 	Rgba8 transparentPrimaryColor = Rgba8(UI_PRIMARY_COLOR.r, UI_PRIMARY_COLOR.g, UI_PRIMARY_COLOR.b, 0);
 	Rgba8 translucentAccentColor = Rgba8(UI_ACCENT_COLOR.r, UI_ACCENT_COLOR.g, UI_ACCENT_COLOR.b, 185);
 	AABB2 screenBox(m_game->m_screenCamera.GetOrthoBottomLeft(), m_game->m_screenCamera.GetOrthoTopRight());
@@ -296,9 +282,6 @@ Map::Map(Game* game, MapDefinition mapDef)
 		SetClickEventName("ReturnToMenu")->
 		SetClickSFX(m_game->m_menuButtonSound);
 
-	m_money = m_definition.m_startingMoney;
-	m_remainingLives = m_definition.m_lives;
-
 	AABB2 imagePopupBounds(Vec2::ZERO, Vec2(SCREEN_SIZE_X * 0.6f, SCREEN_SIZE_X * 0.3f));
 	imagePopupBounds.SetCenter(screenBox.GetCenter());
 	for (int newEnemyIndex = 0; newEnemyIndex < (int)m_definition.m_newEnemies.size(); newEnemyIndex++)
@@ -415,328 +398,230 @@ void Map::LoadAssets()
 	m_coinTexture = g_renderer->CreateOrGetTextureFromFile("Data/Images/Coin.png");
 	m_healthTexture = g_renderer->CreateOrGetTextureFromFile("Data/Images/Health.png");
 	m_brokenHealthTexture = g_renderer->CreateOrGetTextureFromFile("Data/Images/Health_Broken.png");
-	m_cloudTexture1 = g_renderer->CreateOrGetTextureFromFile("Data/Images/cloud1.png");
-	m_cloudTexture2 = g_renderer->CreateOrGetTextureFromFile("Data/Images/cloud2.png");
-	m_cloudTexture3 = g_renderer->CreateOrGetTextureFromFile("Data/Images/cloud3.png");
-	m_cloudTexture4 = g_renderer->CreateOrGetTextureFromFile("Data/Images/cloud4.png");
+	for (int textureIndex = 0; textureIndex < CloudSystem::NUM_CLOUD_TEXTURES; textureIndex++)
+	{
+		m_cloudSystem->m_textures[textureIndex] = g_renderer->CreateOrGetTextureFromFile(Stringf("Data/Images/cloud%d.png", textureIndex + 1).c_str());
+	}
 
 	m_enemyGoalSFX = g_audio->CreateOrGetSound("Data/Audio/EnemyGoalSFX.ogg", true);
 	m_levelFailedSFX = g_audio->CreateOrGetSound("Data/Audio/LevelFailed.wav");
 	m_levelCompleteSFX = g_audio->CreateOrGetSound("Data/Audio/LevelComplete.ogg");
 	m_towerPlacedSound = g_audio->CreateOrGetSound("Data/Audio/TowerPlace.wav", true);
+	m_enemyDeathSFX = g_audio->CreateOrGetSound("Data/Audio/EnemyDeath.wav", true);
+	for (auto towerDefIter = TowerDefinition::s_towerDefs.begin(); towerDefIter != TowerDefinition::s_towerDefs.end(); ++towerDefIter)
+	{
+		if (!towerDefIter->second.m_fireSoundPath.empty())
+		{
+			m_towerFireSounds[towerDefIter->first] = g_audio->CreateOrGetSound(towerDefIter->second.m_fireSoundPath, true);
+		}
+	}
 }
 
-void Map::Initialize()
+// Blocks and the heat map come from the cooked map cache when it is allowed and current, and are cooked from the map image otherwise
+void Map::LoadOrCookMap()
 {
-	Image mapImage = Image(m_definition.m_mapImageName.c_str());
-	m_dimensions = mapImage.GetDimensions();
+	double initializeStartTime = GetCurrentTimeSeconds();
+	bool usePackedMapVertexes = g_gameConfigBlackboard.GetValue("packedMapVertexes", true);
 
-	std::vector<Vertex_PCUTBN> vertexes;
-	int numBlocks = m_dimensions.x * m_dimensions.y;
-	m_blocks = new Block[numBlocks];
-	Vec2 mapCenter = Vec2((float)m_dimensions.y * 0.5f, (float)m_dimensions.x * 0.5f);
-	for (int blockIndex = 0; blockIndex < numBlocks; blockIndex++)
+	// Headless maps never build a mesh, so only rendered maps read or write the cooked cache
+	CookedMap cookedMap;
+	std::string cookedMapPath = CookedMap::GetFilePath(m_definition.m_name);
+	uint32_t cookedMapKey = 0;
+	bool useCookedMapCache = m_allowCookedMapCache && !m_isHeadless && g_gameConfigBlackboard.GetValue("cookedMapCache", true);
+	if (useCookedMapCache)
 	{
-		IntVec2 blockCoords = GetBlockCoordsFromIndex(blockIndex);
-		Block block = Block(this, mapImage.GetTexelColor(blockCoords));
+		cookedMapKey = CookedMap::ComputeKey(m_definition.m_mapImageName, m_definition.m_decorationSeed, usePackedMapVertexes);
+		m_wasLoadedFromCookedMap = cookedMap.LoadFromFile(cookedMapPath, cookedMapKey);
+	}
 
-		if (block.CanPlaceTower() && GetDistanceSquared2D(mapCenter, GetBlockCoordsFromIndex(blockIndex).GetAsVec2()) >= 100.f)
+	if (m_wasLoadedFromCookedMap)
+	{
+		m_dimensions = cookedMap.m_dimensions;
+		m_blocks = Grid<Block>(m_dimensions);
+		for (int blockY = 0; blockY < m_dimensions.y; blockY++)
 		{
-			BlockDefinition newBlockDef = BlockDefinition::s_blockDefs["Rock"];
-
-			if (g_RNG->RollRandomChance(0.25f))
-			{
-				newBlockDef = BlockDefinition::s_blockDefs["Tree"];
-			}
-			else if (g_RNG->RollRandomChance(0.25f))
-			{
-				newBlockDef = BlockDefinition::s_blockDefs["TreeDouble"];
-			}
-			else if (g_RNG->RollRandomChance(0.25f))
+			for (int blockX = 0; blockX < m_dimensions.x; blockX++)
 			{
-				newBlockDef = BlockDefinition::s_blockDefs["TreeQuad"];
+				m_blocks.Get(IntVec2(blockX, blockY)) = Block(cookedMap.m_blockTypeIDs[blockX + m_dimensions.x * blockY]);
 			}
-			else if (g_RNG->RollRandomChance(0.25f))
-			{
-				newBlockDef = BlockDefinition::s_blockDefs["Crystal"];
-			}
-
-			block.m_definition = newBlockDef;
 		}
-
-		m_blocks[blockIndex] = block;
-
-		if (block.IsStartBlock())
-		{
-			m_startBlocks.push_back(blockCoords);
-		}
-		else if (block.IsEndBlock())
-		{
-			m_endBlocks.push_back(blockCoords);
-		}
-		else if (block.IsTree())
-		{
-			m_treeBlocks.push_back(blockCoords);
-		}
-		else if (block.IsCrystal())
-		{
-			m_crystalBlocks.push_back(blockCoords);
-		}
-	}
-
-	if (m_startBlocks.empty())
-	{
-		ERROR_AND_DIE("Attempted to initialize map with no start blocks!");
-	}
-
-	if (m_endBlocks.empty())
-	{
-		ERROR_AND_DIE("Attempted to intialize map with no end blocks!");
 	}
-
-	for (int blockIndex = 0; blockIndex < numBlocks; blockIndex++)
+	else
 	{
-		IntVec2 blockCoords = GetBlockCoordsFromIndex(blockIndex);
-		Block block = m_blocks[blockIndex];
-		block.AddVerts(vertexes, Vec3((float)blockCoords.x + 0.5f, (float)blockCoords.y + 0.5f, -0.2f));
+		DecodeMapImage();
 	}
-	
-	m_game->m_cameraPosition = Vec3(0.f, m_dimensions.y * 0.5f, 5.f);
-	m_game->m_cameraOrientation = EulerAngles(0.f, 15.f, 0.f);
 
-	m_vertexBuffer = g_renderer->CreateVertexBuffer(vertexes.size() * sizeof(Vertex_PCUTBN), VertexType::VERTEX_PCUTBN);
-	g_renderer->CopyCPUToGPU(reinterpret_cast<void*>(vertexes.data()), m_vertexBuffer->m_size, m_vertexBuffer);
+	InitializeBlockLists();
 
-	// Generate HeatMap
-	constexpr float HEATMAP_MAX_COST = 99999.f;
-	std::vector<float> heatValues(numBlocks, HEATMAP_MAX_COST);
-	std::queue<IntVec2> nextBlocks;
-	for (int blockIndex = 0; blockIndex < numBlocks; blockIndex++)
+	if (!m_isHeadless)
 	{
-		Block const& block = m_blocks[blockIndex];
-		if (block.IsEndBlock())
+		// A loaded file already has its views, pointing into the file contents, so its chunks are uploaded without another copy
+		if (!m_wasLoadedFromCookedMap)
 		{
-			IntVec2 blockCoords = GetBlockCoordsFromIndex(blockIndex);
-			heatValues[blockIndex] = 0.f;
-			nextBlocks.push(blockCoords);
+			MapMesh::CookChunks(m_blocks, m_jobSystem, usePackedMapVertexes, cookedMap.m_chunks);
+			MapMesh::GetChunkViews(cookedMap.m_chunks, cookedMap.m_chunkViews);
 		}
+		CreateRenderResources(cookedMap.m_chunkViews);
+
+		m_game->m_cameraPosition = Vec3(0.f, m_dimensions.y * 0.5f, 5.f);
+		m_game->m_cameraOrientation = EulerAngles(0.f, 15.f, 0.f);
 	}
 
-	while (!nextBlocks.empty())
+	if (m_wasLoadedFromCookedMap)
 	{
-		IntVec2 currentBlockCoords = nextBlocks.front();
-		int currentBlockIndex = GetBlockIndexFromCoords(currentBlockCoords);
-		nextBlocks.pop();
-
-		{
-			IntVec2 southBlockCoords = currentBlockCoords + IntVec2::SOUTH;
-			int southBlockIndex = GetBlockIndexFromCoords(southBlockCoords);
-			Block const& southBlock = m_blocks[southBlockIndex];
-			if (southBlockCoords.y >= 0 && heatValues[southBlockIndex] > heatValues[currentBlockIndex] + 1.f && southBlock.IsEnemyTraversable())
-			{
-				heatValues[southBlockIndex] = heatValues[currentBlockIndex] + 1.f;
-				nextBlocks.push(southBlockCoords);
-			}
-		}
-
-		{
-			IntVec2 northBlockCoords = currentBlockCoords + IntVec2::NORTH;
-			int northBlockIndex = GetBlockIndexFromCoords(northBlockCoords);
-			Block const& northBlock = m_blocks[northBlockIndex];
-			if (northBlockCoords.y < m_dimensions.y && heatValues[northBlockIndex] > heatValues[currentBlockIndex] + 1.f && northBlock.IsEnemyTraversable())
-			{
-				heatValues[northBlockIndex] = heatValues[currentBlockIndex] + 1.f;
-				nextBlocks.push(northBlockCoords);
-			}
-		}
-
+		m_heatMap = Grid<float>(m_dimensions, 0.f, -1.f);
+		for (int blockY = 0; blockY < m_dimensions.y; blockY++)
 		{
-			IntVec2 eastBlockCoords = currentBlockCoords + IntVec2::EAST;
-			int eastBlockIndex = GetBlockIndexFromCoords(eastBlockCoords);
-			Block const& eastBlock = m_blocks[eastBlockIndex];
-			if (eastBlockCoords.x < m_dimensions.x && heatValues[eastBlockIndex] > heatValues[currentBlockIndex] + 1.f && eastBlock.IsEnemyTraversable())
+			for (int blockX = 0; blockX < m_dimensions.x; blockX++)
 			{
-				heatValues[eastBlockIndex] = heatValues[currentBlockIndex] + 1.f;
-				nextBlocks.push(eastBlockCoords);
+				m_heatMap.Get(IntVec2(blockX, blockY)) = cookedMap.m_heatValues[blockX + m_dimensions.x * blockY];
 			}
 		}
+	}
+	else
+	{
+		ComputeHeatMap(m_blocks, m_heatMap);
+	}
+	GenerateFlowField();
 
+	// Writing the cache is part of the load that cooks the map, but is timed on its own so it can be told apart from the cooking
+	if (useCookedMapCache && !m_wasLoadedFromCookedMap)
+	{
+		double cookedMapWriteStartTime = GetCurrentTimeSeconds();
+		cookedMap.m_dimensions = m_dimensions;
+		cookedMap.m_blockTypeIDs.reserve(m_dimensions.x * m_dimensions.y);
+		cookedMap.m_heatValues.reserve(m_dimensions.x * m_dimensions.y);
+		for (int blockY = 0; blockY < m_dimensions.y; blockY++)
 		{
-			IntVec2 westBlockCoords = currentBlockCoords + IntVec2::WEST;
-			int westBlockIndex = GetBlockIndexFromCoords(westBlockCoords);
-			Block const& westBlock = m_blocks[westBlockIndex];
-			if (westBlockCoords.x >= 0 && heatValues[westBlockIndex] > heatValues[currentBlockIndex] + 1.f && westBlock.IsEnemyTraversable())
+			for (int blockX = 0; blockX < m_dimensions.x; blockX++)
 			{
-				heatValues[westBlockIndex] = heatValues[currentBlockIndex] + 1.f;
-				nextBlocks.push(westBlockCoords);
+				cookedMap.m_blockTypeIDs.push_back(m_blocks.Get(IntVec2(blockX, blockY)).m_typeID);
+				cookedMap.m_heatValues.push_back(m_heatMap.Get(IntVec2(blockX, blockY)));
 			}
 		}
+		cookedMap.SaveToFile(cookedMapPath, cookedMapKey);
+		m_cookedMapWriteSeconds = GetCurrentTimeSeconds() - cookedMapWriteStartTime;
 	}
 
-	m_heatMap = new TileHeatMap(m_dimensions);
-	m_heatMap->SetAllValues(heatValues);
+	m_initializeSeconds = GetCurrentTimeSeconds() - initializeStartTime;
+}
+
+// Everything Render draws from that lives for the whole map, created through g_renderBackend
+// Headless maps skip this, but render budget checks call it on one so a map can be rendered without its UI, audio or assets
+void Map::CreateRenderResources(std::vector<CookedMapChunkView> const& cookedChunks)
+{
+	m_mapMesh = new MapMesh();
+	m_mapMesh->Upload(cookedChunks);
+
+	// The sky box and tower range indicator never change, so they live on the GPU for the lifetime of the map
+	std::vector<Vertex_PCU> skyVerts;
+	AddVertsForSky(skyVerts);
+	m_numSkyVerts = (int)skyVerts.size();
+	m_skyVertexBuffer = g_renderBackend->CreateVertexBuffer(skyVerts.size() * sizeof(Vertex_PCU));
+	CopyCPUToGPU(skyVerts.data(), skyVerts.size() * sizeof(Vertex_PCU), m_skyVertexBuffer);
+
+	std::vector<Vertex_PCUTBN> rangeIndicatorVerts;
+	AddVertsForCylinder3D(rangeIndicatorVerts, Vec3::ZERO, Vec3::SKYWARD * 0.001f, 1.f, Rgba8(255, 255, 255, 127), AABB2::ZERO_TO_ONE, 32);
+	m_numRangeIndicatorVerts = (int)rangeIndicatorVerts.size();
+	m_rangeIndicatorVertexBuffer = g_renderBackend->CreateVertexBuffer(rangeIndicatorVerts.size() * sizeof(Vertex_PCUTBN), VertexType::VERTEX_PCUTBN);
+	CopyCPUToGPU(rangeIndicatorVerts.data(), rangeIndicatorVerts.size() * sizeof(Vertex_PCUTBN), m_rangeIndicatorVertexBuffer);
 
 	SetShaderConstants();
 }
 
+
+
+void Map::AddVertsForSky(std::vector<Vertex_PCU>& skyVerts) const
+{
+	AABB3 bounds(Vec3(-2.1f, -2.1f, -0.2f) * m_dimensions.GetAsVec2().ToVec3(1.f), Vec3(3.1f, 3.1f, 30.f) * m_dimensions.GetAsVec2().ToVec3(1.f));
+	Vec3 const& mins = bounds.m_mins;
+	Vec3 const& maxs = bounds.m_maxs;
+
+	Vec3 BLF = Vec3(mins.x, maxs.y, mins.z);
+	Vec3 BRF = Vec3(mins.x, mins.y, mins.z);
+	Vec3 TRF = Vec3(mins.x, mins.y, maxs.z);
+	Vec3 TLF = Vec3(mins.x, maxs.y, maxs.z);
+	Vec3 BLB = Vec3(maxs.x, maxs.y, mins.z);
+	Vec3 BRB = Vec3(maxs.x, mins.y, mins.z);
+	Vec3 TRB = Vec3(maxs.x, mins.y, maxs.z);
+	Vec3 TLB = Vec3(maxs.x, maxs.y, maxs.z);
+
+	AddVertsForGradientQuad3D(skyVerts, BRB, BLB, TLB, TRB, Rgba8(68, 181, 141, 255), Rgba8(68, 181, 141, 255), Rgba8::DEEP_SKY_BLUE, Rgba8::DEEP_SKY_BLUE); // +X
+	AddVertsForGradientQuad3D(skyVerts, BLF, BRF, TRF, TLF, Rgba8(68, 181, 141, 255), Rgba8(68, 181, 141, 255), Rgba8::DEEP_SKY_BLUE, Rgba8::DEEP_SKY_BLUE); // -X
+	AddVertsForGradientQuad3D(skyVerts, BLB, BLF, TLF, TLB, Rgba8(68, 181, 141, 255), Rgba8(68, 181, 141, 255), Rgba8::DEEP_SKY_BLUE, Rgba8::DEEP_SKY_BLUE); // +Y
+	AddVertsForGradientQuad3D(skyVerts, BRF, BRB, TRB, TRF, Rgba8(68, 181, 141, 255), Rgba8(68, 181, 141, 255), Rgba8::DEEP_SKY_BLUE, Rgba8::DEEP_SKY_BLUE); // -Y
+	//AddVertsForGradientQuad3D(skyVerts, TLF, TRF, TRB, TLB, Rgba8::GREEN, Rgba8::GREEN, Rgba8::BLUE, Rgba8::BLUE); // +Z
+	AddVertsForQuad3D(skyVerts, BLB, BRB, BRF, BLF, Rgba8(68, 181, 141, 255)); // -Z
+}
+
+
 void Map::GenerateClouds()
 {
 	constexpr int CLOUDS_PER_FACE = 20;
-	constexpr float CLOUD_MAX_SPEED = 0.01f;
+	constexpr float CLOUD_MAX_SPEED = 0.5f;
 
-	for (int cloudIndex = 0; cloudIndex < CLOUDS_PER_FACE; cloudIndex++)
+	float dimX = (float)m_dimensions.x;
+	float dimY = (float)m_dimensions.y;
+	m_cloudSystem->m_wrapMins = Vec2(-dimX * 2.f, -dimY * 2.f);
+	m_cloudSystem->m_wrapMaxs = Vec2(dimX * 3.f, dimY * 3.f);
+
+	// Each texture gets a 25% roll in turn and the last texture takes whatever is left
+	auto rollCloudTextureIndex = []()
 	{
-		Cloud cloud;
-		cloud.m_position = Vec3(g_RNG->RollRandomFloatInRange((float)m_dimensions.x * 2.f, (float)m_dimensions.x * 3.f), g_RNG->RollRandomFloatInRange(-(float)m_dimensions.y * 1.f, (float)m_dimensions.y * 2.f), g_RNG->RollRandomFloatInRange(0.f, 30.f));
-		cloud.m_velocity = Vec3(0.f, g_RNG->RollRandomFloatInRange(-CLOUD_MAX_SPEED, CLOUD_MAX_SPEED), 0.f);
-		if (g_RNG->RollRandomChance(0.25f))
+		for (int textureIndex = 0; textureIndex < CloudSystem::NUM_CLOUD_TEXTURES - 1; textureIndex++)
 		{
-			cloud.m_texture = m_cloudTexture1;
-			m_cloudsWithTexture1.push_back(cloud);
-		}
-		else if (g_RNG->RollRandomChance(0.25f))
-		{
-			cloud.m_texture = m_cloudTexture2;
-			m_cloudsWithTexture2.push_back(cloud);
-		}
-		else if (g_RNG->RollRandomChance(0.25f))
-		{
-			cloud.m_texture = m_cloudTexture3;
-			m_cloudsWithTexture3.push_back(cloud);
-		}
-		else
-		{
-			cloud.m_texture = m_cloudTexture4;
-			m_cloudsWithTexture4.push_back(cloud);
+			if (g_RNG->RollRandomChance(0.25f))
+			{
+				return textureIndex;
+			}
 		}
+		return CloudSystem::NUM_CLOUD_TEXTURES - 1;
+	};
 
-		//m_clouds.push_back(cloud);
+	for (int cloudIndex = 0; cloudIndex < CLOUDS_PER_FACE; cloudIndex++)
+	{
+		Vec3 position = Vec3(g_RNG->RollRandomFloatInRange(dimX * 2.f, dimX * 3.f), g_RNG->RollRandomFloatInRange(-dimY * 1.f, dimY * 2.f), g_RNG->RollRandomFloatInRange(0.f, 30.f));
+		Vec3 velocity = Vec3(0.f, g_RNG->RollRandomFloatInRange(-CLOUD_MAX_SPEED, CLOUD_MAX_SPEED), 0.f);
+		m_cloudSystem->AddCloud(position, velocity, rollCloudTextureIndex());
 	}
 
 	for (int cloudIndex = 0; cloudIndex < CLOUDS_PER_FACE; cloudIndex++)
 	{
-		Cloud cloud;
-		cloud.m_position = Vec3(-g_RNG->RollRandomFloatInRange((float)m_dimensions.x * 1.f, (float)m_dimensions.x * 2.f), g_RNG->RollRandomFloatInRange(-(float)m_dimensions.y * 2.f, (float)m_dimensions.y * 2.f), g_RNG->RollRandomFloatInRange(0.f, 30.f));
-		cloud.m_velocity = Vec3(0.f, g_RNG->RollRandomFloatInRange(-CLOUD_MAX_SPEED, CLOUD_MAX_SPEED), 0.f);
-		if (g_RNG->RollRandomChance(0.25f))
-		{
-			cloud.m_texture = m_cloudTexture1;
-			m_cloudsWithTexture1.push_back(cloud);
-		}
-		else if (g_RNG->RollRandomChance(0.25f))
-		{
-			cloud.m_texture = m_cloudTexture2;
-			m_cloudsWithTexture2.push_back(cloud);
-		}
-		else if (g_RNG->RollRandomChance(0.25f))
-		{
-			cloud.m_texture = m_cloudTexture3;
-			m_cloudsWithTexture3.push_back(cloud);
-		}
-		else
-		{
-			cloud.m_texture = m_cloudTexture4;
-			m_cloudsWithTexture4.push_back(cloud);
-		}
-
-		//m_clouds.push_back(cloud);
+		Vec3 position = Vec3(-g_RNG->RollRandomFloatInRange(dimX * 1.f, dimX * 2.f), g_RNG->RollRandomFloatInRange(-dimY * 2.f, dimY * 2.f), g_RNG->RollRandomFloatInRange(0.f, 30.f));
+		Vec3 velocity = Vec3(0.f, g_RNG->RollRandomFloatInRange(-CLOUD_MAX_SPEED, CLOUD_MAX_SPEED), 0.f);
+		m_cloudSystem->AddCloud(position, velocity, rollCloudTextureIndex());
 	}
 
 	for (int cloudIndex = 0; cloudIndex < CLOUDS_PER_FACE; cloudIndex++)
 	{
-		Cloud cloud;
-		cloud.m_position = Vec3(g_RNG->RollRandomFloatInRange(-(float)m_dimensions.x * 1.f, (float)m_dimensions.x * 2.f), g_RNG->RollRandomFloatInRange((float)m_dimensions.y * 2.f, (float)m_dimensions.y * 3.f), g_RNG->RollRandomFloatInRange(0.f, 30.f));
-		cloud.m_velocity = Vec3(g_RNG->RollRandomFloatInRange(-CLOUD_MAX_SPEED, CLOUD_MAX_SPEED), 0.f, 0.f);
-		if (g_RNG->RollRandomChance(0.25f))
-		{
-			cloud.m_texture = m_cloudTexture1;
-			m_cloudsWithTexture1.push_back(cloud);
-		}
-		else if (g_RNG->RollRandomChance(0.25f))
-		{
-			cloud.m_texture = m_cloudTexture2;
-			m_cloudsWithTexture2.push_back(cloud);
-		}
-		else if (g_RNG->RollRandomChance(0.25f))
-		{
-			cloud.m_texture = m_cloudTexture3;
-			m_cloudsWithTexture3.push_back(cloud);
-		}
-		else
-		{
-			cloud.m_texture = m_cloudTexture4;
-			m_cloudsWithTexture4.push_back(cloud);
-		}
-
-		//m_clouds.push_back(cloud);
+		Vec3 position = Vec3(g_RNG->RollRandomFloatInRange(-dimX * 1.f, dimX * 2.f), g_RNG->RollRandomFloatInRange(dimY * 2.f, dimY * 3.f), g_RNG->RollRandomFloatInRange(0.f, 30.f));
+		Vec3 velocity = Vec3(g_RNG->RollRandomFloatInRange(-CLOUD_MAX_SPEED, CLOUD_MAX_SPEED), 0.f, 0.f);
+		m_cloudSystem->AddCloud(position, velocity, rollCloudTextureIndex());
 	}
 
 	for (int cloudIndex = 0; cloudIndex < CLOUDS_PER_FACE; cloudIndex++)
 	{
-		Cloud cloud;
-		cloud.m_position = Vec3(g_RNG->RollRandomFloatInRange(-(float)m_dimensions.x * 2.f, (float)m_dimensions.x * 2.f), -g_RNG->RollRandomFloatInRange((float)m_dimensions.y * 1.f, (float)m_dimensions.y * 2.f), g_RNG->RollRandomFloatInRange(0.f, 30.f));
-		cloud.m_velocity = Vec3(g_RNG->RollRandomFloatInRange(-CLOUD_MAX_SPEED, CLOUD_MAX_SPEED), 0.f, 0.f);
-		if (g_RNG->RollRandomChance(0.25f))
-		{
-			cloud.m_texture = m_cloudTexture1;
-			m_cloudsWithTexture1.push_back(cloud);
-		}
-		else if (g_RNG->RollRandomChance(0.25f))
-		{
-			cloud.m_texture = m_cloudTexture2;
-			m_cloudsWithTexture2.push_back(cloud);
-		}
-		else if (g_RNG->RollRandomChance(0.25f))
-		{
-			cloud.m_texture = m_cloudTexture3;
-			m_cloudsWithTexture3.push_back(cloud);
-		}
-		else
-		{
-			cloud.m_texture = m_cloudTexture4;
-			m_cloudsWithTexture4.push_back(cloud);
-		}
-
-		//m_clouds.push_back(cloud);
+		Vec3 position = Vec3(g_RNG->RollRandomFloatInRange(-dimX * 2.f, dimX * 2.f), -g_RNG->RollRandomFloatInRange(dimY * 1.f, dimY * 2.f), g_RNG->RollRandomFloatInRange(0.f, 30.f));
+		Vec3 velocity = Vec3(g_RNG->RollRandomFloatInRange(-CLOUD_MAX_SPEED, CLOUD_MAX_SPEED), 0.f, 0.f);
+		m_cloudSystem->AddCloud(position, velocity, rollCloudTextureIndex());
 	}
 
 	for (int cloudIndex = 0; cloudIndex < CLOUDS_PER_FACE; cloudIndex++)
 	{
-		Cloud cloud;
-		cloud.m_billboardType = BillboardType::FULL_FACING;
-		cloud.m_position = Vec3(g_RNG->RollRandomFloatInRange(-(float)m_dimensions.x * 2.f, (float)m_dimensions.x * 2.f), g_RNG->RollRandomFloatInRange(-(float)m_dimensions.y * 2.f, (float)m_dimensions.y * 2.f), g_RNG->RollRandomFloatInRange(15.f, 30.f));
-		if (g_RNG->RollRandomChance(0.25f))
-		{
-			cloud.m_texture = m_cloudTexture1;
-			m_cloudsWithTexture1.push_back(cloud);
-		}
-		else if (g_RNG->RollRandomChance(0.25f))
-		{
-			cloud.m_texture = m_cloudTexture2;
-			m_cloudsWithTexture2.push_back(cloud);
-		}
-		else if (g_RNG->RollRandomChance(0.25f))
-		{
-			cloud.m_texture = m_cloudTexture3;
-			m_cloudsWithTexture3.push_back(cloud);
-		}
-		else
-		{
-			cloud.m_texture = m_cloudTexture4;
-			m_cloudsWithTexture4.push_back(cloud);
-		}
-
-		//m_clouds.push_back(cloud);
+		Vec3 position = Vec3(g_RNG->RollRandomFloatInRange(-dimX * 2.f, dimX * 2.f), g_RNG->RollRandomFloatInRange(-dimY * 2.f, dimY * 2.f), g_RNG->RollRandomFloatInRange(15.f, 30.f));
+		m_cloudSystem->AddCloud(position, Vec3::ZERO, rollCloudTextureIndex(), BillboardType::FULL_FACING);
 	}
+
+	m_cloudSystem->SortByTexture();
 }
 
 void Map::SetShaderConstants()
 {
-	m_reyTDConstantBuffer = g_renderer->CreateConstantBuffer(sizeof(ReyTDShaderConstants));
+	m_reyTDConstantBuffer = g_renderBackend->CreateConstantBuffer(sizeof(ReyTDShaderConstants));
 	ReyTDShaderConstants reyTDShaderConstants;
 	Rgba8(68, 181, 141, 255).GetAsFloats(reyTDShaderConstants.m_skyColor);
 	reyTDShaderConstants.m_mapCenter = Vec4(m_dimensions.x * 0.5f, m_dimensions.y * 0.5f, 0.f, 1.f);
-	g_renderer->CopyCPUToGPU(&reyTDShaderConstants, sizeof(reyTDShaderConstants), m_reyTDConstantBuffer);
+	CopyCPUToGPU(&reyTDShaderConstants, sizeof(reyTDShaderConstants), m_reyTDConstantBuffer);
 }
 
 void Map::Update()
@@ -757,6 +642,7 @@ void Map::Update()
 
 	while (m_fixedUpdateTimer.DecrementDurationIfElapsed())
 	{
+		FixedUpdateAmbience();
 		FixedUpdate(FIXED_PHYSICS_TIMESTEP);
 	}
 
@@ -788,7 +674,6 @@ void Map::Update()
 	UpdateEnemies();
 	UpdateParticles();
 	DeleteDestroyedEnemies();
-	DeleteDestroyedParticles();
 }
 
 void Map::UpdateInput()
@@ -900,14 +785,15 @@ void Map::UpdateInput()
 		if (GetDistanceSquared2D(mapCenter, impactBlockCoords.GetAsVec2()) < 100.f)
 		{
 			int impactBlockIndex = GetBlockIndexFromCoords(impactBlockCoords);
+			Tower* impactTower = GetTowerAtBlock(impactBlockIndex);
 
 			m_higlightPosition = impactBlockCoords.GetAsVec2().ToVec3(0.001f);
-			if (m_blocks[impactBlockIndex].CanPlaceTower() && !m_blocks[impactBlockIndex].m_tower)
+			if (m_blocks[impactBlockIndex].CanPlaceTower() && !impactTower)
 			{
 				m_canPlaceTower = true;
 				g_app->m_showHandCursor = true;
 			}
-			else if (m_blocks[impactBlockIndex].m_tower)
+			else if (impactTower)
 			{
 				g_app->m_showHandCursor = true;
 			}
@@ -962,14 +848,14 @@ void Map::UpdateInput()
 			int blockIndex = GetBlockIndexFromCoords(blockCoords);
 			if (GetDistanceSquared2D(mapCenter, blockCoords.GetAsVec2()) < 100.f)
 			{
-				if (!m_selectedTower.empty() && m_blocks[blockIndex].CanPlaceTower() && !m_blocks[blockIndex].m_tower)
+				Tower* blockTower = GetTowerAtBlock(blockIndex);
+				if (!m_selectedTower.empty() && m_blocks[blockIndex].CanPlaceTower() && !blockTower)
 				{
-					Tower* tower = SpawnTower(m_selectedTower, m_higlightPosition + Vec3(0.5f, 0.5f, 0.f));
-					m_blocks[blockIndex].m_tower = tower;					
+					PlaceTowerAtBlock(m_selectedTower, blockCoords);
 				}
-				else if (m_blocks[blockIndex].m_tower)
+				else if (blockTower)
 				{
-					m_blocks[blockIndex].m_tower->m_isSelected = !m_blocks[blockIndex].m_tower->m_isSelected;
+					blockTower->m_isSelected = !blockTower->m_isSelected;
 					m_selectedTower = "";
 					m_game->m_gameButtons[m_selectedTowerButtonIndex]->SetBackgroundColor(UI_ACCENT_COLOR);
 				}
@@ -990,124 +876,20 @@ void Map::UpdateTowers()
 
 void Map::UpdateEnemies()
 {
-	for (int enemyIndex = 0; enemyIndex < (int)m_enemies.size(); enemyIndex++)
+	for (int enemyIndex = 0; enemyIndex < m_enemies.GetCount(); enemyIndex++)
 	{
-		if (m_enemies[enemyIndex])
-		{
-			m_enemies[enemyIndex]->Update();
-		}
+		m_enemies[enemyIndex]->Update();
 	}
 }
 
 void Map::UpdateParticles()
 {
-	float deltaSeconds = m_mapClock.GetDeltaSeconds();
-
-	for (int particleIndex = 0; particleIndex < (int)m_particles.size(); particleIndex++)
-	{
-		m_particles[particleIndex]->Update(deltaSeconds);
-	}
+	m_particleSystem->Update(m_mapClock.GetDeltaSeconds());
 }
 
-void Map::FixedUpdate(float deltaSeconds)
-{
-	if (m_mapClock.IsPaused())
-	{
-		return;
-	}
-
-	for (int cloudIndex = 0; cloudIndex < (int)m_cloudsWithTexture1.size(); cloudIndex++)
-	{
-		Cloud& cloud = m_cloudsWithTexture1[cloudIndex];
-		cloud.m_position += cloud.m_velocity * deltaSeconds;
-
-		if (cloud.m_position.x > (float)m_dimensions.x * 3.f && cloud.m_velocity.x > 0.f)
-		{
-			cloud.m_position.x = -(float)m_dimensions.x * 2.f;
-		}
-		if (cloud.m_position.x < (float)m_dimensions.x * 1.f && cloud.m_velocity.x < 0.f)
-		{
-			cloud.m_position.x = (float)m_dimensions.x * 3.f;
-		}
-		if (cloud.m_position.y > (float)m_dimensions.y * 3.f && cloud.m_velocity.y > 0.f)
-		{
-			cloud.m_position.y = -(float)m_dimensions.y * 2.f;
-		}
-		if (cloud.m_position.y < (float)m_dimensions.y * 1.f && cloud.m_velocity.y < 0.f)
-		{
-			cloud.m_position.y = (float)m_dimensions.y * 3.f;
-		}
-	}
-
-	for (int cloudIndex = 0; cloudIndex < (int)m_cloudsWithTexture2.size(); cloudIndex++)
-	{
-		Cloud& cloud = m_cloudsWithTexture2[cloudIndex];
-		cloud.m_position += cloud.m_velocity;
-
-		if (cloud.m_position.x > (float)m_dimensions.x * 3.f && cloud.m_velocity.x > 0.f)
-		{
-			cloud.m_position.x = -(float)m_dimensions.x * 2.f;
-		}
-		if (cloud.m_position.x < (float)m_dimensions.x * 1.f && cloud.m_velocity.x < 0.f)
-		{
-			cloud.m_position.x = (float)m_dimensions.x * 3.f;
-		}
-		if (cloud.m_position.y > (float)m_dimensions.y * 3.f && cloud.m_velocity.y > 0.f)
-		{
-			cloud.m_position.y = -(float)m_dimensions.y * 2.f;
-		}
-		if (cloud.m_position.y < (float)m_dimensions.y * 1.f && cloud.m_velocity.y < 0.f)
-		{
-			cloud.m_position.y = (float)m_dimensions.y * 3.f;
-		}
-	}
-
-	for (int cloudIndex = 0; cloudIndex < (int)m_cloudsWithTexture3.size(); cloudIndex++)
-	{
-		Cloud& cloud = m_cloudsWithTexture3[cloudIndex];
-		cloud.m_position += cloud.m_velocity;
-
-		if (cloud.m_position.x > (float)m_dimensions.x * 3.f && cloud.m_velocity.x > 0.f)
-		{
-			cloud.m_position.x = -(float)m_dimensions.x * 2.f;
-		}
-		if (cloud.m_position.x < (float)m_dimensions.x * 1.f && cloud.m_velocity.x < 0.f)
-		{
-			cloud.m_position.x = (float)m_dimensions.x * 3.f;
-		}
-		if (cloud.m_position.y > (float)m_dimensions.y * 3.f && cloud.m_velocity.y > 0.f)
-		{
-			cloud.m_position.y = -(float)m_dimensions.y * 2.f;
-		}
-		if (cloud.m_position.y < (float)m_dimensions.y * 1.f && cloud.m_velocity.y < 0.f)
-		{
-			cloud.m_position.y = (float)m_dimensions.y * 3.f;
-		}
-	}
-
-	for (int cloudIndex = 0; cloudIndex < (int)m_cloudsWithTexture4.size(); cloudIndex++)
-	{
-		Cloud& cloud = m_cloudsWithTexture4[cloudIndex];
-		cloud.m_position += cloud.m_velocity;
-
-		if (cloud.m_position.x > (float)m_dimensions.x * 3.f && cloud.m_velocity.x > 0.f)
-		{
-			cloud.m_position.x = -(float)m_dimensions.x * 2.f;
-		}
-		if (cloud.m_position.x < (float)m_dimensions.x * 1.f && cloud.m_velocity.x < 0.f)
-		{
-			cloud.m_position.x = (float)m_dimensions.x * 3.f;
-		}
-		if (cloud.m_position.y > (float)m_dimensions.y * 3.f && cloud.m_velocity.y > 0.f)
-		{
-			cloud.m_position.y = -(float)m_dimensions.y * 2.f;
-		}
-		if (cloud.m_position.y < (float)m_dimensions.y * 1.f && cloud.m_velocity.y < 0.f)
-		{
-			cloud.m_position.y = (float)m_dimensions.y * 3.f;
-		}
-	}
 
+void Map::FixedUpdateAmbience()
+{
 	// Wind
 	constexpr float MIN_WINDSPEED = 1.f;
 	constexpr float MAX_WINDSPEED = 2.f;
@@ -1169,225 +951,158 @@ void Map::FixedUpdate(float deltaSeconds)
 			SpawnParticle(particlePosition, particleVelocity, particleSize, particleLifetime, "CrystalParticle", Rgba8(255, 124, 168, 255), BlendMode::ALPHA);
 		}
 	}
-
-	m_fixedTimeForWaveSpawning += deltaSeconds;
-
-	if (!m_isWaveOngoing && m_nextWaveIndex < (int)m_definition.m_waves.size() && m_fixedTimeForWaveSpawning > m_definition.m_waves[m_nextWaveIndex].m_startTime)
-	{
-		Wave& wave = m_definition.m_waves[m_nextWaveIndex];
-		m_isWaveOngoing = true;
-		m_waveTimer = Stopwatch(&m_mapClock, wave.m_enemyInterval);
-		m_waveTimer.Start();
-		m_currentWaveIndex++;
-	}
-
-	if (m_isWaveOngoing)
-	{
-		while (m_waveTimer.DecrementDurationIfElapsed())
-		{
-			Wave const& wave = m_definition.m_waves[m_currentWaveIndex];
-			SpawnEnemy(wave.m_enemyNames[m_currentEnemyIndex], m_startBlocks[0].GetAsVec2().ToVec3() + Vec3::EAST * 0.5f + Vec3::NORTH * 0.5f);
-			m_currentEnemyIndex++;
-
-			if (m_currentEnemyIndex == (int)wave.m_enemyNames.size())
-			{
-				m_isWaveOngoing = false;
-				m_nextWaveIndex++;
-				m_waveTimer.Stop();
-				m_currentEnemyIndex = 0;
-			}
-		}
-	}
-
-	FixedUpdateEnemies(deltaSeconds);
-	FixedUpdateTowers(deltaSeconds);
 }
 
-void Map::FixedUpdateTowers(float deltaSeconds)
-{
-	for (int towerIndex = 0; towerIndex < (int)m_towers.size(); towerIndex++)
-	{
-		m_towers[towerIndex]->FixedUpdate(deltaSeconds);
-	}
-}
 
-void Map::FixedUpdateEnemies(float deltaSeconds)
-{
-	for (int enemyIndex = 0; enemyIndex < (int)m_enemies.size(); enemyIndex++)
-	{
-		if (m_enemies[enemyIndex])
-		{
-			m_enemies[enemyIndex]->FixedUpdate(deltaSeconds);
-		}
-	}
-}
 
 extern double g_mapRenderTime;
 
 void Map::Render() const
 {
-	// Render background
-	
 	double mapRenderStartTime = GetCurrentTimeSeconds();
 
-	std::vector<Vertex_PCU> gradientBackgroundVerts;
-	AABB3 bounds(Vec3(-2.1f, -2.1f, -0.2f) * m_dimensions.GetAsVec2().ToVec3(1.f), Vec3(3.1f, 3.1f, 30.f) * m_dimensions.GetAsVec2().ToVec3(1.f));
-	Vec3 const& mins = bounds.m_mins;
-	Vec3 const& maxs = bounds.m_maxs;
-
-	Vec3 BLF = Vec3(mins.x, maxs.y, mins.z);
-	Vec3 BRF = Vec3(mins.x, mins.y, mins.z);
-	Vec3 TRF = Vec3(mins.x, mins.y, maxs.z);
-	Vec3 TLF = Vec3(mins.x, maxs.y, maxs.z);
-	Vec3 BLB = Vec3(maxs.x, maxs.y, mins.z);
-	Vec3 BRB = Vec3(maxs.x, mins.y, mins.z);
-	Vec3 TRB = Vec3(maxs.x, mins.y, maxs.z);
-	Vec3 TLB = Vec3(maxs.x, maxs.y, maxs.z);
+	// Everything in the world is recorded first and submitted sorted by state, so the renderer only sees state changes
+	m_renderCommandList->Clear();
 
-	AddVertsForGradientQuad3D(gradientBackgroundVerts, BRB, BLB, TLB, TRB, Rgba8(68, 181, 141, 255), Rgba8(68, 181, 141, 255), Rgba8::DEEP_SKY_BLUE, Rgba8::DEEP_SKY_BLUE); // +X
-	AddVertsForGradientQuad3D(gradientBackgroundVerts, BLF, BRF, TRF, TLF, Rgba8(68, 181, 141, 255), Rgba8(68, 181, 141, 255), Rgba8::DEEP_SKY_BLUE, Rgba8::DEEP_SKY_BLUE); // -X
-	AddVertsForGradientQuad3D(gradientBackgroundVerts, BLB, BLF, TLF, TLB, Rgba8(68, 181, 141, 255), Rgba8(68, 181, 141, 255), Rgba8::DEEP_SKY_BLUE, Rgba8::DEEP_SKY_BLUE); // +Y
-	AddVertsForGradientQuad3D(gradientBackgroundVerts, BRF, BRB, TRB, TRF, Rgba8(68, 181, 141, 255), Rgba8(68, 181, 141, 255), Rgba8::DEEP_SKY_BLUE, Rgba8::DEEP_SKY_BLUE); // -Y
-	//AddVertsForGradientQuad3D(gradientBackgroundVerts, TLF, TRF, TRB, TLB, Rgba8::GREEN, Rgba8::GREEN, Rgba8::BLUE, Rgba8::BLUE); // +Z
-	AddVertsForQuad3D(gradientBackgroundVerts, BLB, BRB, BRF, BLF, Rgba8(68, 181, 141, 255)); // -Z
-
-	g_renderer->SetBlendMode(BlendMode::ALPHA);
-	g_renderer->SetDepthMode(DepthMode::ENABLED);
-	g_renderer->SetModelConstants();
-	g_renderer->SetRasterizerCullMode(RasterizerCullMode::CULL_NONE);
-	g_renderer->SetRasterizerFillMode(RasterizerFillMode::SOLID);
-	g_renderer->BindShader(nullptr);
-	g_renderer->BindTexture(nullptr);
-	g_renderer->SetSamplerMode(SamplerMode::POINT_CLAMP);
-	g_renderer->DrawVertexArray(gradientBackgroundVerts);
+	RenderCommand skyCommand;
+	skyCommand.m_state.m_pass = RenderPass::BACKGROUND;
+	skyCommand.m_state.m_blendMode = BlendMode::ALPHA;
+	skyCommand.m_vertexBuffer = m_skyVertexBuffer;
+	skyCommand.m_count = m_numSkyVerts;
+	m_renderCommandList->AddCommand(skyCommand);
 
 	RenderClouds();
 
+	m_mapMesh->CullChunks(m_game->m_worldCamera);
 	for (int shaderIndex = 0; shaderIndex < (int)m_definition.m_shaders.size(); shaderIndex++)
 	{
-		g_renderer->SetBlendMode(BlendMode::OPAQUE);
-		g_renderer->SetDepthMode(DepthMode::ENABLED);
-		g_renderer->SetModelConstants();
-		g_renderer->SetRasterizerCullMode(GetCullModeFromString(m_definition.m_cullModes[shaderIndex]));
-		g_renderer->SetRasterizerFillMode(RasterizerFillMode::SOLID);
-		g_renderer->BindShader(m_definition.m_shaders[shaderIndex]);
-		g_renderer->BindConstantBuffer(SHADER_RTD_CONSTANTS_SLOT, m_reyTDConstantBuffer);
-		g_renderer->BindTexture(nullptr);
-		g_renderer->SetLightConstants(m_definition.m_sunDirection, m_definition.m_sunIntensity, m_definition.m_ambientIntensity);
-		g_renderer->SetSamplerMode(SamplerMode::POINT_CLAMP);
-		g_renderer->DrawVertexBuffer(m_vertexBuffer, (int)m_vertexBuffer->m_size / sizeof(Vertex_PCUTBN));
-
-		RenderTowers();
-		RenderEnemies();
+		RenderState terrainState;
+		terrainState.m_shader = m_definition.m_shaders[shaderIndex];
+		terrainState.m_cullMode = GetCullModeFromString(m_definition.m_cullModes[shaderIndex]);
+		RenderState packedTerrainState = terrainState;
+		packedTerrainState.m_shader = m_definition.m_packedShaders[shaderIndex];
+		m_mapMesh->AddRenderCommands(*m_renderCommandList, terrainState, packedTerrainState);
 	}
 
-	std::vector<Vertex_PCUTBN> tileHighlightVerts;
-
-	Rgba8 selectedTowerColor = Rgba8(255, 255, 255, 127);
+	RenderTowers();
+	RenderEnemies();
 
 	if (!g_input->IsKeyDown(KEYCODE_RMB) && m_canPlaceTower && !m_selectedTower.empty())
 	{
-		//AddVertsForQuad3D(tileHighlightVerts, m_higlightPosition, m_higlightPosition + Vec3::EAST, m_higlightPosition + Vec3::EAST + Vec3::NORTH, m_higlightPosition + Vec3::NORTH, m_tileHightlightColor);
-		TowerDefinition selectedTowerDef = TowerDefinition::s_towerDefs[m_selectedTower];
+		// Preview the tower with its own GPU buffers instead of copying its meshes to the CPU every frame
+		TowerDefinition const& selectedTowerDef = TowerDefinition::s_towerDefs[m_selectedTower];
+		Rgba8 previewColor = Rgba8(255, 255, 255, 127);
 		if (selectedTowerDef.m_cost > m_money)
 		{
-			selectedTowerColor = Rgba8(255, 0, 0, 127);
+			previewColor = Rgba8(255, 0, 0, 127);
 		}
 
-		std::vector<Vertex_PCUTBN> const& towerVerts = selectedTowerDef.m_model->m_cpuMesh->m_vertexes;
-		for (int vertexIndex = 0; vertexIndex < (int)towerVerts.size(); vertexIndex++)
-		{
-			//tileHighlightVerts.push_back(Vertex_PCU(towerVerts[vertexIndex].m_position, towerVerts[vertexIndex].m_color, towerVerts[vertexIndex].m_uvTexCoords));
-			tileHighlightVerts.push_back(towerVerts[vertexIndex]);
-		}
+		RenderCommand previewCommand;
+		previewCommand.m_state.m_pass = RenderPass::BLENDED;
+		previewCommand.m_state.m_blendMode = BlendMode::ALPHA;
+		previewCommand.m_state.m_cullMode = RasterizerCullMode::CULL_BACK;
+		previewCommand.m_modelMatrix = Mat44::CreateTranslation3D(m_higlightPosition + Vec3(0.5f, 0.5f, 0.f));
+		previewCommand.m_modelColor = previewColor;
+		previewCommand.m_type = RenderCommandType::DRAW_INDEX_BUFFER;
 
-		std::vector<Vertex_PCUTBN> const& turretVerts = selectedTowerDef.m_turretModel->m_cpuMesh->m_vertexes;
-		for (int vertexIndex = 0; vertexIndex < (int)turretVerts.size(); vertexIndex++)
+		Model* const previewModels[] = { selectedTowerDef.m_model, selectedTowerDef.m_turretModel };
+		for (int modelIndex = 0; modelIndex < 2; modelIndex++)
 		{
-			//tileHighlightVerts.push_back(Vertex_PCU(turretVerts[vertexIndex].m_position, turretVerts[vertexIndex].m_color, turretVerts[vertexIndex].m_uvTexCoords));
-			tileHighlightVerts.push_back(turretVerts[vertexIndex]);
+			previewCommand.m_vertexBuffer = previewModels[modelIndex]->GetVertexBuffer();
+			previewCommand.m_indexBuffer = previewModels[modelIndex]->GetIndexBuffer();
+			previewCommand.m_count = previewModels[modelIndex]->GetIndexCount();
+			m_renderCommandList->AddCommand(previewCommand);
 		}
 
-		AddVertsForCylinder3D(tileHighlightVerts, Vec3::ZERO, Vec3::SKYWARD * 0.001f, selectedTowerDef.m_range + 0.5f, Rgba8(255, 255, 255, 127), AABB2::ZERO_TO_ONE, 32);
-	}
-	
-	if (m_game->m_drawDebug)
-	{
-		int numBlocks = m_dimensions.x * m_dimensions.y;
-		for (int tileIndex = 0; tileIndex < numBlocks; tileIndex++)
-		{
-			Rgba8 tileColor = Rgba8::WHITE;
-			IntVec2 tileCoords = GetBlockCoordsFromIndex(tileIndex);
-			if (m_heatMap->GetValueAtTile(tileCoords) > 9999.f)
-			{
-				tileColor = Rgba8::BLACK;
-			}
-
-			Vec3 tilePosition = tileCoords.GetAsVec2().ToVec3(0.01f);
-			//AddVertsForQuad3D(tileHighlightVerts, tilePosition, tilePosition + Vec3::EAST, tilePosition + Vec3::EAST + Vec3::NORTH, tilePosition + Vec3::NORTH, tileColor);
-		}
+		AddRangeIndicatorCommand(previewCommand.m_modelMatrix, selectedTowerDef.m_range + 0.5f, previewColor);
 	}
-	
-	g_renderer->SetBlendMode(BlendMode::ALPHA);
-	g_renderer->SetDepthMode(DepthMode::ENABLED);
-	g_renderer->SetModelConstants(Mat44::CreateTranslation3D(m_higlightPosition + Vec3(0.5f, 0.5f, 0.f)), selectedTowerColor);
-	g_renderer->SetRasterizerCullMode(RasterizerCullMode::CULL_BACK);
-	g_renderer->SetRasterizerFillMode(RasterizerFillMode::SOLID);
-	//g_theRenderer->BindShader(m_game->m_diffuseShader);
-	g_renderer->BindShader(nullptr);
-	g_renderer->BindTexture(nullptr);
-	g_renderer->SetLightConstants(m_definition.m_sunDirection, m_definition.m_sunIntensity, m_definition.m_ambientIntensity);
-	g_renderer->SetSamplerMode(SamplerMode::POINT_CLAMP);
-	g_renderer->DrawVertexArray(tileHighlightVerts);
 
 	RenderTowerOverlays();
 	RenderEnemyOverlays();
 
-	for (int particleIndex = 0; particleIndex < (int)m_particles.size(); particleIndex++)
-	{
-		m_particles[particleIndex]->Render(m_game->m_worldCamera);
-	}
+	m_particleSystem->AddRenderCommands(*m_renderCommandList, m_game->m_worldCamera);
+
+	// Constants shared by every map shader are bound once for the whole frame
+	g_renderBackend->BindConstantBuffer(SHADER_RTD_CONSTANTS_SLOT, m_reyTDConstantBuffer);
+	g_renderBackend->SetLightConstants(m_definition.m_sunDirection, m_definition.m_sunIntensity, m_definition.m_ambientIntensity);
+	m_renderStateCache->Reset();
+	m_renderCommandList->Sort();
+	m_renderCommandList->Submit(*m_renderStateCache);
 
 	double mapRenderEndTime = GetCurrentTimeSeconds();
 	g_mapRenderTime = (mapRenderEndTime - mapRenderStartTime) * 1000.f;
 }
 
+extern double g_towerRenderTime;
 void Map::RenderTowers() const
 {
+	double towerRenderStartTime = GetCurrentTimeSeconds();
+
+	m_towerRenderer->BeginFrame();
 	for (int towerIndex = 0; towerIndex < (int)m_towers.size(); towerIndex++)
 	{
-		m_towers[towerIndex]->Render();
+		m_towerRenderer->AddTowerInstances(*m_towers[towerIndex]);
 	}
+
+	// Models are drawn once with the instanced variant of the first map shader instead of once per map shader
+	if (!m_definition.m_instancedShaders.empty())
+	{
+		RenderState towerState;
+		towerState.m_shader = m_definition.m_instancedShaders[0];
+		towerState.m_cullMode = GetCullModeFromString(m_definition.m_cullModes[0]);
+		m_towerRenderer->AddRenderCommands(*m_renderCommandList, towerState);
+	}
+
+	double towerRenderEndTime = GetCurrentTimeSeconds();
+	g_towerRenderTime = (towerRenderEndTime - towerRenderStartTime) * 1000.f;
 }
 
 void Map::RenderTowerOverlays() const
 {
 	for (int towerIndex = 0; towerIndex < (int)m_towers.size(); towerIndex++)
 	{
-		m_towers[towerIndex]->RenderOverlay();
+		Tower const* tower = m_towers[towerIndex];
+		if (tower->m_isSelected)
+		{
+			AddRangeIndicatorCommand(Mat44::CreateTranslation3D(tower->m_position), tower->m_definition.m_range + 0.5f, Rgba8(255, 255, 255, 127));
+		}
 	}
 }
 
+void Map::AddRangeIndicatorCommand(Mat44 const& towerTransform, float radius, Rgba8 const& color) const
+{
+	RenderCommand rangeIndicatorCommand;
+	rangeIndicatorCommand.m_state.m_pass = RenderPass::BLENDED;
+	rangeIndicatorCommand.m_state.m_blendMode = BlendMode::ALPHA;
+	rangeIndicatorCommand.m_state.m_cullMode = RasterizerCullMode::CULL_BACK;
+	rangeIndicatorCommand.m_modelMatrix = towerTransform;
+	rangeIndicatorCommand.m_modelMatrix.AppendScaleNonUniform3D(Vec3(radius, radius, 1.f));
+	rangeIndicatorCommand.m_modelColor = color;
+	rangeIndicatorCommand.m_vertexBuffer = m_rangeIndicatorVertexBuffer;
+	rangeIndicatorCommand.m_count = m_numRangeIndicatorVerts;
+	m_renderCommandList->AddCommand(rangeIndicatorCommand);
+}
+
 void Map::RenderEnemies() const
 {
-	for (int enemyIndex = 0; enemyIndex < (int)m_enemies.size(); enemyIndex++)
+	m_enemyRenderer->BeginFrame();
+	for (int enemyIndex = 0; enemyIndex < m_enemies.GetCount(); enemyIndex++)
 	{
-		if (m_enemies[enemyIndex])
-		{
-			m_enemies[enemyIndex]->Render();
-		}
+		m_enemyRenderer->AddEnemyInstance(*m_enemies[enemyIndex]);
+	}
+
+	if (!m_definition.m_instancedShaders.empty())
+	{
+		RenderState enemyState;
+		enemyState.m_shader = m_definition.m_instancedShaders[0];
+		enemyState.m_cullMode = GetCullModeFromString(m_definition.m_cullModes[0]);
+		m_enemyRenderer->AddRenderCommands(*m_renderCommandList, enemyState);
 	}
 }
 
 void Map::RenderEnemyOverlays() const
 {
-	for (int enemyIndex = 0; enemyIndex < (int)m_enemies.size(); enemyIndex++)
-	{
-		if (m_enemies[enemyIndex])
-		{
-			m_enemies[enemyIndex]->RenderOverlay();
-		}
-	}
+	m_healthBarRenderer->AddRenderCommands(*m_renderCommandList, m_game->m_worldCamera, m_enemies);
 }
 
 void Map::RenderHUD() const
@@ -1405,14 +1120,14 @@ void Map::RenderHUD() const
 	}
 	AddVertsForAABB2(mapHealthImageVerts, healthImageBox, healthColor);
 	g_renderer->BindTexture(healthTexture);
-	g_renderer->DrawVertexArray(mapHealthImageVerts);
+	DrawVertexArray(mapHealthImageVerts);
 
 	std::vector<Vertex_PCU> mapCoinImageVerts;
 	AABB2 coinImageBox(Vec2::ZERO, Vec2(SCREEN_SIZE_Y * 0.04f, SCREEN_SIZE_Y * 0.04f));
 	coinImageBox.SetCenter(Vec2(SCREEN_SIZE_X * 0.01f + coinImageBox.GetDimensions().x * 1.75f, SCREEN_SIZE_Y - SCREEN_SIZE_Y * 0.01f - coinImageBox.GetDimensions().y * 0.5f));
 	AddVertsForAABB2(mapCoinImageVerts, coinImageBox, Rgba8::WHITE);
 	g_renderer->BindTexture(m_coinTexture);
-	g_renderer->DrawVertexArray(mapCoinImageVerts);
+	DrawVertexArray(mapCoinImageVerts);
 
 	std::vector<Vertex_PCU> mapHUDTextVerts;
 	
@@ -1445,7 +1160,7 @@ void Map::RenderHUD() const
 
 	g_renderer->SetSamplerMode(SamplerMode::BILINEAR_WRAP);
 	g_renderer->BindTexture(g_squirrelFont->GetTexture());
-	g_renderer->DrawVertexArray(mapHUDTextVerts);
+	DrawVertexArray(mapHUDTextVerts);
 
 	for (int imagePopupIndex = 0; imagePopupIndex < (int)m_imagePopups.size(); imagePopupIndex++)
 	{
@@ -1459,252 +1174,157 @@ void Map::RenderHUD() const
 
 void Map::RenderClouds() const
 {
-	for (int cloudIndex = 0; cloudIndex < (int)m_cloudsWithTexture1.size(); cloudIndex++)
-	{
-		std::vector<Vertex_PCU> cloudVerts;
-		Cloud const& cloud = m_cloudsWithTexture1[cloudIndex];
-		AddVertsForQuad3D(cloudVerts, Vec3::ZERO, Vec3(0.f, (float)cloud.m_texture->GetDimensions().x * 0.01f, 0.f), Vec3(0.f, (float)cloud.m_texture->GetDimensions().x, (float)cloud.m_texture->GetDimensions().y) * 0.01f, Vec3(0.f, 0.f, (float)cloud.m_texture->GetDimensions().y * 0.01f), Rgba8(255, 255, 255, 127));
-		Mat44 billboardMatrix = GetBillboardMatrix(cloud.m_billboardType, m_game->m_worldCamera.GetModelMatrix(), cloud.m_position);
-		g_renderer->SetBlendMode(BlendMode::ALPHA);
-		g_renderer->SetDepthMode(DepthMode::ENABLED);
-		g_renderer->SetModelConstants(billboardMatrix);
-		g_renderer->SetRasterizerCullMode(RasterizerCullMode::CULL_BACK);
-		g_renderer->SetRasterizerFillMode(RasterizerFillMode::SOLID);
-		g_renderer->BindShader(nullptr);
-		g_renderer->BindTexture(cloud.m_texture);
-		g_renderer->SetSamplerMode(SamplerMode::POINT_CLAMP);
-		g_renderer->DrawVertexArray(cloudVerts);
-	}
-
-	for (int cloudIndex = 0; cloudIndex < (int)m_cloudsWithTexture2.size(); cloudIndex++)
-	{
-		std::vector<Vertex_PCU> cloudVerts;
-		Cloud const& cloud = m_cloudsWithTexture2[cloudIndex];
-		AddVertsForQuad3D(cloudVerts, Vec3::ZERO, Vec3(0.f, (float)cloud.m_texture->GetDimensions().x * 0.01f, 0.f), Vec3(0.f, (float)cloud.m_texture->GetDimensions().x, (float)cloud.m_texture->GetDimensions().y) * 0.01f, Vec3(0.f, 0.f, (float)cloud.m_texture->GetDimensions().y * 0.01f), Rgba8(255, 255, 255, 127));
-		Mat44 billboardMatrix = GetBillboardMatrix(cloud.m_billboardType, m_game->m_worldCamera.GetModelMatrix(), cloud.m_position);
-		g_renderer->SetBlendMode(BlendMode::ALPHA);
-		g_renderer->SetDepthMode(DepthMode::ENABLED);
-		g_renderer->SetModelConstants(billboardMatrix);
-		g_renderer->SetRasterizerCullMode(RasterizerCullMode::CULL_BACK);
-		g_renderer->SetRasterizerFillMode(RasterizerFillMode::SOLID);
-		g_renderer->BindShader(nullptr);
-		g_renderer->BindTexture(cloud.m_texture);
-		g_renderer->SetSamplerMode(SamplerMode::POINT_CLAMP);
-		g_renderer->DrawVertexArray(cloudVerts);
-	}
-
-	for (int cloudIndex = 0; cloudIndex < (int)m_cloudsWithTexture3.size(); cloudIndex++)
-	{
-		std::vector<Vertex_PCU> cloudVerts;
-		Cloud const& cloud = m_cloudsWithTexture3[cloudIndex];
-		AddVertsForQuad3D(cloudVerts, Vec3::ZERO, Vec3(0.f, (float)cloud.m_texture->GetDimensions().x * 0.01f, 0.f), Vec3(0.f, (float)cloud.m_texture->GetDimensions().x, (float)cloud.m_texture->GetDimensions().y) * 0.01f, Vec3(0.f, 0.f, (float)cloud.m_texture->GetDimensions().y * 0.01f), Rgba8(255, 255, 255, 127));
-		Mat44 billboardMatrix = GetBillboardMatrix(cloud.m_billboardType, m_game->m_worldCamera.GetModelMatrix(), cloud.m_position);
-		g_renderer->SetBlendMode(BlendMode::ALPHA);
-		g_renderer->SetDepthMode(DepthMode::ENABLED);
-		g_renderer->SetModelConstants(billboardMatrix);
-		g_renderer->SetRasterizerCullMode(RasterizerCullMode::CULL_BACK);
-		g_renderer->SetRasterizerFillMode(RasterizerFillMode::SOLID);
-		g_renderer->BindShader(nullptr);
-		g_renderer->BindTexture(cloud.m_texture);
-		g_renderer->SetSamplerMode(SamplerMode::POINT_CLAMP);
-		g_renderer->DrawVertexArray(cloudVerts);
-	}
-
-	for (int cloudIndex = 0; cloudIndex < (int)m_cloudsWithTexture4.size(); cloudIndex++)
-	{
-		std::vector<Vertex_PCU> cloudVerts;
-		Cloud const& cloud = m_cloudsWithTexture4[cloudIndex];
-		AddVertsForQuad3D(cloudVerts, Vec3::ZERO, Vec3(0.f, (float)cloud.m_texture->GetDimensions().x * 0.01f, 0.f), Vec3(0.f, (float)cloud.m_texture->GetDimensions().x, (float)cloud.m_texture->GetDimensions().y) * 0.01f, Vec3(0.f, 0.f, (float)cloud.m_texture->GetDimensions().y * 0.01f), Rgba8(255, 255, 255, 127));
-		Mat44 billboardMatrix = GetBillboardMatrix(cloud.m_billboardType, m_game->m_worldCamera.GetModelMatrix(), cloud.m_position);
-		g_renderer->SetBlendMode(BlendMode::ALPHA);
-		g_renderer->SetDepthMode(DepthMode::ENABLED);
-		g_renderer->SetModelConstants(billboardMatrix);
-		g_renderer->SetRasterizerCullMode(RasterizerCullMode::CULL_BACK);
-		g_renderer->SetRasterizerFillMode(RasterizerFillMode::SOLID);
-		g_renderer->BindShader(nullptr);
-		g_renderer->BindTexture(cloud.m_texture);
-		g_renderer->SetSamplerMode(SamplerMode::POINT_CLAMP);
-		g_renderer->DrawVertexArray(cloudVerts);
-	}
+	m_cloudSystem->AddRenderCommands(*m_renderCommandList, m_game->m_worldCamera, m_mapClock.GetTotalSeconds());
 }
 
-int Map::GetBlockIndexFromCoords(IntVec2 const& blockCoords) const
-{
-	return blockCoords.x + m_dimensions.x * blockCoords.y;
-}
 
-int Map::GetBlockIndexFromCoords(int blockX, int blockY) const
-{
-	return blockX + m_dimensions.x * blockY;
-}
 
-IntVec2 Map::GetBlockCoordsFromIndex(int blockIndex) const
-{
-	return IntVec2(blockIndex % m_dimensions.x, blockIndex / m_dimensions.x);
-}
 
-IntVec2 Map::GetBlockCoordsForPoint(Vec3 const& pointCoords) const
+
+
+
+
+
+
+
+void Map::SpawnParticle(Vec3 const& startPos, Vec3 const& velocity, float size, float lifetime, std::string const& textureName, Rgba8 const& color, BlendMode blendMode, bool fadeOverLifetime)
 {
-	return IntVec2(RoundDownToInt(pointCoords.x), RoundDownToInt(pointCoords.y));
+	SpawnParticle(startPos, velocity, 0.f, 0.f, size, lifetime, textureName, color, blendMode, fadeOverLifetime);
 }
 
-Tower* Map::SpawnTower(std::string towerName, Vec3 const& towerPosition)
+void Map::SpawnParticle(Vec3 const& startPos, Vec3 const& velocity, float rotation, float rotationSpeed, float size, float lifetime, std::string const& textureName, Rgba8 const& color, BlendMode blendMode, bool fadeOverLifetime)
 {
-	TowerDefinition const& towerDef = TowerDefinition::s_towerDefs[towerName];
-
-	if (towerDef.m_cost > m_money)
+	if (m_isHeadless)
 	{
-		if (m_moneyBlinkTimer.IsStopped())
-		{
-			m_moneyBlinkTimer.Start();
-		}
-		return nullptr;
+		return;
 	}
 
-	g_audio->StartSoundAt(m_towerPlacedSound, towerPosition, false, m_game->m_sfxUserVolume);
-	Tower* tower = new Tower(this, towerDef, towerPosition);
-	m_money -= towerDef.m_cost;
-	m_towers.push_back(tower);
-	return tower;
+	m_particleSystem->Spawn(startPos, velocity, rotation, rotationSpeed, size, lifetime, ParticleSystem::GetParticleTexture(textureName), color, blendMode, fadeOverLifetime);
 }
 
-Enemy* Map::SpawnEnemy(std::string enemyName, Vec3 const& enemyPosition, EulerAngles const& enemyOrientation)
-{
-	EnemyDefinition const& enemyDef = EnemyDefinition::s_enemyDefs[enemyName];
-	Enemy* enemy = new Enemy(this, enemyDef, enemyPosition, enemyOrientation);
-	m_enemies.push_back(enemy);
-	m_numEnemiesInLevel++;
-	return enemy;
-}
 
-Particle* Map::SpawnParticle(Vec3 const& startPos, Vec3 const& velocity, float size, float lifetime, std::string const& textureName, Rgba8 const& color, BlendMode blendMode, bool fadeOverLifetime)
+
+
+
+
+
+
+
+
+void Map::OnTowerPlaced(Tower const& tower)
 {
-	Particle* particle = new Particle(startPos, velocity, size, &m_mapClock, lifetime, textureName, color, blendMode, fadeOverLifetime);
-	m_particles.push_back(particle);
-	return particle;
+	g_audio->StartSoundAt(m_towerPlacedSound, tower.m_position, false, m_game->m_sfxUserVolume);
 }
 
-Particle* Map::SpawnParticle(Vec3 const& startPos, Vec3 const& velocity, float rotation, float rotationSpeed, float size, float lifetime, std::string const& textureName, Rgba8 const& color, BlendMode blendMode, bool fadeOverLifetime)
+void Map::OnTowerUnaffordable()
 {
-	Particle* particle = new Particle(startPos, velocity, rotation, rotationSpeed, size, &m_mapClock, lifetime, textureName, color, blendMode, fadeOverLifetime);
-	m_particles.push_back(particle);
-	return particle;
+	if (m_moneyBlinkTimer.IsStopped())
+	{
+		m_moneyBlinkTimer.Start();
+	}
 }
 
-Vec2 Map::GetClosestPathBlock(Vec3 const& referencePosition) const
+// Cosmetic rolls stay on g_RNG, so they never move the simulation's own random stream
+void Map::OnTowerFired(Tower const& tower)
 {
-	IntVec2 referenceBlockCoords = GetBlockCoordsForPoint(referencePosition);
-	std::queue<IntVec2> nextBlocks;
-	nextBlocks.push(referenceBlockCoords);
+	TowerDefinition const& towerDef = tower.m_definition;
 
-	IntVec2 closestBlockCoords = referenceBlockCoords;
+	Vec3 fwd, left, up;
+	EulerAngles orientation(tower.m_turretZOrientation, 0.f, 0.f);
+	orientation.GetAsVectors_iFwd_jLeft_kUp(fwd, left, up);
 
-	while (!nextBlocks.empty())
-	{
-		IntVec2 currentBlockCoords = nextBlocks.front();
-		nextBlocks.pop();
+	float particleSize = g_RNG->RollRandomFloatInRange(towerDef.m_firedParticleSize);
+	Vec3 const& particleOffset = towerDef.m_firedParticleOffset;
+	Vec3 const& particleRelativeVel = towerDef.m_firedParticleVelocity;
+	BlendMode particleBlendMode = GetBlendModeFromString(towerDef.m_firedParticleBlendModeStr);
 
-		{
-			IntVec2 westBlockCoords = currentBlockCoords + IntVec2::WEST;
-			int westBlockIndex = GetBlockIndexFromCoords(westBlockCoords);
-			Block const& westBlock = m_blocks[westBlockIndex];
-			if (westBlockCoords.x >= 0 && westBlock.IsEnemyTraversable())
-			{
-				closestBlockCoords = westBlockCoords;
-				break;
-			}
-			nextBlocks.push(westBlockCoords);
-		}
+	for (int particleIndex = 0; particleIndex < towerDef.m_numParticlesFired; particleIndex++)
+	{
+		float particleStartRotation = 0.f; //g_RNG->RollRandomFloatInRange(0.f, 360.f);
+		float particleRotationSpeed = g_RNG->RollRandomFloatInRange(towerDef.m_firedParticleRotationSpeed);
+		SpawnParticle(tower.m_position + particleOffset.x * fwd + particleOffset.y * left + particleOffset.z * up, particleRelativeVel.x * fwd + particleRelativeVel.y * left + particleRelativeVel.z * up, particleStartRotation, particleRotationSpeed, particleSize, towerDef.m_firedParticleLifetime, towerDef.m_firedParticleName, towerDef.m_firedParticleColor, particleBlendMode);
+	}
 
-		{
-			IntVec2 northBlockCoords = currentBlockCoords + IntVec2::NORTH;
-			int northBlockIndex = GetBlockIndexFromCoords(northBlockCoords);
-			Block const& northBlock = m_blocks[northBlockIndex];
-			if (northBlockCoords.y < m_dimensions.y && northBlock.IsEnemyTraversable())
-			{
-				closestBlockCoords = northBlockCoords;
-				break;
-			}
-			nextBlocks.push(northBlockCoords);
-		}
+	auto fireSoundIter = m_towerFireSounds.find(towerDef.m_name);
+	if (fireSoundIter != m_towerFireSounds.end())
+	{
+		g_audio->StartSoundAt(fireSoundIter->second, tower.m_position, false, m_game->m_sfxUserVolume);
+	}
+}
 
-		{
-			IntVec2 southBlockCoords = currentBlockCoords + IntVec2::SOUTH;
-			int southBlockIndex = GetBlockIndexFromCoords(southBlockCoords);
-			Block const& southBlock = m_blocks[southBlockIndex];
-			if (southBlockCoords.y >= 0 && southBlock.IsEnemyTraversable())
-			{
-				closestBlockCoords = southBlockCoords;
-				break;
-			}
-			nextBlocks.push(southBlockCoords);
-		}
+void Map::OnEnemyDied(Enemy const& enemy)
+{
+	g_audio->StartSoundAt(m_enemyDeathSFX, enemy.GetPosition(), false, m_game->m_sfxUserVolume);
+}
 
-		{
-			IntVec2 eastBlockCoords = currentBlockCoords + IntVec2::EAST;
-			int eastBlockIndex = GetBlockIndexFromCoords(eastBlockCoords);
-			Block const& eastBlock = m_blocks[eastBlockIndex];
-			if (eastBlockCoords.x < m_dimensions.x && eastBlock.IsEnemyTraversable())
-			{
-				closestBlockCoords = eastBlockCoords;
-				break;
-			}
-			nextBlocks.push(eastBlockCoords);
-		}
+void Map::OnEnemyDeathAnimationFinished(Enemy const& enemy)
+{
+	for (int particleIndex = 0; particleIndex < enemy.m_definition->m_numParticlesOnDeath; particleIndex++)
+	{
+		SpawnParticle(enemy.GetPosition(), Vec3(0.f, 0.f, 0.2f) + g_RNG->RollRandomFloatInRange(-0.2f, 0.2f) * Vec3::EAST + g_RNG->RollRandomFloatInRange(-0.2f, 0.2f) * Vec3::NORTH, 0.5f, 1.f, "Smoke", Rgba8(249, 182, 115, 255));
 	}
-
-	return (closestBlockCoords.GetAsVec2() + Vec2(0.5f, 0.5f));
 }
 
-Enemy* Map::GetTargetWithinRange(Vec3 const& towerPosition, float range)
+void Map::OnEnemyStatusEffectPulse(Enemy const& enemy)
 {
-	Enemy* target = nullptr;
-	float targetHeatValue = 99999.f;
+	int numParticles = g_RNG->RollRandomIntLessThan(10);
 
-	for (int enemyIndex = 0; enemyIndex < (int)m_enemies.size(); enemyIndex++)
+	if (enemy.m_statusEffects.IsActive(StatusEffectType::BURN))
 	{
-		Enemy* const& enemy = m_enemies[enemyIndex];
-		if (!IsEnemyAlive(enemy))
+		for (int particleIndex = 0; particleIndex < numParticles; particleIndex++)
 		{
-			continue;
+			float startRotation = g_RNG->RollRandomFloatInRange(0.f, 360.f);
+			float rotationSpeed = g_RNG->RollRandomFloatInRange(-60.f, 60.f);
+			float particleSpeed = g_RNG->RollRandomFloatInRange(0.5f, 1.5f);
+			SpawnParticle(enemy.GetPosition() + Vec3::SKYWARD * 0.6f, Vec3::SKYWARD * particleSpeed, startRotation, rotationSpeed, 0.5f, 0.5f, "Fire", Rgba8::ORANGE, BlendMode::ADDITIVE);
 		}
+	}
+
+	if (enemy.m_statusEffects.IsActive(StatusEffectType::FREEZE))
+	{
+		SpawnParticle(enemy.GetPosition() + Vec3::SKYWARD * 0.5f, Vec3(0.f, 0.f, 0.f), 1.5f, 0.5f, "FreezeFire", Rgba8::CYAN);
+	}
 
-		if (IsPointInsideDisc2D(enemy->m_position.GetXY(), towerPosition.GetXY(), range))
+	if (enemy.m_statusEffects.IsActive(StatusEffectType::POISON))
+	{
+		for (int particleIndex = 0; particleIndex < numParticles; particleIndex++)
 		{
-			IntVec2 blockCoords = GetBlockCoordsForPoint(enemy->m_position);
-			float enemyHeatValue = m_heatMap->GetValueAtTile(blockCoords);
-			if (enemyHeatValue < targetHeatValue)
-			{
-				target = enemy;
-				targetHeatValue = enemyHeatValue;
-			}
+			float startRotation = g_RNG->RollRandomFloatInRange(0.f, 0.f);
+			float rotationSpeed = g_RNG->RollRandomFloatInRange(-0.f, 0.f);
+			float particleSpeed = g_RNG->RollRandomFloatInRange(0.5f, 0.75f);
+			SpawnParticle(enemy.GetPosition() + Vec3::SKYWARD * 0.6f, Vec3::SKYWARD * particleSpeed, startRotation, rotationSpeed, 0.2f, 0.5f, "PoisonDebuff", Rgba8::PURPLE, BlendMode::ADDITIVE);
 		}
 	}
-
-	return target;
 }
 
-bool Map::IsEnemyAlive(Enemy* enemy) const
+void Map::OnEnemyReachedGoal(Enemy const& enemy)
 {
-	return enemy && !enemy->m_isDead;
+	g_audio->StartSoundAt(m_enemyGoalSFX, enemy.GetPosition(), false, 10.f * m_game->m_sfxUserVolume);
 }
 
-void Map::DecrementLives()
+void Map::OnLifeLost()
 {
-	m_remainingLives--;
+	m_game->AddCameraShake(1.f);
+}
 
-	if (m_remainingLives < 0)
-	{
-		m_mapClock.Pause();
-		g_app->m_showHandCursor = false;
-		m_levelFailedPopup->SetVisible(true);
-		m_canTogglePause = false;
-		g_audio->StartSound(m_levelFailedSFX, false, m_game->m_sfxUserVolume);
-		return;
-	}
+void Map::OnLevelFailed()
+{
+	m_mapClock.Pause();
+	g_app->m_showHandCursor = false;
+	m_levelFailedPopup->SetVisible(true);
+	m_canTogglePause = false;
+	g_audio->StartSound(m_levelFailedSFX, false, m_game->m_sfxUserVolume);
+}
 
-	m_game->AddCameraShake(1.f);
+void Map::OnLevelComplete()
+{
+	g_audio->StartSound(m_levelCompleteSFX, false, m_game->m_sfxUserVolume);
+	g_app->m_showHandCursor = false;
+	m_levelCompletePopup->SetStars(m_stars)->SetVisible(true);
+	m_canTogglePause = false;
+	m_mapClock.Pause();
 
+	m_game->SaveToFile();
 }
 
 void Map::UnselectAllTowers()
@@ -1,8 +1,10 @@
 #include "Game/MapDefinition.hpp"
 
-#include "Game/GameCommon.hpp"
+#include "Game/AssetBackend.hpp"
+#include "Game/SimulationCommon.hpp"
 
 #include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/StringUtils.hpp"
 
 
 std::map<std::string, MapDefinition> MapDefinition::s_mapDefs;
@@ -34,6 +36,9 @@ MapDefinition::MapDefinition(XmlElement const* element)
 	m_mapImageName = ParseXmlAttribute(*element, "image", m_mapImageName);
 	m_startingMoney = ParseXmlAttribute(*element, "startingMoney", m_startingMoney);
 	m_lives = ParseXmlAttribute(*element, "lives", m_lives);
+	// Maps without their own seed still get distinct decorations, since several of them share one image
+	m_decorationSeed = HashBytes(FNV_OFFSET_BASIS, m_name.data(), m_name.size());
+	m_decorationSeed = (unsigned int)ParseXmlAttribute(*element, "decorationSeed", (int)m_decorationSeed);
 	std::string shaderNamesStr = ParseXmlAttribute(*element, "shaders", "");
 	Strings shaderNames;
 	int numShaders = SplitStringOnDelimiter(shaderNames, shaderNamesStr, ',');
@@ -45,7 +50,13 @@ MapDefinition::MapDefinition(XmlElement const* element)
 		std::string const& shaderName = shaderNames[shaderIndex];
 		if (!shaderName.empty())
 		{
-			m_shaders.push_back(g_renderer->CreateOrGetShader(shaderName.c_str(), VertexType::VERTEX_PCUTBN));
+			m_shaders.push_back(g_assetBackend->CreateOrGetShader(shaderName, false));
+			// Every map shader has an instanced variant next to it that towers and enemies are drawn with
+			std::string instancedShaderName = shaderName + "Instanced";
+			m_instancedShaders.push_back(g_assetBackend->CreateOrGetShader(instancedShaderName, false));
+			// and a packed variant for map chunks stored as Vertex_MapPacked, which shares the VERTEX_PCU layout
+			std::string packedShaderName = shaderName + "Packed";
+			m_packedShaders.push_back(g_assetBackend->CreateOrGetShader(packedShaderName, true));
 		}
 		std::string const& cullMode = cullModes[shaderIndex];
 		if (!cullMode.empty())
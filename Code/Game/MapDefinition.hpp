@@ -1,14 +1,16 @@
 #pragma once
 
+#include "Engine/Core/StringUtils.hpp"
 #include "Engine/Core/XMLUtils.hpp"
 #include "Engine/Math/IntVec2.hpp"
 #include "Engine/Math/Vec3.hpp"
-#include "Engine/Renderer/Shader.hpp"
 
 #include <map>
 #include <string>
 #include <vector>
 
+class Shader;
+
 struct Wave
 {
 public:
@@ -28,6 +30,8 @@ public:
 	IntVec2 m_dimensions = IntVec2::ZERO;
 	std::string m_fillBlockType = "Grass";
 	std::vector<Shader*> m_shaders;
+	std::vector<Shader*> m_instancedShaders;
+	std::vector<Shader*> m_packedShaders;
 	std::vector<std::string> m_cullModes;
 	float m_ambientIntensity = 0.f;
 	float m_sunIntensity = 0.f;
@@ -35,6 +39,7 @@ public:
 	std::vector<Wave> m_waves;
 	int m_startingMoney = 0;
 	int m_lives = 1;
+	unsigned int m_decorationSeed = 0;
 	std::vector<std::string> m_towers;
 	Strings m_newEnemies;
 	Strings m_newTowers;
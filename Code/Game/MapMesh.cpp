@@ -0,0 +1,297 @@
+#include "Game/MapMesh.hpp"
+
+#include "Game/CameraFrustum.hpp"
+#include "Game/GameCommon.hpp"
+#include "Game/JobSystem.hpp"
+#include "Game/MeshIndexing.hpp"
+#include "Game/PackedMapVertex.hpp"
+#include "Game/RenderBackend.hpp"
+#include "Game/RenderCommandList.hpp"
+
+#include "Engine/Renderer/IndexBuffer.hpp"
+#include "Engine/Renderer/VertexBuffer.hpp"
+
+
+CookedMapChunkView CookedMapChunk::GetView() const
+{
+	CookedMapChunkView view;
+	view.m_chunkCoords = m_chunkCoords;
+	view.m_bounds = m_bounds;
+	view.m_isPacked = m_isPacked;
+	view.m_numVerts = m_numVerts;
+	view.m_vertexBytes = m_vertexBytes.data();
+	view.m_numVertexBytes = m_vertexBytes.size();
+	view.m_indexBytes = reinterpret_cast<uint8_t const*>(m_indexes.data());
+	view.m_numIndexes = (int)m_indexes.size();
+	return view;
+}
+
+
+MapMesh::~MapMesh()
+{
+	for (int chunkIndex = 0; chunkIndex < (int)m_chunks.size(); chunkIndex++)
+	{
+		DestroyBuffer(m_chunks[chunkIndex].m_vertexBuffer);
+		DestroyBuffer(m_chunks[chunkIndex].m_indexBuffer);
+	}
+}
+
+void MapMesh::Build(Grid<Block> const& blocks, JobSystem* jobSystem, bool usePackedVerts)
+{
+	std::vector<CookedMapChunk> cookedChunks;
+	std::vector<CookedMapChunkView> chunkViews;
+	CookChunks(blocks, jobSystem, usePackedVerts, cookedChunks);
+	GetChunkViews(cookedChunks, chunkViews);
+	Upload(chunkViews);
+}
+
+void MapMesh::Upload(std::vector<CookedMapChunkView> const& cookedChunks)
+{
+	// Buffers are created and filled on this thread since the renderer's device context is not thread safe
+	m_chunks.reserve(m_chunks.size() + cookedChunks.size());
+	for (int cookedChunkIndex = 0; cookedChunkIndex < (int)cookedChunks.size(); cookedChunkIndex++)
+	{
+		CookedMapChunkView const& cookedChunk = cookedChunks[cookedChunkIndex];
+		MapChunk chunk;
+		chunk.m_chunkCoords = cookedChunk.m_chunkCoords;
+		chunk.m_bounds = cookedChunk.m_bounds;
+		chunk.m_isPacked = cookedChunk.m_isPacked;
+		if (chunk.m_isPacked)
+		{
+			chunk.m_modelMatrix = GetPackedMapVertexTransform(GetPackedMapVertexOrigin(chunk.m_bounds));
+		}
+
+		chunk.m_vertexBuffer = g_renderBackend->CreateVertexBuffer(cookedChunk.m_numVertexBytes, chunk.m_isPacked ? VertexType::VERTEX_PCU : VertexType::VERTEX_PCUTBN);
+		CopyCPUToGPU(cookedChunk.m_vertexBytes, cookedChunk.m_numVertexBytes, chunk.m_vertexBuffer);
+
+		size_t indexesSize = cookedChunk.m_numIndexes * sizeof(unsigned int);
+		chunk.m_indexBuffer = g_renderBackend->CreateIndexBuffer(indexesSize);
+		CopyCPUToGPU(cookedChunk.m_indexBytes, indexesSize, chunk.m_indexBuffer);
+		chunk.m_numVerts = cookedChunk.m_numVerts;
+		chunk.m_numIndexes = cookedChunk.m_numIndexes;
+		m_chunks.push_back(chunk);
+	}
+}
+
+void MapMesh::CullChunks(Camera const& camera)
+{
+	m_visibleChunkIndexes.clear();
+
+	CameraFrustum frustum(camera);
+	for (int chunkIndex = 0; chunkIndex < (int)m_chunks.size(); chunkIndex++)
+	{
+		if (!frustum.IsAABBOutside(m_chunks[chunkIndex].m_bounds))
+		{
+			m_visibleChunkIndexes.push_back(chunkIndex);
+		}
+	}
+
+	m_numChunksDrawnLastFrame = (int)m_visibleChunkIndexes.size();
+}
+
+void MapMesh::AddRenderCommands(RenderCommandList& commandList, RenderState const& state, RenderState const& packedState) const
+{
+	RenderCommand command;
+	command.m_type = RenderCommandType::DRAW_INDEX_BUFFER;
+	for (int visibleIndex = 0; visibleIndex < (int)m_visibleChunkIndexes.size(); visibleIndex++)
+	{
+		MapChunk const& chunk = m_chunks[m_visibleChunkIndexes[visibleIndex]];
+		command.m_state = chunk.m_isPacked ? packedState : state;
+		command.m_modelMatrix = chunk.m_modelMatrix;
+		command.m_vertexBuffer = chunk.m_vertexBuffer;
+		command.m_indexBuffer = chunk.m_indexBuffer;
+		command.m_count = chunk.m_numIndexes;
+		commandList.AddCommand(command);
+	}
+}
+
+int MapMesh::GetNumChunks() const
+{
+	return (int)m_chunks.size();
+}
+
+int MapMesh::GetNumVerts() const
+{
+	int numVerts = 0;
+	for (int chunkIndex = 0; chunkIndex < (int)m_chunks.size(); chunkIndex++)
+	{
+		numVerts += m_chunks[chunkIndex].m_numVerts;
+	}
+
+	return numVerts;
+}
+
+int MapMesh::GetNumIndexes() const
+{
+	int numIndexes = 0;
+	for (int chunkIndex = 0; chunkIndex < (int)m_chunks.size(); chunkIndex++)
+	{
+		numIndexes += m_chunks[chunkIndex].m_numIndexes;
+	}
+
+	return numIndexes;
+}
+
+int MapMesh::GetNumPackedChunks() const
+{
+	int numPackedChunks = 0;
+	for (int chunkIndex = 0; chunkIndex < (int)m_chunks.size(); chunkIndex++)
+	{
+		numPackedChunks += m_chunks[chunkIndex].m_isPacked ? 1 : 0;
+	}
+
+	return numPackedChunks;
+}
+
+size_t MapMesh::GetNumVertexBytes() const
+{
+	size_t numVertexBytes = 0;
+	for (int chunkIndex = 0; chunkIndex < (int)m_chunks.size(); chunkIndex++)
+	{
+		MapChunk const& chunk = m_chunks[chunkIndex];
+		numVertexBytes += (size_t)chunk.m_numVerts * (chunk.m_isPacked ? sizeof(Vertex_MapPacked) : sizeof(Vertex_PCUTBN));
+	}
+
+	return numVertexBytes;
+}
+
+IntVec2 MapMesh::GetChunkGridDimensions(IntVec2 const& dimensions)
+{
+	return IntVec2((dimensions.x + CHUNK_SIZE - 1) / CHUNK_SIZE, (dimensions.y + CHUNK_SIZE - 1) / CHUNK_SIZE);
+}
+
+void MapMesh::CookChunks(Grid<Block> const& blocks, JobSystem* jobSystem, bool usePackedVerts, std::vector<CookedMapChunk>& out_cookedChunks)
+{
+	IntVec2 chunkGridDimensions = GetChunkGridDimensions(blocks.GetDimensions());
+	std::vector<std::vector<Vertex_PCUTBN>> chunkVerts;
+	BuildAllChunkVerts(blocks, jobSystem, chunkVerts);
+
+	// Welding, reordering and packing only touch the chunk's own lists, so they run in parallel like the meshing
+	int numChunks = (int)chunkVerts.size();
+	std::vector<CookedMapChunk> cookedChunks(numChunks);
+	auto cookChunkRange = [&](int startChunkIndex, int endChunkIndex)
+	{
+		std::vector<Vertex_PCUTBN> uniqueVerts;
+		std::vector<Vertex_MapPacked> packedVerts;
+		for (int chunkIndex = startChunkIndex; chunkIndex < endChunkIndex; chunkIndex++)
+		{
+			CookedMapChunk& cookedChunk = cookedChunks[chunkIndex];
+			cookedChunk.m_chunkCoords = IntVec2(chunkIndex % chunkGridDimensions.x, chunkIndex / chunkGridDimensions.x);
+			WeldVertexes(chunkVerts[chunkIndex], uniqueVerts, cookedChunk.m_indexes);
+			OptimizeIndexOrderForVertexCache(cookedChunk.m_indexes, (int)uniqueVerts.size());
+			OptimizeVertexOrderForFetch(uniqueVerts, cookedChunk.m_indexes);
+			if (cookedChunk.m_indexes.empty())
+			{
+				continue;
+			}
+
+			// A chunk too tall to quantize keeps its full vertexes and is drawn with the regular shaders
+			cookedChunk.m_bounds = GetVertexBounds(uniqueVerts);
+			cookedChunk.m_numVerts = (int)uniqueVerts.size();
+			Vec3 packedOrigin = GetPackedMapVertexOrigin(cookedChunk.m_bounds);
+			cookedChunk.m_isPacked = usePackedVerts && EncodeMapVertexes(uniqueVerts, packedOrigin, packedVerts);
+			uint8_t const* vertexBytes = cookedChunk.m_isPacked ? reinterpret_cast<uint8_t const*>(packedVerts.data()) : reinterpret_cast<uint8_t const*>(uniqueVerts.data());
+			size_t vertexStride = cookedChunk.m_isPacked ? sizeof(Vertex_MapPacked) : sizeof(Vertex_PCUTBN);
+			cookedChunk.m_vertexBytes.assign(vertexBytes, vertexBytes + uniqueVerts.size() * vertexStride);
+		}
+	};
+
+	if (jobSystem)
+	{
+		jobSystem->ParallelFor(numChunks, 1, cookChunkRange);
+	}
+	else
+	{
+		cookChunkRange(0, numChunks);
+	}
+
+	out_cookedChunks.clear();
+	out_cookedChunks.reserve(numChunks);
+	for (int chunkIndex = 0; chunkIndex < numChunks; chunkIndex++)
+	{
+		if (!cookedChunks[chunkIndex].m_indexes.empty())
+		{
+			out_cookedChunks.push_back(std::move(cookedChunks[chunkIndex]));
+		}
+	}
+}
+
+void MapMesh::GetChunkViews(std::vector<CookedMapChunk> const& cookedChunks, std::vector<CookedMapChunkView>& out_chunkViews)
+{
+	out_chunkViews.clear();
+	out_chunkViews.reserve(cookedChunks.size());
+	for (int chunkIndex = 0; chunkIndex < (int)cookedChunks.size(); chunkIndex++)
+	{
+		out_chunkViews.push_back(cookedChunks[chunkIndex].GetView());
+	}
+}
+
+void MapMesh::BuildAllChunkVerts(Grid<Block> const& blocks, JobSystem* jobSystem, std::vector<std::vector<Vertex_PCUTBN>>& out_chunkVerts)
+{
+	IntVec2 chunkGridDimensions = GetChunkGridDimensions(blocks.GetDimensions());
+	int numChunks = chunkGridDimensions.x * chunkGridDimensions.y;
+	out_chunkVerts.clear();
+	out_chunkVerts.resize(numChunks);
+
+	// Every chunk writes only its own vertex list, so chunks need no synchronization between them
+	auto buildChunkRange = [&](int startChunkIndex, int endChunkIndex)
+	{
+		for (int chunkIndex = startChunkIndex; chunkIndex < endChunkIndex; chunkIndex++)
+		{
+			IntVec2 chunkCoords = IntVec2(chunkIndex % chunkGridDimensions.x, chunkIndex / chunkGridDimensions.x);
+			BuildChunkVerts(blocks, chunkCoords, out_chunkVerts[chunkIndex]);
+		}
+	};
+
+	if (jobSystem)
+	{
+		jobSystem->ParallelFor(numChunks, 1, buildChunkRange);
+	}
+	else
+	{
+		buildChunkRange(0, numChunks);
+	}
+}
+
+void MapMesh::BuildChunkVerts(Grid<Block> const& blocks, IntVec2 const& chunkCoords, std::vector<Vertex_PCUTBN>& out_verts)
+{
+	IntVec2 dimensions = blocks.GetDimensions();
+	int blockMinX = chunkCoords.x * CHUNK_SIZE;
+	int blockMinY = chunkCoords.y * CHUNK_SIZE;
+	int blockMaxX = GetClamped(blockMinX + CHUNK_SIZE, 0, dimensions.x);
+	int blockMaxY = GetClamped(blockMinY + CHUNK_SIZE, 0, dimensions.y);
+	for (int blockY = blockMinY; blockY < blockMaxY; blockY++)
+	{
+		for (int blockX = blockMinX; blockX < blockMaxX; blockX++)
+		{
+			// Border blocks have no model to hide faces with, so the edge of the map still passes nullptr
+			int blockIndex = blocks.GetIndex(blockX, blockY);
+			Block const* const neighbors[(int)BlockSide::COUNT] =
+			{
+				blockX + 1 < dimensions.x ? &blocks[blocks.GetNeighborIndex(blockIndex, GridDirection::EAST)] : nullptr,
+				blockX > 0 ? &blocks[blocks.GetNeighborIndex(blockIndex, GridDirection::WEST)] : nullptr,
+				blockY + 1 < dimensions.y ? &blocks[blocks.GetNeighborIndex(blockIndex, GridDirection::NORTH)] : nullptr,
+				blockY > 0 ? &blocks[blocks.GetNeighborIndex(blockIndex, GridDirection::SOUTH)] : nullptr,
+			};
+			blocks[blockIndex].AddVerts(out_verts, Vec3((float)blockX + 0.5f, (float)blockY + 0.5f, -0.2f), neighbors);
+		}
+	}
+}
+
+// Bounds come from the baked vertexes, so tall models like trees are never culled while still on screen
+AABB3 MapMesh::GetVertexBounds(std::vector<Vertex_PCUTBN> const& verts)
+{
+	AABB3 bounds(verts[0].m_position, verts[0].m_position);
+	for (int vertexIndex = 1; vertexIndex < (int)verts.size(); vertexIndex++)
+	{
+		Vec3 const& position = verts[vertexIndex].m_position;
+		bounds.m_mins.x = position.x < bounds.m_mins.x ? position.x : bounds.m_mins.x;
+		bounds.m_mins.y = position.y < bounds.m_mins.y ? position.y : bounds.m_mins.y;
+		bounds.m_mins.z = position.z < bounds.m_mins.z ? position.z : bounds.m_mins.z;
+		bounds.m_maxs.x = position.x > bounds.m_maxs.x ? position.x : bounds.m_maxs.x;
+		bounds.m_maxs.y = position.y > bounds.m_maxs.y ? position.y : bounds.m_maxs.y;
+		bounds.m_maxs.z = position.z > bounds.m_maxs.z ? position.z : bounds.m_maxs.z;
+	}
+
+	return bounds;
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "Game/Block.hpp"
+#include "Game/Grid.hpp"
+
+#include "Engine/Core/VertexUtils.hpp"
+#include "Engine/Math/AABB3.hpp"
+#include "Engine/Math/IntVec2.hpp"
+#include "Engine/Math/Mat44.hpp"
+
+#include <cstdint>
+#include <vector>
+
+class Camera;
+class IndexBuffer;
+class JobSystem;
+class RenderCommandList;
+class VertexBuffer;
+struct RenderState;
+
+
+struct MapChunk
+{
+public:
+	IntVec2 m_chunkCoords = IntVec2::ZERO;
+	AABB3 m_bounds;
+	VertexBuffer* m_vertexBuffer = nullptr;
+	IndexBuffer* m_indexBuffer = nullptr;
+	int m_numVerts = 0;
+	int m_numIndexes = 0;
+
+	// Packed chunks hold Vertex_MapPacked and are drawn with the packed shaders, whose model matrix turns quantized positions back into world positions
+	bool m_isPacked = false;
+	Mat44 m_modelMatrix;
+};
+
+
+// What MapMesh::Upload reads a chunk from, pointing either into a CookedMapChunk or straight into a loaded cooked map file
+// Indexes are read as bytes, since a file gives no alignment guarantee for them
+struct CookedMapChunkView
+{
+public:
+	IntVec2 m_chunkCoords = IntVec2::ZERO;
+	AABB3 m_bounds;
+	bool m_isPacked = false;
+	int m_numVerts = 0;
+	uint8_t const* m_vertexBytes = nullptr;
+	size_t m_numVertexBytes = 0;
+	uint8_t const* m_indexBytes = nullptr;
+	int m_numIndexes = 0;
+};
+
+
+// CPU side of a finished chunk: welded, cache ordered and possibly packed, ready to upload as is or to store in the cooked map cache
+struct CookedMapChunk
+{
+public:
+	IntVec2 m_chunkCoords = IntVec2::ZERO;
+	AABB3 m_bounds;
+	bool m_isPacked = false;
+	int m_numVerts = 0;
+	std::vector<uint8_t> m_vertexBytes;
+	std::vector<unsigned int> m_indexes;
+
+public:
+	CookedMapChunkView GetView() const;
+};
+
+
+// Static block geometry of a map, split into square chunks of blocks that each get their own welded vertex and index buffer
+// Chunks are meshed, cache optimized and optionally packed in parallel, then culled against the camera frustum once per frame so every map shader draws only the visible ones
+class MapMesh
+{
+public:
+	static constexpr int CHUNK_SIZE = 16;
+
+public:
+	~MapMesh();
+	MapMesh() = default;
+
+	void Build(Grid<Block> const& blocks, JobSystem* jobSystem, bool usePackedVerts);
+	void Upload(std::vector<CookedMapChunkView> const& cookedChunks);
+	void CullChunks(Camera const& camera);
+	void AddRenderCommands(RenderCommandList& commandList, RenderState const& state, RenderState const& packedState) const;
+
+	int GetNumChunks() const;
+	int GetNumVerts() const;
+	int GetNumIndexes() const;
+	int GetNumPackedChunks() const;
+	size_t GetNumVertexBytes() const;
+
+	static IntVec2 GetChunkGridDimensions(IntVec2 const& dimensions);
+	static void CookChunks(Grid<Block> const& blocks, JobSystem* jobSystem, bool usePackedVerts, std::vector<CookedMapChunk>& out_cookedChunks);
+	static void GetChunkViews(std::vector<CookedMapChunk> const& cookedChunks, std::vector<CookedMapChunkView>& out_chunkViews);
+	static void BuildAllChunkVerts(Grid<Block> const& blocks, JobSystem* jobSystem, std::vector<std::vector<Vertex_PCUTBN>>& out_chunkVerts);
+	static void BuildChunkVerts(Grid<Block> const& blocks, IntVec2 const& chunkCoords, std::vector<Vertex_PCUTBN>& out_verts);
+	static AABB3 GetVertexBounds(std::vector<Vertex_PCUTBN> const& verts);
+
+public:
+	std::vector<MapChunk> m_chunks;
+	std::vector<int> m_visibleChunkIndexes;
+	int m_numChunksDrawnLastFrame = 0;
+};
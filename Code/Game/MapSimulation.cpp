@@ -0,0 +1,574 @@
+#include "Game/MapSimulation.hpp"
+
+#include "Game/BlockDefinition.hpp"
+#include "Game/Enemy.hpp"
+#include "Game/EnemyDefinition.hpp"
+#include "Game/JobSystem.hpp"
+#include "Game/SimulationCommon.hpp"
+#include "Game/SimulationEvents.hpp"
+#include "Game/Tower.hpp"
+#include "Game/TowerDefinition.hpp"
+
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/Image.hpp"
+#include "Engine/Math/MathUtils.hpp"
+
+#include "ThirdParty/Squirrel/RawNoise.hpp"
+
+
+static NullSimulationEvents s_nullSimulationEvents;
+
+
+MapSimulation::~MapSimulation()
+{
+	DeleteAllEnemies();
+	DeleteAllTowers();
+}
+
+MapSimulation::MapSimulation(MapDefinition const& mapDef, JobSystem* jobSystem)
+	: m_jobSystem(jobSystem)
+	, m_definition(mapDef)
+	, m_events(&s_nullSimulationEvents)
+{
+	m_money = m_definition.m_startingMoney;
+	m_remainingLives = m_definition.m_lives;
+
+	// Seeded from the map alone, so every run of a level draws the same gameplay rolls, rendered or not
+	m_simulationRNG = SimulationRNG(HashBytes(FNV_OFFSET_BASIS, m_definition.m_name.data(), m_definition.m_name.size()));
+}
+
+void MapSimulation::Initialize()
+{
+	DecodeMapImage();
+	InitializeBlockLists();
+	ComputeHeatMap(m_blocks, m_heatMap);
+	GenerateFlowField();
+}
+
+void MapSimulation::DeleteAllEnemies()
+{
+	for (int enemyIndex = m_enemies.GetCount() - 1; enemyIndex >= 0; enemyIndex--)
+	{
+		delete m_enemies[enemyIndex];
+	}
+	m_enemies.Clear();
+	m_enemySimData.Clear();
+	m_enemyGrid.Clear();
+}
+
+void MapSimulation::DeleteAllTowers()
+{
+	for (int towerIndex = (int)m_towers.size() - 1; towerIndex >= 0; towerIndex--)
+	{
+		delete m_towers[towerIndex];
+		m_towers[towerIndex] = nullptr;
+	}
+	m_towers.clear();
+	m_towersByBlock = Grid<Tower*>(m_dimensions, nullptr, nullptr);
+}
+
+void MapSimulation::DeleteDestroyedEnemies()
+{
+	for (int enemyIndex = 0; enemyIndex < m_enemies.GetCount(); enemyIndex++)
+	{
+		Enemy* enemy = m_enemies[enemyIndex];
+		if (enemy->m_isDestroyed)
+		{
+			// Removal swaps the last enemy into this index, so visit the same index again
+			m_enemyGrid.RemoveEnemy(enemy);
+			m_enemySimData.RemoveEnemy(enemy->m_simIndex);
+			m_enemies.Remove(enemy->m_handle);
+			delete enemy;
+			enemyIndex--;
+		}
+	}
+
+	if (!m_isLevelComplete && m_remainingLives >= 0 && m_enemies.IsEmpty() && m_nextWaveIndex == (int)m_definition.m_waves.size())
+	{
+		m_isLevelComplete = true;
+		m_score /= m_numEnemiesInLevel;
+		m_stars = (int)GetClamped(float(m_score / 25), 0.f, 3.f);
+		m_events->OnLevelComplete();
+	}
+}
+
+void MapSimulation::DecodeMapImage()
+{
+	Image mapImage = Image(m_definition.m_mapImageName.c_str());
+	m_dimensions = mapImage.GetDimensions();
+
+	m_blocks = Grid<Block>(m_dimensions);
+	Vec2 mapCenter = Vec2((float)m_dimensions.y * 0.5f, (float)m_dimensions.x * 0.5f);
+	uint8_t const rockTypeID = BlockDefinition::s_blockDefs["Rock"].m_typeID;
+	uint8_t const treeTypeID = BlockDefinition::s_blockDefs["Tree"].m_typeID;
+	uint8_t const treeDoubleTypeID = BlockDefinition::s_blockDefs["TreeDouble"].m_typeID;
+	uint8_t const treeQuadTypeID = BlockDefinition::s_blockDefs["TreeQuad"].m_typeID;
+	uint8_t const crystalTypeID = BlockDefinition::s_blockDefs["Crystal"].m_typeID;
+	unsigned int const decorationSeed = m_definition.m_decorationSeed;
+
+	// One pass over the image in texel order, resolving each color through the palette straight into the block grid
+	// Decorations are noise of the block coordinates and the map's seed rather than g_RNG rolls, so the same inputs always cook to the same map
+	for (int blockY = 0; blockY < m_dimensions.y; blockY++)
+	{
+		for (int blockX = 0; blockX < m_dimensions.x; blockX++)
+		{
+			IntVec2 blockCoords = IntVec2(blockX, blockY);
+			Block& block = m_blocks.Get(blockCoords);
+			block = Block(mapImage.GetTexelColor(blockCoords));
+
+			if (block.CanPlaceTower() && GetDistanceSquared2D(mapCenter, blockCoords.GetAsVec2()) >= 100.f)
+			{
+				block.m_typeID = rockTypeID;
+
+				if (Get3dNoiseZeroToOne(blockX, blockY, 0, decorationSeed) < 0.25f)
+				{
+					block.m_typeID = treeTypeID;
+				}
+				else if (Get3dNoiseZeroToOne(blockX, blockY, 1, decorationSeed) < 0.25f)
+				{
+					block.m_typeID = treeDoubleTypeID;
+				}
+				else if (Get3dNoiseZeroToOne(blockX, blockY, 2, decorationSeed) < 0.25f)
+				{
+					block.m_typeID = treeQuadTypeID;
+				}
+				else if (Get3dNoiseZeroToOne(blockX, blockY, 3, decorationSeed) < 0.25f)
+				{
+					block.m_typeID = crystalTypeID;
+				}
+			}
+		}
+	}
+}
+
+void MapSimulation::InitializeBlockLists()
+{
+	m_enemyGrid = EnemySpatialGrid(m_dimensions);
+	m_towersByBlock = Grid<Tower*>(m_dimensions, nullptr, nullptr);
+	for (int blockY = 0; blockY < m_dimensions.y; blockY++)
+	{
+		for (int blockX = 0; blockX < m_dimensions.x; blockX++)
+		{
+			IntVec2 blockCoords = IntVec2(blockX, blockY);
+			Block const& block = m_blocks.Get(blockCoords);
+			if (block.IsStartBlock())
+			{
+				m_startBlocks.push_back(blockCoords);
+			}
+			else if (block.IsEndBlock())
+			{
+				m_endBlocks.push_back(blockCoords);
+			}
+			else if (block.IsTree())
+			{
+				m_treeBlocks.push_back(blockCoords);
+			}
+			else if (block.IsCrystal())
+			{
+				m_crystalBlocks.push_back(blockCoords);
+			}
+		}
+	}
+
+	if (m_startBlocks.empty())
+	{
+		ERROR_AND_DIE("Attempted to initialize map with no start blocks!");
+	}
+
+	if (m_endBlocks.empty())
+	{
+		ERROR_AND_DIE("Attempted to intialize map with no end blocks!");
+	}
+
+	ComputeClosestPathBlocks(m_blocks, m_closestPathBlockIndexes);
+}
+
+void MapSimulation::GenerateFlowField()
+{
+	// Every traversable block points at the neighbor one step closer to the nearest end block
+	// End blocks and blocks that cannot reach an end block point nowhere
+	m_flowField = Grid<int>(m_dimensions, -1, -1);
+
+	// The border's heat is negative, so it never matches a heat value one less than a traversable block's
+	GridDirection const neighborDirections[] = { GridDirection::SOUTH, GridDirection::NORTH, GridDirection::EAST, GridDirection::WEST };
+
+	for (int blockY = 0; blockY < m_dimensions.y; blockY++)
+	{
+		for (int blockX = 0; blockX < m_dimensions.x; blockX++)
+		{
+			int blockIndex = m_blocks.GetIndex(blockX, blockY);
+			float heatValue = m_heatMap[blockIndex];
+			if (heatValue == 0.f || !m_blocks[blockIndex].IsEnemyTraversable())
+			{
+				continue;
+			}
+
+			for (int directionIndex = 0; directionIndex < 4; directionIndex++)
+			{
+				int neighborIndex = m_blocks.GetNeighborIndex(blockIndex, neighborDirections[directionIndex]);
+				if (m_heatMap[neighborIndex] == heatValue - 1.f)
+				{
+					m_flowField[blockIndex] = neighborIndex;
+					break;
+				}
+			}
+		}
+	}
+}
+
+int MapSimulation::GetBlockIndexFromCoords(IntVec2 const& blockCoords) const
+{
+	return m_blocks.GetIndex(blockCoords);
+}
+
+int MapSimulation::GetBlockIndexFromCoords(int blockX, int blockY) const
+{
+	return m_blocks.GetIndex(blockX, blockY);
+}
+
+IntVec2 MapSimulation::GetBlockCoordsFromIndex(int blockIndex) const
+{
+	return m_blocks.GetCoords(blockIndex);
+}
+
+IntVec2 MapSimulation::GetBlockCoordsForPoint(Vec3 const& pointCoords) const
+{
+	return IntVec2(RoundDownToInt(pointCoords.x), RoundDownToInt(pointCoords.y));
+}
+
+int MapSimulation::GetNextBlockIndexTowardsEnd(int blockIndex) const
+{
+	return m_flowField[blockIndex];
+}
+
+int MapSimulation::GetPathLengthToEnd(IntVec2 const& blockCoords) const
+{
+	return RoundDownToInt(m_heatMap.Get(blockCoords));
+}
+
+void MapSimulation::FixedUpdate(float deltaSeconds)
+{
+	m_fixedTimeForWaveSpawning += deltaSeconds;
+	m_waveTimer.Advance(deltaSeconds);
+
+	if (!m_isWaveOngoing && m_nextWaveIndex < (int)m_definition.m_waves.size() && m_fixedTimeForWaveSpawning > m_definition.m_waves[m_nextWaveIndex].m_startTime)
+	{
+		Wave& wave = m_definition.m_waves[m_nextWaveIndex];
+		m_isWaveOngoing = true;
+		m_waveTimer = FixedStepTimer(wave.m_enemyInterval);
+		m_waveTimer.Start();
+		m_currentWaveIndex++;
+	}
+
+	if (m_isWaveOngoing)
+	{
+		while (m_waveTimer.DecrementDurationIfElapsed())
+		{
+			Wave const& wave = m_definition.m_waves[m_currentWaveIndex];
+			SpawnEnemy(wave.m_enemyNames[m_currentEnemyIndex], m_startBlocks[0].GetAsVec2().ToVec3() + Vec3::EAST * 0.5f + Vec3::NORTH * 0.5f);
+			m_currentEnemyIndex++;
+
+			if (m_currentEnemyIndex == (int)wave.m_enemyNames.size())
+			{
+				m_isWaveOngoing = false;
+				m_nextWaveIndex++;
+				m_waveTimer.Stop();
+				m_currentEnemyIndex = 0;
+			}
+		}
+	}
+
+	FixedUpdateEnemies(deltaSeconds);
+	FixedUpdateTowers(deltaSeconds);
+}
+
+void MapSimulation::FixedUpdateTowers(float deltaSeconds)
+{
+	constexpr int TOWERS_PER_JOB = 16;
+
+	// Gather: every tower finds its target against the enemy state at the start of the phase
+	int numTowers = (int)m_towers.size();
+	m_gatheredTowerTargets.resize(numTowers);
+	m_jobSystem->ParallelFor(numTowers, TOWERS_PER_JOB, [this](int firstTowerIndex, int endTowerIndex)
+	{
+		for (int towerIndex = firstTowerIndex; towerIndex < endTowerIndex; towerIndex++)
+		{
+			m_gatheredTowerTargets[towerIndex] = m_towers[towerIndex]->GatherTarget();
+		}
+	});
+
+	// Apply: towers turn and fire in order. Shots only ever remove enemies, so a gathered target that is still alive is
+	// what a serial update would have picked; only towers whose target was killed earlier in the phase look again
+	for (int towerIndex = 0; towerIndex < numTowers; towerIndex++)
+	{
+		Enemy* target = m_gatheredTowerTargets[towerIndex];
+		if (target && !IsEnemyAlive(target))
+		{
+			target = m_towers[towerIndex]->GatherTarget();
+		}
+		m_towers[towerIndex]->FixedUpdate(deltaSeconds, target);
+	}
+}
+
+void MapSimulation::FixedUpdateEnemies(float deltaSeconds)
+{
+	for (int enemyIndex = 0; enemyIndex < m_enemies.GetCount(); enemyIndex++)
+	{
+		m_enemies[enemyIndex]->FixedUpdate(deltaSeconds);
+	}
+
+	// Movement only touches each enemy's own lanes, so it can be split across threads in whole SIMD lanes
+	constexpr int ENEMIES_PER_JOB = 256;
+	m_jobSystem->ParallelFor(m_enemySimData.m_numEnemies, ENEMIES_PER_JOB, [this, deltaSeconds](int firstSimIndex, int endSimIndex)
+	{
+		m_enemySimData.UpdateMovement(deltaSeconds, firstSimIndex, endSimIndex);
+	});
+
+	for (int enemyIndex = 0; enemyIndex < m_enemies.GetCount(); enemyIndex++)
+	{
+		Enemy* enemy = m_enemies[enemyIndex];
+		enemy->UpdateStatusEffects(deltaSeconds);
+		if (enemy->m_isDead)
+		{
+			m_enemyGrid.RemoveEnemy(enemy);
+		}
+		else
+		{
+			m_enemyGrid.UpdateEnemy(enemy);
+		}
+	}
+}
+
+Tower* MapSimulation::SpawnTower(std::string towerName, Vec3 const& towerPosition)
+{
+	TowerDefinition const& towerDef = TowerDefinition::s_towerDefs[towerName];
+
+	if (towerDef.m_cost > m_money)
+	{
+		m_events->OnTowerUnaffordable();
+		return nullptr;
+	}
+
+	Tower* tower = new Tower(this, towerDef, towerPosition);
+	m_money -= towerDef.m_cost;
+	m_towers.push_back(tower);
+	m_events->OnTowerPlaced(*tower);
+	return tower;
+}
+
+Tower* MapSimulation::PlaceTowerAtBlock(std::string const& towerName, IntVec2 const& blockCoords)
+{
+	if (!m_blocks.IsInBounds(blockCoords))
+	{
+		return nullptr;
+	}
+
+	int blockIndex = GetBlockIndexFromCoords(blockCoords);
+	if (!m_blocks[blockIndex].CanPlaceTower() || GetTowerAtBlock(blockIndex))
+	{
+		return nullptr;
+	}
+
+	Tower* tower = SpawnTower(towerName, blockCoords.GetAsVec2().ToVec3() + Vec3(0.5f, 0.5f, 0.f));
+	if (tower)
+	{
+		m_towersByBlock[blockIndex] = tower;
+	}
+	return tower;
+}
+
+Tower* MapSimulation::GetTowerAtBlock(int blockIndex) const
+{
+	return m_towersByBlock[blockIndex];
+}
+
+Enemy* MapSimulation::SpawnEnemy(std::string enemyName, Vec3 const& enemyPosition, EulerAngles const& enemyOrientation)
+{
+	EnemyDefinition const& enemyDef = EnemyDefinition::s_enemyDefs[enemyName];
+	Enemy* enemy = new Enemy(this, &enemyDef, enemyPosition, enemyOrientation);
+	enemy->m_spawnIndex = m_numEnemiesInLevel;
+	enemy->m_handle = m_enemies.Add(enemy);
+	m_enemyGrid.AddEnemy(enemy);
+	m_numEnemiesInLevel++;
+	return enemy;
+}
+
+Vec2 MapSimulation::GetClosestPathBlock(Vec3 const& referencePosition) const
+{
+	IntVec2 referenceBlockCoords = GetBlockCoordsForPoint(referencePosition);
+	referenceBlockCoords.x = GetClamped(referenceBlockCoords.x, 0, m_dimensions.x - 1);
+	referenceBlockCoords.y = GetClamped(referenceBlockCoords.y, 0, m_dimensions.y - 1);
+
+	IntVec2 closestBlockCoords = referenceBlockCoords;
+	int closestBlockIndex = m_closestPathBlockIndexes[GetBlockIndexFromCoords(referenceBlockCoords)];
+	if (closestBlockIndex != -1)
+	{
+		closestBlockCoords = GetBlockCoordsFromIndex(closestBlockIndex);
+	}
+
+	return (closestBlockCoords.GetAsVec2() + Vec2(0.5f, 0.5f));
+}
+
+// Unit cost BFS outward from every end block through enemy traversable blocks
+// Blocks no end block can be reached from keep HEATMAP_MAX_COST; the border is -1 so the flow field never points at it
+void MapSimulation::ComputeHeatMap(Grid<Block> const& blocks, Grid<float>& out_heatMap)
+{
+	constexpr float HEATMAP_MAX_COST = 99999.f;
+	IntVec2 dimensions = blocks.GetDimensions();
+	out_heatMap = Grid<float>(dimensions, HEATMAP_MAX_COST, -1.f);
+
+	std::vector<int> blockQueue;
+	blockQueue.reserve(dimensions.x * dimensions.y);
+	for (int blockY = 0; blockY < dimensions.y; blockY++)
+	{
+		for (int blockX = 0; blockX < dimensions.x; blockX++)
+		{
+			int blockIndex = blocks.GetIndex(blockX, blockY);
+			if (blocks[blockIndex].IsEndBlock())
+			{
+				out_heatMap[blockIndex] = 0.f;
+				blockQueue.push_back(blockIndex);
+			}
+		}
+	}
+
+	// Border blocks are never traversable and border heat is below any real heat, so neither test needs the coordinates
+	FloodFillGrid(blocks, blockQueue, [&](int fromIndex, int toIndex)
+	{
+		float nextHeatValue = out_heatMap[fromIndex] + 1.f;
+		if (out_heatMap[toIndex] > nextHeatValue && blocks[toIndex].IsEnemyTraversable())
+		{
+			out_heatMap[toIndex] = nextHeatValue;
+			return true;
+		}
+		return false;
+	});
+}
+
+// Multi-source BFS from every enemy traversable block over the whole map, so each block ends up with a path block at the smallest Manhattan distance
+// Ties between equally close path blocks go to the lowest row, then the lowest column, so the result does not depend on the order blocks are visited in
+// Path blocks are their own closest path block; every block is -1 only if the map has no path at all
+void MapSimulation::ComputeClosestPathBlocks(Grid<Block> const& blocks, Grid<int>& out_closestPathBlockIndexes)
+{
+	IntVec2 dimensions = blocks.GetDimensions();
+	out_closestPathBlockIndexes = Grid<int>(dimensions, -1, -2);
+	Grid<int> pathDistances(dimensions, -1, -2);
+
+	std::vector<int> blockQueue;
+	blockQueue.reserve(dimensions.x * dimensions.y);
+	for (int blockY = 0; blockY < dimensions.y; blockY++)
+	{
+		for (int blockX = 0; blockX < dimensions.x; blockX++)
+		{
+			int blockIndex = blocks.GetIndex(blockX, blockY);
+			if (blocks[blockIndex].IsEnemyTraversable())
+			{
+				out_closestPathBlockIndexes[blockIndex] = blockIndex;
+				pathDistances[blockIndex] = 0;
+				blockQueue.push_back(blockIndex);
+			}
+		}
+	}
+
+	// The border distance is -2, so it is neither taken for an unvisited block nor for one a step further out
+	// A block's nearest path blocks are exactly those of its neighbors one step closer, and all of those are final before it is dequeued,
+	// so keeping the lowest index any of them offers is the lowest index among all of its nearest path blocks
+	// Row-major storage indexes grow with the row, then the column
+	FloodFillGrid(blocks, blockQueue, [&](int fromIndex, int toIndex)
+	{
+		int toDistance = pathDistances[fromIndex] + 1;
+		if (pathDistances[toIndex] == -1)
+		{
+			pathDistances[toIndex] = toDistance;
+			out_closestPathBlockIndexes[toIndex] = out_closestPathBlockIndexes[fromIndex];
+			return true;
+		}
+		if (pathDistances[toIndex] == toDistance && out_closestPathBlockIndexes[fromIndex] < out_closestPathBlockIndexes[toIndex])
+		{
+			out_closestPathBlockIndexes[toIndex] = out_closestPathBlockIndexes[fromIndex];
+		}
+		return false;
+	});
+}
+
+Enemy* MapSimulation::GetTargetWithinRange(Vec3 const& towerPosition, float range)
+{
+	Enemy* target = nullptr;
+	float targetHeatValue = 99999.f;
+
+	IntVec2 cellMins;
+	IntVec2 cellMaxs;
+	m_enemyGrid.GetCellBoundsForDisc(towerPosition.GetXY(), range, cellMins, cellMaxs);
+
+	for (int cellY = cellMins.y; cellY <= cellMaxs.y; cellY++)
+	{
+		for (int cellX = cellMins.x; cellX <= cellMaxs.x; cellX++)
+		{
+			// All enemies in a cell share the heat value of that block, so farther cells can be skipped entirely
+			float cellHeatValue = m_heatMap.Get(IntVec2(cellX, cellY));
+			if (cellHeatValue > targetHeatValue)
+			{
+				continue;
+			}
+
+			std::vector<Enemy*> const& cellEnemies = m_enemyGrid.GetEnemiesInCell(cellX, cellY);
+			for (int cellEnemyIndex = 0; cellEnemyIndex < (int)cellEnemies.size(); cellEnemyIndex++)
+			{
+				Enemy* const& enemy = cellEnemies[cellEnemyIndex];
+				if (!IsEnemyAlive(enemy))
+				{
+					continue;
+				}
+
+				if (!IsPointInsideDisc2D(enemy->GetPosition().GetXY(), towerPosition.GetXY(), range))
+				{
+					continue;
+				}
+
+				// Ties go to the earliest spawned enemy so the choice does not depend on storage order
+				bool isCloserToGoal = cellHeatValue < targetHeatValue;
+				bool isEarlierAtSameHeat = target && cellHeatValue == targetHeatValue && enemy->m_spawnIndex < target->m_spawnIndex;
+				if (isCloserToGoal || isEarlierAtSameHeat)
+				{
+					target = enemy;
+					targetHeatValue = cellHeatValue;
+				}
+			}
+		}
+	}
+
+	return target;
+}
+
+Enemy* MapSimulation::GetEnemy(EnemyHandle const& handle) const
+{
+	return m_enemies.Get(handle);
+}
+
+bool MapSimulation::IsEnemyAlive(Enemy* enemy) const
+{
+	return enemy && !enemy->m_isDead;
+}
+
+void MapSimulation::DecrementLives()
+{
+	m_remainingLives--;
+
+	if (m_remainingLives < 0)
+	{
+		m_events->OnLevelFailed();
+		return;
+	}
+
+	m_events->OnLifeLost();
+}
+
+bool MapSimulation::IsLevelComplete() const
+{
+	return m_isLevelComplete;
+}
+
+bool MapSimulation::IsLevelFailed() const
+{
+	return m_remainingLives < 0;
+}
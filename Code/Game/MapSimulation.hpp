@@ -0,0 +1,112 @@
+#pragma once
+
+#include "Game/Block.hpp"
+#include "Game/EnemySimData.hpp"
+#include "Game/EnemySlotMap.hpp"
+#include "Game/EnemySpatialGrid.hpp"
+#include "Game/FixedStepTimer.hpp"
+#include "Game/Grid.hpp"
+#include "Game/MapDefinition.hpp"
+#include "Game/SimulationRNG.hpp"
+
+#include "Engine/Math/EulerAngles.hpp"
+#include "Engine/Math/IntVec2.hpp"
+#include "Engine/Math/Vec2.hpp"
+#include "Engine/Math/Vec3.hpp"
+
+#include <string>
+#include <vector>
+
+
+class Enemy;
+class JobSystem;
+class SimulationEvents;
+class Tower;
+
+
+// Everything about a level that is stepped at the fixed physics rate: blocks, paths, waves, towers, enemies and status effects
+// It never touches the renderer, audio or input, and reports what happens through m_events, so it builds into the renderer-free
+// simulation library that the reytd-sim command line runner links; Map derives from it and adds the presentation
+class MapSimulation
+{
+public:
+	static constexpr float FIXED_PHYSICS_TIMESTEP = 0.0167f;
+
+public:
+	virtual ~MapSimulation();
+	MapSimulation() = default;
+	MapSimulation(MapDefinition const& mapDef, JobSystem* jobSystem);
+
+	// Decodes the map image and builds everything the simulation reads from the blocks
+	// Map builds the same state itself, so it can take the blocks and heat map from its cooked cache instead
+	void Initialize();
+	void DecodeMapImage();
+	void InitializeBlockLists();
+	void GenerateFlowField();
+
+	IntVec2 GetBlockCoordsFromIndex(int blockIndex) const;
+	int GetBlockIndexFromCoords(int blockX, int blockY) const;
+	int GetBlockIndexFromCoords(IntVec2 const& blocKCoords) const;
+	IntVec2 GetBlockCoordsForPoint(Vec3 const& pointCoords) const;
+	int GetNextBlockIndexTowardsEnd(int blockIndex) const;
+	int GetPathLengthToEnd(IntVec2 const& blockCoords) const;
+
+	void FixedUpdate(float deltaSeconds);
+	void FixedUpdateEnemies(float deltaSeconds);
+	void FixedUpdateTowers(float deltaSeconds);
+
+	Tower* SpawnTower(std::string towerName, Vec3 const& towerPosition);
+	Tower* PlaceTowerAtBlock(std::string const& towerName, IntVec2 const& blockCoords);
+	Tower* GetTowerAtBlock(int blockIndex) const;
+	Enemy* SpawnEnemy(std::string enemyName, Vec3 const& enemyPosition, EulerAngles const& enemyOrientation = EulerAngles::ZERO);
+
+	Vec2 GetClosestPathBlock(Vec3 const& referencePosition) const;
+	static void ComputeHeatMap(Grid<Block> const& blocks, Grid<float>& out_heatMap);
+	static void ComputeClosestPathBlocks(Grid<Block> const& blocks, Grid<int>& out_closestPathBlockIndexes);
+	Enemy* GetTargetWithinRange(Vec3 const& towerPosition, float range);
+	Enemy* GetEnemy(EnemyHandle const& handle) const;
+	bool IsEnemyAlive(Enemy* enemy) const;
+
+	void DecrementLives();
+	bool IsLevelComplete() const;
+	bool IsLevelFailed() const;
+
+	void DeleteDestroyedEnemies();
+	void DeleteAllEnemies();
+	void DeleteAllTowers();
+
+public:
+	JobSystem* m_jobSystem = nullptr;
+	MapDefinition m_definition;
+	// Points at a NullSimulationEvents unless a presentation is listening
+	SimulationEvents* m_events = nullptr;
+	SimulationRNG m_simulationRNG;
+	IntVec2 m_dimensions = IntVec2::ZERO;
+	Grid<Block> m_blocks;
+	// Shares m_blocks' storage indexes, so a block index looks its tower up directly
+	Grid<Tower*> m_towersByBlock;
+	std::vector<Tower*> m_towers;
+	std::vector<Enemy*> m_gatheredTowerTargets;
+	EnemySlotMap m_enemies;
+	EnemySimData m_enemySimData;
+	EnemySpatialGrid m_enemyGrid;
+	Grid<float> m_heatMap;
+	Grid<int> m_flowField;
+	Grid<int> m_closestPathBlockIndexes;
+	std::vector<IntVec2> m_startBlocks;
+	std::vector<IntVec2> m_endBlocks;
+	std::vector<IntVec2> m_treeBlocks;
+	std::vector<IntVec2> m_crystalBlocks;
+	float m_fixedTimeForWaveSpawning = 0.f;
+	int m_currentWaveIndex = -1;
+	int m_nextWaveIndex = 0;
+	int m_currentEnemyIndex = 0;
+	FixedStepTimer m_waveTimer;
+	bool m_isWaveOngoing = false;
+	bool m_isLevelComplete = false;
+	int m_money = 0;
+	int m_remainingLives = 0;
+	int m_score = 0;
+	int m_numEnemiesInLevel = 0;
+	int m_stars = 0;
+};
@@ -0,0 +1,313 @@
+#include "Game/MeshIndexing.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+
+constexpr float FORSYTH_CACHE_DECAY_POWER = 1.5f;
+constexpr float FORSYTH_LAST_TRIANGLE_SCORE = 0.75f;
+constexpr float FORSYTH_VALENCE_BOOST_SCALE = 2.f;
+constexpr float FORSYTH_VALENCE_BOOST_POWER = 0.5f;
+
+
+static unsigned int HashVertex(Vertex_PCUTBN const& vertex)
+{
+	// FNV-1a over the raw bytes, matching the bitwise comparison used for welding
+	unsigned char const* bytes = reinterpret_cast<unsigned char const*>(&vertex);
+	unsigned int hash = 2166136261u;
+	for (size_t byteIndex = 0; byteIndex < sizeof(Vertex_PCUTBN); byteIndex++)
+	{
+		hash ^= bytes[byteIndex];
+		hash *= 16777619u;
+	}
+
+	return hash;
+}
+
+static float GetForsythVertexScore(int cachePosition, int numActiveTriangles)
+{
+	if (numActiveTriangles == 0)
+	{
+		return -1.f;
+	}
+
+	float score = 0.f;
+	if (cachePosition >= 0)
+	{
+		// The last triangle's vertexes get a fixed score so the next triangle does not simply reuse its edge
+		if (cachePosition < 3)
+		{
+			score = FORSYTH_LAST_TRIANGLE_SCORE;
+		}
+		else
+		{
+			float cacheFraction = 1.f - (float)(cachePosition - 3) / (float)(VERTEX_CACHE_SIZE - 3);
+			score = powf(cacheFraction, FORSYTH_CACHE_DECAY_POWER);
+		}
+	}
+
+	// Vertexes with few triangles left are boosted so they get finished off instead of stranded
+	score += FORSYTH_VALENCE_BOOST_SCALE * powf((float)numActiveTriangles, -FORSYTH_VALENCE_BOOST_POWER);
+	return score;
+}
+
+void WeldVertexes(std::vector<Vertex_PCUTBN> const& verts, std::vector<Vertex_PCUTBN>& out_uniqueVerts, std::vector<unsigned int>& out_indexes)
+{
+	out_uniqueVerts.clear();
+	out_indexes.clear();
+	out_indexes.reserve(verts.size());
+
+	// Open addressing table of indexes into out_uniqueVerts, kept at most half full
+	size_t tableSize = 16;
+	while (tableSize < verts.size() * 2)
+	{
+		tableSize <<= 1;
+	}
+	size_t tableMask = tableSize - 1;
+	std::vector<int> table(tableSize, -1);
+
+	for (size_t vertexIndex = 0; vertexIndex < verts.size(); vertexIndex++)
+	{
+		Vertex_PCUTBN const& vertex = verts[vertexIndex];
+		size_t slot = HashVertex(vertex) & tableMask;
+		while (true)
+		{
+			int uniqueIndex = table[slot];
+			if (uniqueIndex < 0)
+			{
+				table[slot] = (int)out_uniqueVerts.size();
+				out_indexes.push_back((unsigned int)out_uniqueVerts.size());
+				out_uniqueVerts.push_back(vertex);
+				break;
+			}
+			if (memcmp(&out_uniqueVerts[uniqueIndex], &vertex, sizeof(Vertex_PCUTBN)) == 0)
+			{
+				out_indexes.push_back((unsigned int)uniqueIndex);
+				break;
+			}
+			slot = (slot + 1) & tableMask;
+		}
+	}
+}
+
+void OptimizeIndexOrderForVertexCache(std::vector<unsigned int>& indexes, int numVerts)
+{
+	int numTriangles = (int)indexes.size() / 3;
+	if (numTriangles == 0)
+	{
+		return;
+	}
+
+	// Triangles adjacent to each vertex, packed per vertex; the first numActiveTriangles of each range are not emitted yet
+	std::vector<int> numActiveTriangles(numVerts, 0);
+	for (int cornerIndex = 0; cornerIndex < numTriangles * 3; cornerIndex++)
+	{
+		numActiveTriangles[indexes[cornerIndex]]++;
+	}
+	std::vector<int> adjacencyStarts(numVerts + 1, 0);
+	for (int vertexIndex = 0; vertexIndex < numVerts; vertexIndex++)
+	{
+		adjacencyStarts[vertexIndex + 1] = adjacencyStarts[vertexIndex] + numActiveTriangles[vertexIndex];
+	}
+	std::vector<int> adjacentTriangles(numTriangles * 3);
+	std::vector<int> numAdjacentFilled(numVerts, 0);
+	for (int cornerIndex = 0; cornerIndex < numTriangles * 3; cornerIndex++)
+	{
+		unsigned int vertexIndex = indexes[cornerIndex];
+		adjacentTriangles[adjacencyStarts[vertexIndex] + numAdjacentFilled[vertexIndex]] = cornerIndex / 3;
+		numAdjacentFilled[vertexIndex]++;
+	}
+
+	std::vector<int> cachePositions(numVerts, -1);
+	std::vector<float> vertexScores(numVerts);
+	for (int vertexIndex = 0; vertexIndex < numVerts; vertexIndex++)
+	{
+		vertexScores[vertexIndex] = GetForsythVertexScore(-1, numActiveTriangles[vertexIndex]);
+	}
+	std::vector<unsigned char> isTriangleEmitted(numTriangles, 0);
+
+	std::vector<unsigned int> orderedIndexes;
+	orderedIndexes.reserve(indexes.size());
+	int cache[VERTEX_CACHE_SIZE + 3];
+	int cacheCount = 0;
+	int nextUnemittedTriangle = 0;
+	int bestTriangle = -1;
+
+	for (int emittedCount = 0; emittedCount < numTriangles; emittedCount++)
+	{
+		// With nothing useful left in the cache, restart from the first triangle not emitted yet
+		if (bestTriangle < 0)
+		{
+			while (isTriangleEmitted[nextUnemittedTriangle])
+			{
+				nextUnemittedTriangle++;
+			}
+			bestTriangle = nextUnemittedTriangle;
+		}
+
+		int triangle = bestTriangle;
+		isTriangleEmitted[triangle] = 1;
+		unsigned int const* corners = &indexes[triangle * 3];
+		orderedIndexes.push_back(corners[0]);
+		orderedIndexes.push_back(corners[1]);
+		orderedIndexes.push_back(corners[2]);
+
+		// The triangle's vertexes move to the front of the cache, everything else shifts back and the overflow is evicted
+		int newCache[VERTEX_CACHE_SIZE + 3];
+		int newCacheCount = 0;
+		for (int cornerIndex = 0; cornerIndex < 3; cornerIndex++)
+		{
+			int vertexIndex = (int)corners[cornerIndex];
+			if (std::find(newCache, newCache + newCacheCount, vertexIndex) != newCache + newCacheCount)
+			{
+				continue;
+			}
+			newCache[newCacheCount++] = vertexIndex;
+
+			int* activeTriangles = &adjacentTriangles[adjacencyStarts[vertexIndex]];
+			int& numActive = numActiveTriangles[vertexIndex];
+			for (int activeIndex = 0; activeIndex < numActive; activeIndex++)
+			{
+				if (activeTriangles[activeIndex] == triangle)
+				{
+					activeTriangles[activeIndex] = activeTriangles[numActive - 1];
+					activeTriangles[numActive - 1] = triangle;
+					numActive--;
+					break;
+				}
+			}
+		}
+		for (int cacheIndex = 0; cacheIndex < cacheCount; cacheIndex++)
+		{
+			int vertexIndex = cache[cacheIndex];
+			if (std::find(newCache, newCache + newCacheCount, vertexIndex) == newCache + newCacheCount)
+			{
+				newCache[newCacheCount++] = vertexIndex;
+			}
+		}
+
+		for (int cacheIndex = 0; cacheIndex < newCacheCount; cacheIndex++)
+		{
+			int vertexIndex = newCache[cacheIndex];
+			cachePositions[vertexIndex] = cacheIndex < VERTEX_CACHE_SIZE ? cacheIndex : -1;
+			vertexScores[vertexIndex] = GetForsythVertexScore(cachePositions[vertexIndex], numActiveTriangles[vertexIndex]);
+		}
+
+		// Only triangles touching a vertex whose score just changed can become the best one
+		bestTriangle = -1;
+		float bestScore = -FLT_MAX;
+		for (int cacheIndex = 0; cacheIndex < newCacheCount; cacheIndex++)
+		{
+			int vertexIndex = newCache[cacheIndex];
+			int const* activeTriangles = &adjacentTriangles[adjacencyStarts[vertexIndex]];
+			for (int activeIndex = 0; activeIndex < numActiveTriangles[vertexIndex]; activeIndex++)
+			{
+				int candidate = activeTriangles[activeIndex];
+				unsigned int const* candidateCorners = &indexes[candidate * 3];
+				float score = vertexScores[candidateCorners[0]] + vertexScores[candidateCorners[1]] + vertexScores[candidateCorners[2]];
+				if (score > bestScore)
+				{
+					bestScore = score;
+					bestTriangle = candidate;
+				}
+			}
+		}
+
+		cacheCount = newCacheCount < VERTEX_CACHE_SIZE ? newCacheCount : VERTEX_CACHE_SIZE;
+		for (int cacheIndex = 0; cacheIndex < cacheCount; cacheIndex++)
+		{
+			cache[cacheIndex] = newCache[cacheIndex];
+		}
+	}
+
+	indexes.swap(orderedIndexes);
+}
+
+void OptimizeVertexOrderForFetch(std::vector<Vertex_PCUTBN>& verts, std::vector<unsigned int>& indexes)
+{
+	std::vector<int> newVertexIndexes(verts.size(), -1);
+	std::vector<Vertex_PCUTBN> orderedVerts;
+	orderedVerts.reserve(verts.size());
+	for (size_t cornerIndex = 0; cornerIndex < indexes.size(); cornerIndex++)
+	{
+		unsigned int vertexIndex = indexes[cornerIndex];
+		if (newVertexIndexes[vertexIndex] < 0)
+		{
+			newVertexIndexes[vertexIndex] = (int)orderedVerts.size();
+			orderedVerts.push_back(verts[vertexIndex]);
+		}
+		indexes[cornerIndex] = (unsigned int)newVertexIndexes[vertexIndex];
+	}
+
+	verts.swap(orderedVerts);
+}
+
+float GetAverageCacheMissRatio(std::vector<unsigned int> const& indexes, int cacheSize)
+{
+	int numTriangles = (int)indexes.size() / 3;
+	if (numTriangles == 0 || cacheSize <= 0)
+	{
+		return 0.f;
+	}
+
+	std::vector<unsigned int> cache(cacheSize);
+	int cacheCount = 0;
+	int cacheHead = 0;
+	int numMisses = 0;
+	for (size_t cornerIndex = 0; cornerIndex < indexes.size(); cornerIndex++)
+	{
+		unsigned int vertexIndex = indexes[cornerIndex];
+		if (std::find(cache.begin(), cache.begin() + cacheCount, vertexIndex) != cache.begin() + cacheCount)
+		{
+			continue;
+		}
+
+		numMisses++;
+		cache[cacheHead] = vertexIndex;
+		cacheHead = (cacheHead + 1) % cacheSize;
+		cacheCount = cacheCount < cacheSize ? cacheCount + 1 : cacheSize;
+	}
+
+	return (float)numMisses / (float)numTriangles;
+}
+
+bool DoIndexedTrianglesMatch(std::vector<Vertex_PCUTBN> const& flatVerts, std::vector<Vertex_PCUTBN> const& indexedVerts, std::vector<unsigned int> const& indexes)
+{
+	struct Triangle
+	{
+		Vertex_PCUTBN m_corners[3];
+	};
+
+	if (flatVerts.size() != indexes.size())
+	{
+		return false;
+	}
+	if (indexes.empty())
+	{
+		return true;
+	}
+
+	std::vector<Triangle> flatTriangles(flatVerts.size() / 3);
+	std::vector<Triangle> indexedTriangles(indexes.size() / 3);
+	for (size_t cornerIndex = 0; cornerIndex < indexes.size(); cornerIndex++)
+	{
+		if (indexes[cornerIndex] >= indexedVerts.size())
+		{
+			return false;
+		}
+
+		flatTriangles[cornerIndex / 3].m_corners[cornerIndex % 3] = flatVerts[cornerIndex];
+		indexedTriangles[cornerIndex / 3].m_corners[cornerIndex % 3] = indexedVerts[indexes[cornerIndex]];
+	}
+
+	auto isTriangleLess = [](Triangle const& triangleA, Triangle const& triangleB)
+	{
+		return memcmp(&triangleA, &triangleB, sizeof(Triangle)) < 0;
+	};
+	std::sort(flatTriangles.begin(), flatTriangles.end(), isTriangleLess);
+	std::sort(indexedTriangles.begin(), indexedTriangles.end(), isTriangleLess);
+
+	return memcmp(flatTriangles.data(), indexedTriangles.data(), flatTriangles.size() * sizeof(Triangle)) == 0;
+}
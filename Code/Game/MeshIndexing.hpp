@@ -0,0 +1,23 @@
+#pragma once
+
+#include "Engine/Core/VertexUtils.hpp"
+
+#include <vector>
+
+
+constexpr int VERTEX_CACHE_SIZE = 32;
+
+// Merges bitwise identical vertexes of a flat triangle list into one, producing the equivalent indexed triangle list
+void WeldVertexes(std::vector<Vertex_PCUTBN> const& verts, std::vector<Vertex_PCUTBN>& out_uniqueVerts, std::vector<unsigned int>& out_indexes);
+
+// Reorders triangles for the post-transform vertex cache with Forsyth's linear-speed greedy algorithm; each triangle keeps its winding
+void OptimizeIndexOrderForVertexCache(std::vector<unsigned int>& indexes, int numVerts);
+
+// Renumbers vertexes in the order the index list first uses them, so vertex fetches walk memory forward
+void OptimizeVertexOrderForFetch(std::vector<Vertex_PCUTBN>& verts, std::vector<unsigned int>& indexes);
+
+// Average number of vertex shader runs per triangle for a FIFO cache of the given size; 3 means no reuse at all
+float GetAverageCacheMissRatio(std::vector<unsigned int> const& indexes, int cacheSize);
+
+// True if the indexed triangles are exactly the flat triangles, in any order but with the same winding
+bool DoIndexedTrianglesMatch(std::vector<Vertex_PCUTBN> const& flatVerts, std::vector<Vertex_PCUTBN> const& indexedVerts, std::vector<unsigned int> const& indexes);
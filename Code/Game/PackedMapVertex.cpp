@@ -0,0 +1,183 @@
+#include "Game/PackedMapVertex.hpp"
+
+#include "Engine/Math/MathUtils.hpp"
+
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+
+
+static constexpr float TANGENT_ANGLE_STEP_RADIANS = 6.2831853f / (float)PACKED_MAP_TANGENT_ANGLE_STEPS;
+
+
+static uint8_t EncodeSignedUnitByte(float value)
+{
+	float clampedValue = GetClamped(value, -1.f, 1.f);
+	return (uint8_t)(128 + (int)roundf(clampedValue * 127.f));
+}
+
+static float DecodeSignedUnitByte(uint8_t value)
+{
+	return (float)((int)value - 128) / 127.f;
+}
+
+// Whole numbers up to 2^24 are exact in a float, and starting at 1 keeps the sign readable and the word away from zero
+static float EncodePackedWord(uint32_t payload, bool isNegative)
+{
+	float magnitude = (float)(payload + 1);
+	return isNegative ? -magnitude : magnitude;
+}
+
+static uint32_t DecodePackedWord(float word)
+{
+	return (uint32_t)fabsf(word) - 1;
+}
+
+// Orthonormal basis around a unit normal, continuous everywhere except across z = 0 (Duff et al.); must stay in step with the packed map shaders
+static void GetTangentBasis(Vec3 const& normal, Vec3& out_basisX, Vec3& out_basisY)
+{
+	float sign = normal.z >= 0.f ? 1.f : -1.f;
+	float a = -1.f / (sign + normal.z);
+	float b = normal.x * normal.y * a;
+	out_basisX = Vec3(1.f + sign * normal.x * normal.x * a, sign * b, -sign * normal.x);
+	out_basisY = Vec3(b, sign + normal.y * normal.y * a, -normal.y);
+}
+
+// The tangent is projected onto the plane of the normal it will be decoded against, so the rebuilt frame stays orthogonal
+static int EncodeTangentAngle(Vec3 const& tangent, Vec3 const& normal)
+{
+	Vec3 basisX;
+	Vec3 basisY;
+	GetTangentBasis(normal, basisX, basisY);
+	float x = DotProduct3D(tangent, basisX);
+	float y = DotProduct3D(tangent, basisY);
+	if (x == 0.f && y == 0.f)
+	{
+		return 0;
+	}
+
+	int angleSteps = (int)roundf(atan2f(y, x) / TANGENT_ANGLE_STEP_RADIANS);
+	return (angleSteps + PACKED_MAP_TANGENT_ANGLE_STEPS) % PACKED_MAP_TANGENT_ANGLE_STEPS;
+}
+
+static Vec3 DecodeTangentAngle(int angleSteps, Vec3 const& normal)
+{
+	Vec3 basisX;
+	Vec3 basisY;
+	GetTangentBasis(normal, basisX, basisY);
+	float angleRadians = (float)angleSteps * TANGENT_ANGLE_STEP_RADIANS;
+	return basisX * cosf(angleRadians) + basisY * sinf(angleRadians);
+}
+
+// Projects the direction onto the octahedron |x| + |y| + |z| = 1 and unfolds the lower half over the corners of the upper one
+uint16_t EncodeOctahedral(Vec3 const& direction)
+{
+	float manhattanLength = fabsf(direction.x) + fabsf(direction.y) + fabsf(direction.z);
+	if (manhattanLength == 0.f)
+	{
+		return (uint16_t)(EncodeSignedUnitByte(0.f) | (EncodeSignedUnitByte(0.f) << 8));
+	}
+
+	float octX = direction.x / manhattanLength;
+	float octY = direction.y / manhattanLength;
+	if (direction.z < 0.f)
+	{
+		float foldedX = (1.f - fabsf(octY)) * (octX >= 0.f ? 1.f : -1.f);
+		float foldedY = (1.f - fabsf(octX)) * (octY >= 0.f ? 1.f : -1.f);
+		octX = foldedX;
+		octY = foldedY;
+	}
+
+	return (uint16_t)(EncodeSignedUnitByte(octX) | (EncodeSignedUnitByte(octY) << 8));
+}
+
+// Must stay in step with DecodeOctahedral in the packed map shaders
+Vec3 DecodeOctahedral(uint16_t octDirection)
+{
+	float octX = DecodeSignedUnitByte((uint8_t)(octDirection & 0xFF));
+	float octY = DecodeSignedUnitByte((uint8_t)(octDirection >> 8));
+	Vec3 direction = Vec3(octX, octY, 1.f - fabsf(octX) - fabsf(octY));
+	float fold = GetClamped(-direction.z, 0.f, 1.f);
+	direction.x += direction.x >= 0.f ? -fold : fold;
+	direction.y += direction.y >= 0.f ? -fold : fold;
+	return direction.GetNormalized();
+}
+
+Vec3 GetPackedMapVertexOrigin(AABB3 const& bounds)
+{
+	return Vec3(floorf(bounds.m_mins.x), floorf(bounds.m_mins.y), floorf(bounds.m_mins.z));
+}
+
+Mat44 GetPackedMapVertexTransform(Vec3 const& origin)
+{
+	Mat44 transform = Mat44::CreateTranslation3D(origin);
+	transform.AppendScaleNonUniform3D(Vec3(PACKED_MAP_POSITION_STEP, PACKED_MAP_POSITION_STEP, PACKED_MAP_POSITION_STEP));
+	return transform;
+}
+
+bool EncodeMapVertexes(std::vector<Vertex_PCUTBN> const& verts, Vec3 const& origin, std::vector<Vertex_MapPacked>& out_packedVerts)
+{
+	out_packedVerts.resize(verts.size());
+	for (int vertexIndex = 0; vertexIndex < (int)verts.size(); vertexIndex++)
+	{
+		Vertex_PCUTBN const& vert = verts[vertexIndex];
+		Vertex_MapPacked& packedVert = out_packedVerts[vertexIndex];
+
+		float const offsets[3] = { vert.m_position.x - origin.x, vert.m_position.y - origin.y, vert.m_position.z - origin.z };
+		uint32_t quantizedPosition[3] = {};
+		for (int axisIndex = 0; axisIndex < 3; axisIndex++)
+		{
+			float steps = roundf(offsets[axisIndex] / PACKED_MAP_POSITION_STEP);
+			if (steps < 0.f || steps > 65535.f)
+			{
+				return false;
+			}
+			quantizedPosition[axisIndex] = (uint32_t)steps;
+		}
+
+		// Only the sign of the bitangent is kept; decoding rebuilds it from the normal and tangent
+		uint16_t octNormal = EncodeOctahedral(vert.m_normal);
+		uint32_t tangentAngle = (uint32_t)EncodeTangentAngle(vert.m_tangent, DecodeOctahedral(octNormal));
+		bool isBitangentFlipped = DotProduct3D(CrossProduct3D(vert.m_normal, vert.m_tangent), vert.m_bitangent) < 0.f;
+		packedVert.m_packedWords[0] = EncodePackedWord(quantizedPosition[0] | ((uint32_t)(octNormal & 0xFF) << 16), isBitangentFlipped);
+		packedVert.m_packedWords[1] = EncodePackedWord(quantizedPosition[1] | ((uint32_t)(octNormal >> 8) << 16), (tangentAngle & 0x100) != 0);
+		packedVert.m_packedWords[2] = EncodePackedWord(quantizedPosition[2] | ((tangentAngle & 0xFF) << 16), (tangentAngle & 0x200) != 0);
+		packedVert.m_color = vert.m_color;
+		packedVert.m_uv = vert.m_uvTexCoords;
+	}
+
+	return true;
+}
+
+Vertex_PCUTBN DecodeMapVertex(Vertex_MapPacked const& packedVert, Vec3 const& origin)
+{
+	uint32_t const words[3] = { DecodePackedWord(packedVert.m_packedWords[0]), DecodePackedWord(packedVert.m_packedWords[1]), DecodePackedWord(packedVert.m_packedWords[2]) };
+	uint16_t octNormal = (uint16_t)((words[0] >> 16) | ((words[1] >> 16) << 8));
+	int tangentAngle = (int)(words[2] >> 16) | (packedVert.m_packedWords[1] < 0.f ? 0x100 : 0) | (packedVert.m_packedWords[2] < 0.f ? 0x200 : 0);
+
+	Vertex_PCUTBN vert;
+	vert.m_position.x = origin.x + (float)(words[0] & 0xFFFF) * PACKED_MAP_POSITION_STEP;
+	vert.m_position.y = origin.y + (float)(words[1] & 0xFFFF) * PACKED_MAP_POSITION_STEP;
+	vert.m_position.z = origin.z + (float)(words[2] & 0xFFFF) * PACKED_MAP_POSITION_STEP;
+	vert.m_color = packedVert.m_color;
+	vert.m_uvTexCoords = packedVert.m_uv;
+	vert.m_normal = DecodeOctahedral(octNormal);
+	vert.m_tangent = DecodeTangentAngle(tangentAngle, vert.m_normal);
+	vert.m_bitangent = CrossProduct3D(vert.m_normal, vert.m_tangent).GetNormalized() * (packedVert.m_packedWords[0] < 0.f ? -1.f : 1.f);
+	return vert;
+}
+
+bool AreMapVertexWordsNormal(uint8_t const* vertexBytes, int numVerts)
+{
+	for (int vertexIndex = 0; vertexIndex < numVerts; vertexIndex++)
+	{
+		float packedWords[3] = {};
+		memcpy(packedWords, vertexBytes + vertexIndex * sizeof(Vertex_MapPacked) + offsetof(Vertex_MapPacked, m_packedWords), sizeof(packedWords));
+		if (!std::isnormal(packedWords[0]) || !std::isnormal(packedWords[1]) || !std::isnormal(packedWords[2]))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
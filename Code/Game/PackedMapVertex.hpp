@@ -0,0 +1,50 @@
+#pragma once
+
+#include "Engine/Core/Rgba8.hpp"
+#include "Engine/Core/VertexUtils.hpp"
+#include "Engine/Math/AABB3.hpp"
+#include "Engine/Math/Mat44.hpp"
+#include "Engine/Math/Vec2.hpp"
+
+#include <cstdint>
+#include <vector>
+
+
+// Positions are stored in steps of this size from an integer origin, so vertexes shared by neighboring chunks quantize to the same spot
+constexpr float PACKED_MAP_POSITION_STEP = 1.f / 2048.f;
+
+
+// Tangents are stored as an angle around the decoded normal in this many steps
+constexpr int PACKED_MAP_TANGENT_ANGLE_STEPS = 1024;
+
+
+// Static map vertex in 24 bytes instead of Vertex_PCUTBN's 60, laid out like Vertex_PCU so it is drawn through the renderer's VERTEX_PCU input layout
+// Each position float is a whole number, 1 more than a 24-bit payload, and its sign is one more bit, so the words stay normal floats through any conversion
+// x: quantized x | normal x byte << 16, sign bitangent flip; y: quantized y | normal y byte << 16, sign tangent angle bit 8; z: quantized z | tangent angle low byte << 16, sign tangent angle bit 9
+struct Vertex_MapPacked
+{
+public:
+	float m_packedWords[3] = { 1.f, 1.f, 1.f };
+	Rgba8 m_color = Rgba8::WHITE;
+	Vec2 m_uv;
+};
+
+static_assert(sizeof(Vertex_MapPacked) == sizeof(Vertex_PCU), "Packed map vertexes must match the VERTEX_PCU input layout");
+
+
+// Two 8-bit octahedral coordinates, x in the low byte; decoding always returns a unit vector
+uint16_t EncodeOctahedral(Vec3 const& direction);
+Vec3 DecodeOctahedral(uint16_t octDirection);
+
+// Integer corner of the bounds that packed positions are stored relative to
+Vec3 GetPackedMapVertexOrigin(AABB3 const& bounds);
+
+// Turns quantized positions back into world positions, for the model constants of a packed draw
+Mat44 GetPackedMapVertexTransform(Vec3 const& origin);
+
+// False, leaving out_packedVerts unspecified, if any position is too far from the origin to quantize
+bool EncodeMapVertexes(std::vector<Vertex_PCUTBN> const& verts, Vec3 const& origin, std::vector<Vertex_MapPacked>& out_packedVerts);
+Vertex_PCUTBN DecodeMapVertex(Vertex_MapPacked const& packedVert, Vec3 const& origin);
+
+// True if every packed word is a normal float, which is all the encoder writes; vertexBytes need not be aligned
+bool AreMapVertexWordsNormal(uint8_t const* vertexBytes, int numVerts);
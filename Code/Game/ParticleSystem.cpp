@@ -0,0 +1,283 @@
+#include "Game/ParticleSystem.hpp"
+
+#include "Game/GameCommon.hpp"
+#include "Game/RenderBackend.hpp"
+#include "Game/RenderCommandList.hpp"
+
+#include "Engine/Renderer/VertexBuffer.hpp"
+
+#include <emmintrin.h>
+
+
+std::map<std::string, Texture*> ParticleSystem::s_particleTextures;
+
+ParticleSystem::~ParticleSystem()
+{
+	DestroyBuffer(m_vertexBuffer);
+}
+
+ParticleSystem::ParticleSystem(int capacity)
+{
+	// Round up to whole lanes so the update kernel never reads past the end of the arrays
+	int numLanes = ((capacity + SIMD_WIDTH - 1) / SIMD_WIDTH) * SIMD_WIDTH;
+	m_positionX.resize(numLanes, 0.f);
+	m_positionY.resize(numLanes, 0.f);
+	m_positionZ.resize(numLanes, 0.f);
+	m_velocityX.resize(numLanes, 0.f);
+	m_velocityY.resize(numLanes, 0.f);
+	m_velocityZ.resize(numLanes, 0.f);
+	m_rotation.resize(numLanes, 0.f);
+	m_rotationSpeed.resize(numLanes, 0.f);
+	m_size.resize(numLanes, 0.f);
+	m_remainingLifetime.resize(numLanes, 0.f);
+	m_fadeRate.resize(numLanes, 0.f);
+	m_opacity.resize(numLanes, 0.f);
+	m_color.resize(numLanes, Rgba8::WHITE);
+	m_batchIndex.resize(numLanes, 0);
+}
+
+void ParticleSystem::Spawn(Vec3 const& startPos, Vec3 const& velocity, float rotation, float rotationSpeed, float size, float lifetime, Texture* texture, Rgba8 const& color, BlendMode blendMode, bool fadeOverLifetime)
+{
+	// The pool never grows; once it is full new particles are dropped until old ones expire
+	if (m_numParticles >= GetCapacity())
+	{
+		return;
+	}
+
+	int particleIndex = m_numParticles;
+	m_numParticles++;
+
+	m_positionX[particleIndex] = startPos.x;
+	m_positionY[particleIndex] = startPos.y;
+	m_positionZ[particleIndex] = startPos.z;
+	m_velocityX[particleIndex] = velocity.x;
+	m_velocityY[particleIndex] = velocity.y;
+	m_velocityZ[particleIndex] = velocity.z;
+	m_rotation[particleIndex] = rotation;
+	m_rotationSpeed[particleIndex] = rotationSpeed;
+	m_size[particleIndex] = size;
+	m_remainingLifetime[particleIndex] = lifetime;
+	m_fadeRate[particleIndex] = fadeOverLifetime && lifetime > 0.f ? 1.f / lifetime : 0.f;
+	m_opacity[particleIndex] = 1.f;
+	m_color[particleIndex] = color;
+	m_batchIndex[particleIndex] = GetBatchIndex(texture, blendMode);
+}
+
+void ParticleSystem::Update(float deltaSeconds)
+{
+	__m128 const deltaSeconds4 = _mm_set1_ps(deltaSeconds);
+	__m128 const zero4 = _mm_setzero_ps();
+
+	for (int laneStart = 0; laneStart < m_numParticles; laneStart += SIMD_WIDTH)
+	{
+		_mm_storeu_ps(&m_remainingLifetime[laneStart], _mm_sub_ps(_mm_loadu_ps(&m_remainingLifetime[laneStart]), deltaSeconds4));
+
+		__m128 opacity = _mm_sub_ps(_mm_loadu_ps(&m_opacity[laneStart]), _mm_mul_ps(_mm_loadu_ps(&m_fadeRate[laneStart]), deltaSeconds4));
+		_mm_storeu_ps(&m_opacity[laneStart], _mm_max_ps(opacity, zero4));
+
+		_mm_storeu_ps(&m_positionX[laneStart], _mm_add_ps(_mm_loadu_ps(&m_positionX[laneStart]), _mm_mul_ps(_mm_loadu_ps(&m_velocityX[laneStart]), deltaSeconds4)));
+		_mm_storeu_ps(&m_positionY[laneStart], _mm_add_ps(_mm_loadu_ps(&m_positionY[laneStart]), _mm_mul_ps(_mm_loadu_ps(&m_velocityY[laneStart]), deltaSeconds4)));
+		_mm_storeu_ps(&m_positionZ[laneStart], _mm_add_ps(_mm_loadu_ps(&m_positionZ[laneStart]), _mm_mul_ps(_mm_loadu_ps(&m_velocityZ[laneStart]), deltaSeconds4)));
+		_mm_storeu_ps(&m_rotation[laneStart], _mm_add_ps(_mm_loadu_ps(&m_rotation[laneStart]), _mm_mul_ps(_mm_loadu_ps(&m_rotationSpeed[laneStart]), deltaSeconds4)));
+	}
+
+	// Compact in one pass; the particle swapped in from the end has not been checked yet, so check the same index again
+	int particleIndex = 0;
+	while (particleIndex < m_numParticles)
+	{
+		if (m_remainingLifetime[particleIndex] > 0.f)
+		{
+			particleIndex++;
+			continue;
+		}
+
+		m_numParticles--;
+		CopyParticle(m_numParticles, particleIndex);
+	}
+}
+
+void ParticleSystem::BuildBatches(Mat44 const& cameraModelMatrix)
+{
+	for (int batchIndex = 0; batchIndex < (int)m_batches.size(); batchIndex++)
+	{
+		m_batches[batchIndex].m_verts.clear();
+	}
+
+	// Quads are aligned to the camera plane, so the same left and up axes work for every particle before applying its roll
+	Vec3 cameraLeft = cameraModelMatrix.GetJBasis3D();
+	Vec3 cameraUp = cameraModelMatrix.GetKBasis3D();
+
+	for (int particleIndex = 0; particleIndex < m_numParticles; particleIndex++)
+	{
+		float halfSize = m_size[particleIndex] * 0.5f;
+		float cosRotation = CosDegrees(m_rotation[particleIndex]);
+		float sinRotation = SinDegrees(m_rotation[particleIndex]);
+		Vec3 halfRight = (cameraUp * sinRotation - cameraLeft * cosRotation) * halfSize;
+		Vec3 halfUp = (cameraLeft * sinRotation + cameraUp * cosRotation) * halfSize;
+
+		Vec3 center = GetPosition(particleIndex);
+		Rgba8 const& baseColor = m_color[particleIndex];
+		Rgba8 color = Rgba8(baseColor.r, baseColor.g, baseColor.b, DenormalizeByte(m_opacity[particleIndex]));
+		AddVertsForQuad3D(m_batches[m_batchIndex[particleIndex]].m_verts, center - halfRight - halfUp, center + halfRight - halfUp, center + halfRight + halfUp, center - halfRight + halfUp, color);
+	}
+}
+
+void ParticleSystem::AddRenderCommands(RenderCommandList& commandList, Camera const& camera)
+{
+	BuildBatches(camera.GetModelMatrix());
+	m_numDrawCallsLastFrame = 0;
+
+	// Every batch is streamed through the same buffer right before its draw, so it only has to fit the largest batch
+	size_t largestBatchSize = 0;
+	for (int batchIndex = 0; batchIndex < (int)m_batches.size(); batchIndex++)
+	{
+		size_t batchSize = m_batches[batchIndex].m_verts.size() * sizeof(Vertex_PCU);
+		if (batchSize > largestBatchSize)
+		{
+			largestBatchSize = batchSize;
+		}
+	}
+	if (largestBatchSize == 0)
+	{
+		return;
+	}
+	if (!m_vertexBuffer || m_vertexBufferSize < largestBatchSize)
+	{
+		DestroyBuffer(m_vertexBuffer);
+		m_vertexBufferSize = largestBatchSize * 2;
+		m_vertexBuffer = g_renderBackend->CreateVertexBuffer(m_vertexBufferSize);
+	}
+
+	RenderCommand command;
+	command.m_state.m_pass = RenderPass::BLENDED;
+	command.m_vertexBuffer = m_vertexBuffer;
+	command.m_uploadVertexBuffer = m_vertexBuffer;
+
+	for (int batchIndex = 0; batchIndex < (int)m_batches.size(); batchIndex++)
+	{
+		ParticleBatch const& batch = m_batches[batchIndex];
+		if (batch.m_verts.empty())
+		{
+			continue;
+		}
+
+		command.m_state.m_blendMode = batch.m_blendMode;
+		command.m_state.m_texture = batch.m_texture;
+		command.m_count = (int)batch.m_verts.size();
+		command.m_uploadData = batch.m_verts.data();
+		command.m_uploadSize = batch.m_verts.size() * sizeof(Vertex_PCU);
+		commandList.AddCommand(command);
+		m_numDrawCallsLastFrame++;
+	}
+}
+
+void ParticleSystem::Clear()
+{
+	m_numParticles = 0;
+}
+
+int ParticleSystem::GetNumLiveParticles() const
+{
+	return m_numParticles;
+}
+
+int ParticleSystem::GetCapacity() const
+{
+	return (int)m_remainingLifetime.size();
+}
+
+int ParticleSystem::GetBatchIndex(Texture* texture, BlendMode blendMode)
+{
+	for (int batchIndex = 0; batchIndex < (int)m_batches.size(); batchIndex++)
+	{
+		if (m_batches[batchIndex].m_texture == texture && m_batches[batchIndex].m_blendMode == blendMode)
+		{
+			return batchIndex;
+		}
+	}
+
+	ParticleBatch batch;
+	batch.m_texture = texture;
+	batch.m_blendMode = blendMode;
+	m_batches.push_back(batch);
+	return (int)m_batches.size() - 1;
+}
+
+Vec3 ParticleSystem::GetPosition(int particleIndex) const
+{
+	return Vec3(m_positionX[particleIndex], m_positionY[particleIndex], m_positionZ[particleIndex]);
+}
+
+Texture* ParticleSystem::GetParticleTexture(std::string const& textureName)
+{
+	auto particleTexturesIter = s_particleTextures.find(textureName);
+	if (particleTexturesIter != s_particleTextures.end())
+	{
+		return particleTexturesIter->second;
+	}
+
+	return nullptr;
+}
+
+void ParticleSystem::InitializeParticleTextures()
+{
+	Texture* texture = g_renderer->CreateOrGetTextureFromFile("Data/Images/Smoke.png");
+	s_particleTextures["Smoke"] = texture;
+
+	texture = g_renderer->CreateOrGetTextureFromFile("Data/Images/Flame.png");
+	s_particleTextures["Fire"] = texture;
+
+	texture = g_renderer->CreateOrGetTextureFromFile("Data/Images/Leaf1.png");
+	s_particleTextures["Leaf1"] = texture;
+
+	texture = g_renderer->CreateOrGetTextureFromFile("Data/Images/Leaf2.png");
+	s_particleTextures["Leaf2"] = texture;
+
+	texture = g_renderer->CreateOrGetTextureFromFile("Data/Images/Leaf3.png");
+	s_particleTextures["Leaf3"] = texture;
+
+	texture = g_renderer->CreateOrGetTextureFromFile("Data/Images/Leaf4.png");
+	s_particleTextures["Leaf4"] = texture;
+
+	texture = g_renderer->CreateOrGetTextureFromFile("Data/Images/Leaf5.png");
+	s_particleTextures["Leaf5"] = texture;
+
+	texture = g_renderer->CreateOrGetTextureFromFile("Data/Images/Smoke.png");
+	s_particleTextures["ShooterFire"] = texture;
+
+	texture = g_renderer->CreateOrGetTextureFromFile("Data/Images/Burn_Fire.png");
+	s_particleTextures["BurnFire"] = texture;
+
+	texture = g_renderer->CreateOrGetTextureFromFile("Data/Images/Poison_Fire.png");
+	s_particleTextures["PoisonFire"] = texture;
+
+	texture = g_renderer->CreateOrGetTextureFromFile("Data/Images/GenericParticle.png");
+	s_particleTextures["FreezeFire"] = texture;
+
+	texture = g_renderer->CreateOrGetTextureFromFile("Data/Images/GenericParticle.png");
+	s_particleTextures["SniperFire"] = texture;
+
+	texture = g_renderer->CreateOrGetTextureFromFile("Data/Images/GenericParticle.png");
+	s_particleTextures["CrystalParticle"] = texture;
+
+	texture = g_renderer->CreateOrGetTextureFromFile("Data/Images/Skull.png");
+	s_particleTextures["PoisonDebuff"] = texture;
+}
+
+void ParticleSystem::CopyParticle(int fromIndex, int toIndex)
+{
+	m_positionX[toIndex] = m_positionX[fromIndex];
+	m_positionY[toIndex] = m_positionY[fromIndex];
+	m_positionZ[toIndex] = m_positionZ[fromIndex];
+	m_velocityX[toIndex] = m_velocityX[fromIndex];
+	m_velocityY[toIndex] = m_velocityY[fromIndex];
+	m_velocityZ[toIndex] = m_velocityZ[fromIndex];
+	m_rotation[toIndex] = m_rotation[fromIndex];
+	m_rotationSpeed[toIndex] = m_rotationSpeed[fromIndex];
+	m_size[toIndex] = m_size[fromIndex];
+	m_remainingLifetime[toIndex] = m_remainingLifetime[fromIndex];
+	m_fadeRate[toIndex] = m_fadeRate[fromIndex];
+	m_opacity[toIndex] = m_opacity[fromIndex];
+	m_color[toIndex] = m_color[fromIndex];
+	m_batchIndex[toIndex] = m_batchIndex[fromIndex];
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "Engine/Core/Rgba8.hpp"
+#include "Engine/Core/Vertex_PCU.hpp"
+#include "Engine/Math/Mat44.hpp"
+#include "Engine/Math/Vec3.hpp"
+#include "Engine/Renderer/Renderer.hpp"
+
+#include <map>
+#include <string>
+#include <vector>
+
+class Camera;
+class RenderCommandList;
+class Texture;
+class VertexBuffer;
+
+
+// Particles that share a texture and blend mode, drawn together with a single draw call
+struct ParticleBatch
+{
+public:
+	Texture* m_texture = nullptr;
+	BlendMode m_blendMode = BlendMode::ALPHA;
+	std::vector<Vertex_PCU> m_verts;
+};
+
+
+// Owns every particle on a map
+// Particles are stored as parallel arrays in a fixed-capacity pool so integration and fading run 4 particles at a time,
+// and expired particles are compacted by swapping the last live particle into their place
+// Rendering builds camera-facing quads for all particles on the CPU and records one draw per batch, each streamed through one persistent vertex buffer
+class ParticleSystem
+{
+public:
+	static constexpr int SIMD_WIDTH = 4;
+	static constexpr int DEFAULT_CAPACITY = 32768;
+
+public:
+	~ParticleSystem();
+	ParticleSystem() = default;
+	explicit ParticleSystem(int capacity);
+
+	void Spawn(Vec3 const& startPos, Vec3 const& velocity, float rotation, float rotationSpeed, float size, float lifetime, Texture* texture, Rgba8 const& color, BlendMode blendMode = BlendMode::ALPHA, bool fadeOverLifetime = true);
+	void Update(float deltaSeconds);
+	void BuildBatches(Mat44 const& cameraModelMatrix);
+	void AddRenderCommands(RenderCommandList& commandList, Camera const& camera);
+	void Clear();
+
+	int GetNumLiveParticles() const;
+	int GetCapacity() const;
+	int GetBatchIndex(Texture* texture, BlendMode blendMode);
+	Vec3 GetPosition(int particleIndex) const;
+
+	static Texture* GetParticleTexture(std::string const& textureName);
+	static void InitializeParticleTextures();
+
+public:
+	int m_numParticles = 0;
+	std::vector<float> m_positionX;
+	std::vector<float> m_positionY;
+	std::vector<float> m_positionZ;
+	std::vector<float> m_velocityX;
+	std::vector<float> m_velocityY;
+	std::vector<float> m_velocityZ;
+	std::vector<float> m_rotation;
+	std::vector<float> m_rotationSpeed;
+	std::vector<float> m_size;
+	std::vector<float> m_remainingLifetime;
+	std::vector<float> m_fadeRate;
+	std::vector<float> m_opacity;
+	std::vector<Rgba8> m_color;
+	std::vector<int> m_batchIndex;
+
+	std::vector<ParticleBatch> m_batches;
+	VertexBuffer* m_vertexBuffer = nullptr;
+	size_t m_vertexBufferSize = 0;
+	int m_numDrawCallsLastFrame = 0;
+
+	static std::map<std::string, Texture*> s_particleTextures;
+
+private:
+	void CopyParticle(int fromIndex, int toIndex);
+};
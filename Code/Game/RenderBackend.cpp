@@ -0,0 +1,428 @@
+#include "Game/RenderBackend.hpp"
+
+#include "Game/GameCommon.hpp"
+
+#include "Engine/Renderer/ConstantBuffer.hpp"
+#include "Engine/Renderer/IndexBuffer.hpp"
+#include "Engine/Renderer/VertexBuffer.hpp"
+
+
+void RendererBackend::SetBlendMode(BlendMode blendMode)
+{
+	g_renderer->SetBlendMode(blendMode);
+}
+
+void RendererBackend::SetDepthMode(DepthMode depthMode)
+{
+	g_renderer->SetDepthMode(depthMode);
+}
+
+void RendererBackend::SetRasterizerCullMode(RasterizerCullMode cullMode)
+{
+	g_renderer->SetRasterizerCullMode(cullMode);
+}
+
+void RendererBackend::SetRasterizerFillMode(RasterizerFillMode fillMode)
+{
+	g_renderer->SetRasterizerFillMode(fillMode);
+}
+
+void RendererBackend::SetSamplerMode(SamplerMode samplerMode)
+{
+	g_renderer->SetSamplerMode(samplerMode);
+}
+
+void RendererBackend::BindShader(Shader* shader)
+{
+	g_renderer->BindShader(shader);
+}
+
+void RendererBackend::BindTexture(Texture* texture)
+{
+	g_renderer->BindTexture(texture);
+}
+
+void RendererBackend::BindConstantBuffer(int slot, ConstantBuffer* constantBuffer)
+{
+	g_renderer->BindConstantBuffer(slot, constantBuffer);
+}
+
+void RendererBackend::SetModelConstants(Mat44 const& modelMatrix, Rgba8 const& modelColor)
+{
+	g_renderer->SetModelConstants(modelMatrix, modelColor);
+}
+
+void RendererBackend::SetLightConstants(Vec3 const& sunDirection, float sunIntensity, float ambientIntensity)
+{
+	g_renderer->SetLightConstants(sunDirection, sunIntensity, ambientIntensity);
+}
+
+VertexBuffer* RendererBackend::CreateVertexBuffer(size_t size, VertexType vertexType)
+{
+	return g_renderer->CreateVertexBuffer(size, vertexType);
+}
+
+IndexBuffer* RendererBackend::CreateIndexBuffer(size_t size)
+{
+	return g_renderer->CreateIndexBuffer(size);
+}
+
+ConstantBuffer* RendererBackend::CreateConstantBuffer(size_t size)
+{
+	return g_renderer->CreateConstantBuffer(size);
+}
+
+void RendererBackend::DestroyVertexBuffer(VertexBuffer* vbo)
+{
+	delete vbo;
+}
+
+void RendererBackend::DestroyIndexBuffer(IndexBuffer* ibo)
+{
+	delete ibo;
+}
+
+void RendererBackend::DestroyConstantBuffer(ConstantBuffer* cbo)
+{
+	delete cbo;
+}
+
+void RendererBackend::CopyCPUToGPU(void const* data, size_t size, VertexBuffer* vbo)
+{
+	g_renderer->CopyCPUToGPU(data, size, vbo);
+}
+
+void RendererBackend::CopyCPUToGPU(void const* data, size_t size, IndexBuffer* ibo)
+{
+	g_renderer->CopyCPUToGPU(data, size, ibo);
+}
+
+void RendererBackend::CopyCPUToGPU(void const* data, size_t size, ConstantBuffer* cbo)
+{
+	g_renderer->CopyCPUToGPU(data, size, cbo);
+}
+
+void RendererBackend::DrawVertexArray(std::vector<Vertex_PCU> const& verts)
+{
+	g_renderer->DrawVertexArray(verts);
+}
+
+void RendererBackend::DrawVertexArray(std::vector<Vertex_PCUTBN> const& verts)
+{
+	g_renderer->DrawVertexArray(verts);
+}
+
+void RendererBackend::DrawVertexBuffer(VertexBuffer* vbo, int vertexCount)
+{
+	g_renderer->DrawVertexBuffer(vbo, vertexCount);
+}
+
+void RendererBackend::DrawIndexBuffer(VertexBuffer* vbo, IndexBuffer* ibo, int indexCount)
+{
+	g_renderer->DrawIndexBuffer(vbo, ibo, indexCount);
+}
+
+RecordingRenderBackend::~RecordingRenderBackend()
+{
+	for (auto placeholderIter = m_placeholderBuffers.begin(); placeholderIter != m_placeholderBuffers.end(); ++placeholderIter)
+	{
+		delete[] static_cast<uint8_t*>(*placeholderIter);
+	}
+	m_placeholderBuffers.clear();
+}
+
+RecordingRenderBackend::RecordingRenderBackend(RenderBackend* forwardBackend)
+	: m_forwardBackend(forwardBackend)
+{
+}
+
+void RecordingRenderBackend::BeginFrame()
+{
+	m_frameStats = RenderRecordingStats();
+	m_numFrames++;
+}
+
+void RecordingRenderBackend::SetBlendMode(BlendMode blendMode)
+{
+	RecordStateChange();
+	if (m_forwardBackend)
+	{
+		m_forwardBackend->SetBlendMode(blendMode);
+	}
+}
+
+void RecordingRenderBackend::SetDepthMode(DepthMode depthMode)
+{
+	RecordStateChange();
+	if (m_forwardBackend)
+	{
+		m_forwardBackend->SetDepthMode(depthMode);
+	}
+}
+
+void RecordingRenderBackend::SetRasterizerCullMode(RasterizerCullMode cullMode)
+{
+	RecordStateChange();
+	if (m_forwardBackend)
+	{
+		m_forwardBackend->SetRasterizerCullMode(cullMode);
+	}
+}
+
+void RecordingRenderBackend::SetRasterizerFillMode(RasterizerFillMode fillMode)
+{
+	RecordStateChange();
+	if (m_forwardBackend)
+	{
+		m_forwardBackend->SetRasterizerFillMode(fillMode);
+	}
+}
+
+void RecordingRenderBackend::SetSamplerMode(SamplerMode samplerMode)
+{
+	RecordStateChange();
+	if (m_forwardBackend)
+	{
+		m_forwardBackend->SetSamplerMode(samplerMode);
+	}
+}
+
+void RecordingRenderBackend::BindShader(Shader* shader)
+{
+	RecordStateChange();
+	if (m_forwardBackend)
+	{
+		m_forwardBackend->BindShader(shader);
+	}
+}
+
+void RecordingRenderBackend::BindTexture(Texture* texture)
+{
+	RecordStateChange();
+	if (m_forwardBackend)
+	{
+		m_forwardBackend->BindTexture(texture);
+	}
+}
+
+void RecordingRenderBackend::BindConstantBuffer(int slot, ConstantBuffer* constantBuffer)
+{
+	RecordStateChange();
+	if (m_forwardBackend)
+	{
+		m_forwardBackend->BindConstantBuffer(slot, constantBuffer);
+	}
+}
+
+void RecordingRenderBackend::SetModelConstants(Mat44 const& modelMatrix, Rgba8 const& modelColor)
+{
+	RecordStateChange();
+	if (m_forwardBackend)
+	{
+		m_forwardBackend->SetModelConstants(modelMatrix, modelColor);
+	}
+}
+
+void RecordingRenderBackend::SetLightConstants(Vec3 const& sunDirection, float sunIntensity, float ambientIntensity)
+{
+	RecordStateChange();
+	if (m_forwardBackend)
+	{
+		m_forwardBackend->SetLightConstants(sunDirection, sunIntensity, ambientIntensity);
+	}
+}
+
+VertexBuffer* RecordingRenderBackend::CreateVertexBuffer(size_t size, VertexType vertexType)
+{
+	RecordBufferCreation();
+	if (m_forwardBackend)
+	{
+		return m_forwardBackend->CreateVertexBuffer(size, vertexType);
+	}
+
+	return static_cast<VertexBuffer*>(CreatePlaceholderBuffer());
+}
+
+IndexBuffer* RecordingRenderBackend::CreateIndexBuffer(size_t size)
+{
+	RecordBufferCreation();
+	if (m_forwardBackend)
+	{
+		return m_forwardBackend->CreateIndexBuffer(size);
+	}
+
+	return static_cast<IndexBuffer*>(CreatePlaceholderBuffer());
+}
+
+ConstantBuffer* RecordingRenderBackend::CreateConstantBuffer(size_t size)
+{
+	RecordBufferCreation();
+	if (m_forwardBackend)
+	{
+		return m_forwardBackend->CreateConstantBuffer(size);
+	}
+
+	return static_cast<ConstantBuffer*>(CreatePlaceholderBuffer());
+}
+
+// Buffers created before this backend was installed are real ones, so anything that is not a placeholder goes on to be destroyed for real
+void RecordingRenderBackend::DestroyVertexBuffer(VertexBuffer* vbo)
+{
+	if (DestroyPlaceholderBuffer(vbo))
+	{
+		return;
+	}
+
+	if (m_forwardBackend)
+	{
+		m_forwardBackend->DestroyVertexBuffer(vbo);
+		return;
+	}
+
+	delete vbo;
+}
+
+void RecordingRenderBackend::DestroyIndexBuffer(IndexBuffer* ibo)
+{
+	if (DestroyPlaceholderBuffer(ibo))
+	{
+		return;
+	}
+
+	if (m_forwardBackend)
+	{
+		m_forwardBackend->DestroyIndexBuffer(ibo);
+		return;
+	}
+
+	delete ibo;
+}
+
+void RecordingRenderBackend::DestroyConstantBuffer(ConstantBuffer* cbo)
+{
+	if (DestroyPlaceholderBuffer(cbo))
+	{
+		return;
+	}
+
+	if (m_forwardBackend)
+	{
+		m_forwardBackend->DestroyConstantBuffer(cbo);
+		return;
+	}
+
+	delete cbo;
+}
+
+void RecordingRenderBackend::CopyCPUToGPU(void const* data, size_t size, VertexBuffer* vbo)
+{
+	RecordUpload(size);
+	if (m_forwardBackend)
+	{
+		m_forwardBackend->CopyCPUToGPU(data, size, vbo);
+	}
+}
+
+void RecordingRenderBackend::CopyCPUToGPU(void const* data, size_t size, IndexBuffer* ibo)
+{
+	RecordUpload(size);
+	if (m_forwardBackend)
+	{
+		m_forwardBackend->CopyCPUToGPU(data, size, ibo);
+	}
+}
+
+void RecordingRenderBackend::CopyCPUToGPU(void const* data, size_t size, ConstantBuffer* cbo)
+{
+	RecordUpload(size);
+	if (m_forwardBackend)
+	{
+		m_forwardBackend->CopyCPUToGPU(data, size, cbo);
+	}
+}
+
+void RecordingRenderBackend::DrawVertexArray(std::vector<Vertex_PCU> const& verts)
+{
+	// Vertex arrays go through a temporary buffer in the renderer, so they count as an upload as well as a draw
+	RecordUpload(verts.size() * sizeof(Vertex_PCU));
+	RecordDrawCall();
+	if (m_forwardBackend)
+	{
+		m_forwardBackend->DrawVertexArray(verts);
+	}
+}
+
+void RecordingRenderBackend::DrawVertexArray(std::vector<Vertex_PCUTBN> const& verts)
+{
+	RecordUpload(verts.size() * sizeof(Vertex_PCUTBN));
+	RecordDrawCall();
+	if (m_forwardBackend)
+	{
+		m_forwardBackend->DrawVertexArray(verts);
+	}
+}
+
+void RecordingRenderBackend::DrawVertexBuffer(VertexBuffer* vbo, int vertexCount)
+{
+	RecordDrawCall();
+	if (m_forwardBackend)
+	{
+		m_forwardBackend->DrawVertexBuffer(vbo, vertexCount);
+	}
+}
+
+void RecordingRenderBackend::DrawIndexBuffer(VertexBuffer* vbo, IndexBuffer* ibo, int indexCount)
+{
+	RecordDrawCall();
+	if (m_forwardBackend)
+	{
+		m_forwardBackend->DrawIndexBuffer(vbo, ibo, indexCount);
+	}
+}
+
+void RecordingRenderBackend::RecordStateChange()
+{
+	m_frameStats.m_numStateChanges++;
+	m_totalStats.m_numStateChanges++;
+}
+
+void RecordingRenderBackend::RecordUpload(size_t size)
+{
+	m_frameStats.m_numUploads++;
+	m_frameStats.m_numBytesUploaded += size;
+	m_totalStats.m_numUploads++;
+	m_totalStats.m_numBytesUploaded += size;
+}
+
+void RecordingRenderBackend::RecordDrawCall()
+{
+	m_frameStats.m_numDrawCalls++;
+	m_totalStats.m_numDrawCalls++;
+}
+
+void RecordingRenderBackend::RecordBufferCreation()
+{
+	m_frameStats.m_numBuffersCreated++;
+	m_totalStats.m_numBuffersCreated++;
+}
+
+// Placeholders only need a unique address: the game never reads through a buffer pointer, it only hands it back to the backend
+void* RecordingRenderBackend::CreatePlaceholderBuffer()
+{
+	void* placeholder = new uint8_t[1];
+	m_placeholderBuffers.insert(placeholder);
+	return placeholder;
+}
+
+bool RecordingRenderBackend::DestroyPlaceholderBuffer(void* buffer)
+{
+	auto placeholderIter = m_placeholderBuffers.find(buffer);
+	if (placeholderIter == m_placeholderBuffers.end())
+	{
+		return false;
+	}
+
+	delete[] static_cast<uint8_t*>(*placeholderIter);
+	m_placeholderBuffers.erase(placeholderIter);
+	return true;
+}
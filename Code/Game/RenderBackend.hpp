@@ -0,0 +1,152 @@
+#pragma once
+
+#include "Engine/Core/Rgba8.hpp"
+#include "Engine/Math/Mat44.hpp"
+#include "Engine/Math/Vec3.hpp"
+#include "Engine/Renderer/Renderer.hpp"
+
+#include <cstdint>
+#include <set>
+#include <vector>
+
+class ConstantBuffer;
+class IndexBuffer;
+class Shader;
+class Texture;
+class VertexBuffer;
+
+
+// The renderer calls made by the map render path, so a frame can go to the GPU or be recorded without drawing anything
+class RenderBackend
+{
+public:
+	virtual ~RenderBackend() = default;
+
+	virtual void SetBlendMode(BlendMode blendMode) = 0;
+	virtual void SetDepthMode(DepthMode depthMode) = 0;
+	virtual void SetRasterizerCullMode(RasterizerCullMode cullMode) = 0;
+	virtual void SetRasterizerFillMode(RasterizerFillMode fillMode) = 0;
+	virtual void SetSamplerMode(SamplerMode samplerMode) = 0;
+	virtual void BindShader(Shader* shader) = 0;
+	virtual void BindTexture(Texture* texture) = 0;
+	virtual void BindConstantBuffer(int slot, ConstantBuffer* constantBuffer) = 0;
+	virtual void SetModelConstants(Mat44 const& modelMatrix, Rgba8 const& modelColor) = 0;
+	virtual void SetLightConstants(Vec3 const& sunDirection, float sunIntensity, float ambientIntensity) = 0;
+
+	virtual VertexBuffer* CreateVertexBuffer(size_t size, VertexType vertexType = VertexType::VERTEX_PCU) = 0;
+	virtual IndexBuffer* CreateIndexBuffer(size_t size) = 0;
+	virtual ConstantBuffer* CreateConstantBuffer(size_t size) = 0;
+	virtual void DestroyVertexBuffer(VertexBuffer* vbo) = 0;
+	virtual void DestroyIndexBuffer(IndexBuffer* ibo) = 0;
+	virtual void DestroyConstantBuffer(ConstantBuffer* cbo) = 0;
+	virtual void CopyCPUToGPU(void const* data, size_t size, VertexBuffer* vbo) = 0;
+	virtual void CopyCPUToGPU(void const* data, size_t size, IndexBuffer* ibo) = 0;
+	virtual void CopyCPUToGPU(void const* data, size_t size, ConstantBuffer* cbo) = 0;
+
+	virtual void DrawVertexArray(std::vector<Vertex_PCU> const& verts) = 0;
+	virtual void DrawVertexArray(std::vector<Vertex_PCUTBN> const& verts) = 0;
+	virtual void DrawVertexBuffer(VertexBuffer* vbo, int vertexCount) = 0;
+	virtual void DrawIndexBuffer(VertexBuffer* vbo, IndexBuffer* ibo, int indexCount) = 0;
+};
+
+
+// Forwards every call to g_renderer; this is the backend the game normally runs with
+class RendererBackend : public RenderBackend
+{
+public:
+	~RendererBackend() = default;
+	RendererBackend() = default;
+
+	void SetBlendMode(BlendMode blendMode) override;
+	void SetDepthMode(DepthMode depthMode) override;
+	void SetRasterizerCullMode(RasterizerCullMode cullMode) override;
+	void SetRasterizerFillMode(RasterizerFillMode fillMode) override;
+	void SetSamplerMode(SamplerMode samplerMode) override;
+	void BindShader(Shader* shader) override;
+	void BindTexture(Texture* texture) override;
+	void BindConstantBuffer(int slot, ConstantBuffer* constantBuffer) override;
+	void SetModelConstants(Mat44 const& modelMatrix, Rgba8 const& modelColor) override;
+	void SetLightConstants(Vec3 const& sunDirection, float sunIntensity, float ambientIntensity) override;
+
+	VertexBuffer* CreateVertexBuffer(size_t size, VertexType vertexType) override;
+	IndexBuffer* CreateIndexBuffer(size_t size) override;
+	ConstantBuffer* CreateConstantBuffer(size_t size) override;
+	void DestroyVertexBuffer(VertexBuffer* vbo) override;
+	void DestroyIndexBuffer(IndexBuffer* ibo) override;
+	void DestroyConstantBuffer(ConstantBuffer* cbo) override;
+	void CopyCPUToGPU(void const* data, size_t size, VertexBuffer* vbo) override;
+	void CopyCPUToGPU(void const* data, size_t size, IndexBuffer* ibo) override;
+	void CopyCPUToGPU(void const* data, size_t size, ConstantBuffer* cbo) override;
+
+	void DrawVertexArray(std::vector<Vertex_PCU> const& verts) override;
+	void DrawVertexArray(std::vector<Vertex_PCUTBN> const& verts) override;
+	void DrawVertexBuffer(VertexBuffer* vbo, int vertexCount) override;
+	void DrawIndexBuffer(VertexBuffer* vbo, IndexBuffer* ibo, int indexCount) override;
+};
+
+
+struct RenderRecordingStats
+{
+public:
+	int m_numDrawCalls = 0;
+	int m_numStateChanges = 0;
+	int m_numUploads = 0;
+	size_t m_numBytesUploaded = 0;
+	int m_numBuffersCreated = 0;
+};
+
+
+// Counts draws, state changes, uploads and buffer creations so render budgets can be checked
+// Without a forward backend it is a null backend that never touches the GPU: buffers it creates are CPU-side placeholders
+// that the game only passes back to it, and everything else is dropped
+class RecordingRenderBackend : public RenderBackend
+{
+public:
+	~RecordingRenderBackend();
+	explicit RecordingRenderBackend(RenderBackend* forwardBackend);
+
+	void BeginFrame();
+
+	void SetBlendMode(BlendMode blendMode) override;
+	void SetDepthMode(DepthMode depthMode) override;
+	void SetRasterizerCullMode(RasterizerCullMode cullMode) override;
+	void SetRasterizerFillMode(RasterizerFillMode fillMode) override;
+	void SetSamplerMode(SamplerMode samplerMode) override;
+	void BindShader(Shader* shader) override;
+	void BindTexture(Texture* texture) override;
+	void BindConstantBuffer(int slot, ConstantBuffer* constantBuffer) override;
+	void SetModelConstants(Mat44 const& modelMatrix, Rgba8 const& modelColor) override;
+	void SetLightConstants(Vec3 const& sunDirection, float sunIntensity, float ambientIntensity) override;
+
+	VertexBuffer* CreateVertexBuffer(size_t size, VertexType vertexType) override;
+	IndexBuffer* CreateIndexBuffer(size_t size) override;
+	ConstantBuffer* CreateConstantBuffer(size_t size) override;
+	void DestroyVertexBuffer(VertexBuffer* vbo) override;
+	void DestroyIndexBuffer(IndexBuffer* ibo) override;
+	void DestroyConstantBuffer(ConstantBuffer* cbo) override;
+	void CopyCPUToGPU(void const* data, size_t size, VertexBuffer* vbo) override;
+	void CopyCPUToGPU(void const* data, size_t size, IndexBuffer* ibo) override;
+	void CopyCPUToGPU(void const* data, size_t size, ConstantBuffer* cbo) override;
+
+	void DrawVertexArray(std::vector<Vertex_PCU> const& verts) override;
+	void DrawVertexArray(std::vector<Vertex_PCUTBN> const& verts) override;
+	void DrawVertexBuffer(VertexBuffer* vbo, int vertexCount) override;
+	void DrawIndexBuffer(VertexBuffer* vbo, IndexBuffer* ibo, int indexCount) override;
+
+public:
+	RenderBackend* m_forwardBackend = nullptr;
+	RenderRecordingStats m_frameStats;
+	RenderRecordingStats m_totalStats;
+	int m_numFrames = 0;
+
+private:
+	void RecordStateChange();
+	void RecordUpload(size_t size);
+	void RecordDrawCall();
+	void RecordBufferCreation();
+	void* CreatePlaceholderBuffer();
+	bool DestroyPlaceholderBuffer(void* buffer);
+
+private:
+	std::set<void*> m_placeholderBuffers;
+};
@@ -0,0 +1,181 @@
+#include "Game/RenderCommandList.hpp"
+
+#include "Game/GameCommon.hpp"
+#include "Game/RenderBackend.hpp"
+#include "Game/RenderStateCache.hpp"
+
+
+void RenderCommandList::Clear()
+{
+	m_commands.clear();
+	m_sortKeys.clear();
+	m_sortedCommandIndexes.clear();
+}
+
+void RenderCommandList::AddCommand(RenderCommand const& command)
+{
+	if ((int)m_commands.size() >= MAX_COMMANDS)
+	{
+		ERROR_AND_DIE("Too many render commands in one frame");
+	}
+
+	m_sortKeys.push_back(MakeSortKey(command.m_state, (int)m_commands.size()));
+	m_sortedCommandIndexes.push_back((int)m_commands.size());
+	m_commands.push_back(command);
+}
+
+void RenderCommandList::Sort()
+{
+	RadixSort(m_sortKeys, m_sortedCommandIndexes, m_scratchKeys, m_scratchIndexes);
+}
+
+void RenderCommandList::Submit(RenderStateCache& stateCache)
+{
+	// The state cache's count is not cleared here, so the states its Reset forced before this submit are counted too
+	m_numDrawCallsLastFrame = 0;
+
+	for (int sortedIndex = 0; sortedIndex < (int)m_sortedCommandIndexes.size(); sortedIndex++)
+	{
+		RenderCommand const& command = m_commands[m_sortedCommandIndexes[sortedIndex]];
+		RenderState const& state = command.m_state;
+
+		stateCache.BindShader(state.m_shader);
+		stateCache.SetBlendMode(state.m_blendMode);
+		stateCache.BindTexture(state.m_texture);
+		stateCache.SetDepthMode(state.m_depthMode);
+		stateCache.SetRasterizerCullMode(state.m_cullMode);
+		stateCache.SetRasterizerFillMode(state.m_fillMode);
+		stateCache.SetSamplerMode(state.m_samplerMode);
+		stateCache.SetModelConstants(command.m_modelMatrix, command.m_modelColor);
+
+		if (command.m_uploadVertexBuffer)
+		{
+			CopyCPUToGPU(command.m_uploadData, command.m_uploadSize, command.m_uploadVertexBuffer);
+		}
+		if (command.m_uploadConstantBuffer)
+		{
+			CopyCPUToGPU(command.m_uploadData, command.m_uploadSize, command.m_uploadConstantBuffer);
+			stateCache.BindConstantBuffer(command.m_uploadConstantBufferSlot, command.m_uploadConstantBuffer);
+		}
+
+		switch (command.m_type)
+		{
+			case RenderCommandType::DRAW_VERTEX_BUFFER:
+				g_renderBackend->DrawVertexBuffer(command.m_vertexBuffer, command.m_count);
+				break;
+			case RenderCommandType::DRAW_INDEX_BUFFER:
+				g_renderBackend->DrawIndexBuffer(command.m_vertexBuffer, command.m_indexBuffer, command.m_count);
+				break;
+		}
+		m_numDrawCallsLastFrame++;
+	}
+
+	m_numStateChangesLastFrame = stateCache.m_numStateChanges;
+	g_frameRenderStats.m_numDrawCalls += m_numDrawCallsLastFrame;
+	g_frameRenderStats.m_numStateChanges += m_numStateChangesLastFrame;
+}
+
+uint64_t RenderCommandList::MakeSortKey(RenderState const& state, int sequence)
+{
+	uint64_t pass = (uint64_t)state.m_pass & 0xF;
+	uint64_t shaderID = (uint64_t)GetShaderID(state.m_shader) & 0xFF;
+	uint64_t blendMode = (uint64_t)state.m_blendMode & 0xF;
+	uint64_t textureID = (uint64_t)GetTextureID(state.m_texture) & 0xFFFF;
+	uint64_t depthMode = (uint64_t)state.m_depthMode & 0xF;
+	uint64_t stateBits = (shaderID << 24) | (blendMode << 20) | (textureID << 4) | depthMode;
+
+	if (IsPassOrdered(state.m_pass))
+	{
+		return (pass << 60) | ((uint64_t)sequence << 32) | stateBits;
+	}
+
+	return (pass << 60) | (stateBits << 28) | (uint64_t)sequence;
+}
+
+int RenderCommandList::GetShaderID(Shader* shader)
+{
+	for (int shaderID = 0; shaderID < (int)m_shaders.size(); shaderID++)
+	{
+		if (m_shaders[shaderID] == shader)
+		{
+			return shaderID;
+		}
+	}
+
+	if ((int)m_shaders.size() >= MAX_SHADER_IDS)
+	{
+		ERROR_AND_DIE("Too many shaders for render command sort keys");
+	}
+
+	m_shaders.push_back(shader);
+	return (int)m_shaders.size() - 1;
+}
+
+int RenderCommandList::GetTextureID(Texture* texture)
+{
+	for (int textureID = 0; textureID < (int)m_textures.size(); textureID++)
+	{
+		if (m_textures[textureID] == texture)
+		{
+			return textureID;
+		}
+	}
+
+	if ((int)m_textures.size() >= MAX_TEXTURE_IDS)
+	{
+		ERROR_AND_DIE("Too many textures for render command sort keys");
+	}
+
+	m_textures.push_back(texture);
+	return (int)m_textures.size() - 1;
+}
+
+int RenderCommandList::GetNumCommands() const
+{
+	return (int)m_commands.size();
+}
+
+bool RenderCommandList::IsPassOrdered(RenderPass pass)
+{
+	return pass == RenderPass::BACKGROUND || pass == RenderPass::BLENDED;
+}
+
+void RenderCommandList::RadixSort(std::vector<uint64_t>& keys, std::vector<int>& values, std::vector<uint64_t>& scratchKeys, std::vector<int>& scratchValues)
+{
+	int numKeys = (int)keys.size();
+	scratchKeys.resize(numKeys);
+	scratchValues.resize(numKeys);
+
+	// Least significant byte first; every pass is a stable counting sort, and bytes that are the same for every key are skipped
+	for (int shift = 0; shift < 64; shift += 8)
+	{
+		int counts[256] = {};
+		for (int keyIndex = 0; keyIndex < numKeys; keyIndex++)
+		{
+			counts[(keys[keyIndex] >> shift) & 0xFF]++;
+		}
+
+		if (numKeys == 0 || counts[(keys[0] >> shift) & 0xFF] == numKeys)
+		{
+			continue;
+		}
+
+		int offsets[256];
+		int runningOffset = 0;
+		for (int digit = 0; digit < 256; digit++)
+		{
+			offsets[digit] = runningOffset;
+			runningOffset += counts[digit];
+		}
+
+		for (int keyIndex = 0; keyIndex < numKeys; keyIndex++)
+		{
+			int destinationIndex = offsets[(keys[keyIndex] >> shift) & 0xFF]++;
+			scratchKeys[destinationIndex] = keys[keyIndex];
+			scratchValues[destinationIndex] = values[keyIndex];
+		}
+
+		keys.swap(scratchKeys);
+		values.swap(scratchValues);
+	}
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "Engine/Core/Rgba8.hpp"
+#include "Engine/Math/Mat44.hpp"
+#include "Engine/Renderer/Renderer.hpp"
+
+#include <cstdint>
+#include <vector>
+
+class ConstantBuffer;
+class IndexBuffer;
+class RenderStateCache;
+class Shader;
+class Texture;
+class VertexBuffer;
+
+
+// Passes are submitted in this order
+// Solid draws are sorted by state; background and blended draws keep the order they were added in
+enum class RenderPass
+{
+	BACKGROUND,
+	SOLID,
+	BLENDED,
+
+	COUNT
+};
+
+
+enum class RenderCommandType
+{
+	DRAW_VERTEX_BUFFER,
+	DRAW_INDEX_BUFFER,
+};
+
+
+struct RenderState
+{
+public:
+	RenderPass m_pass = RenderPass::SOLID;
+	Shader* m_shader = nullptr;
+	BlendMode m_blendMode = BlendMode::OPAQUE;
+	Texture* m_texture = nullptr;
+	DepthMode m_depthMode = DepthMode::ENABLED;
+	RasterizerCullMode m_cullMode = RasterizerCullMode::CULL_NONE;
+	RasterizerFillMode m_fillMode = RasterizerFillMode::SOLID;
+	SamplerMode m_samplerMode = SamplerMode::POINT_CLAMP;
+};
+
+
+struct RenderCommand
+{
+public:
+	RenderState m_state;
+	Mat44 m_modelMatrix;
+	Rgba8 m_modelColor = Rgba8::WHITE;
+
+	RenderCommandType m_type = RenderCommandType::DRAW_VERTEX_BUFFER;
+	VertexBuffer* m_vertexBuffer = nullptr;
+	IndexBuffer* m_indexBuffer = nullptr;
+	int m_count = 0;
+
+	// Systems that stream several draws through one buffer hand over the data instead of copying it themselves,
+	// so it is uploaded right before its own draw no matter where sorting puts that draw
+	// The data has to stay alive until the list is submitted
+	void const* m_uploadData = nullptr;
+	size_t m_uploadSize = 0;
+	VertexBuffer* m_uploadVertexBuffer = nullptr;
+	ConstantBuffer* m_uploadConstantBuffer = nullptr;
+	int m_uploadConstantBufferSlot = -1;
+};
+
+
+// Draws recorded over a frame, sorted on a 64-bit key and submitted through a RenderStateCache so only state changes reach the renderer
+// Key layout from the most significant bit: pass (4), shader (8), blend mode (4), texture (16), depth mode (4), sequence (28)
+// In ordered passes the sequence moves right below the pass so draws stay in the order they were added
+class RenderCommandList
+{
+public:
+	static constexpr int MAX_SHADER_IDS = 1 << 8;
+	static constexpr int MAX_TEXTURE_IDS = 1 << 16;
+	static constexpr int MAX_COMMANDS = 1 << 28;
+
+public:
+	~RenderCommandList() = default;
+	RenderCommandList() = default;
+
+	void Clear();
+	void AddCommand(RenderCommand const& command);
+	void Sort();
+	void Submit(RenderStateCache& stateCache);
+
+	uint64_t MakeSortKey(RenderState const& state, int sequence);
+	int GetShaderID(Shader* shader);
+	int GetTextureID(Texture* texture);
+	int GetNumCommands() const;
+
+	static bool IsPassOrdered(RenderPass pass);
+	static void RadixSort(std::vector<uint64_t>& keys, std::vector<int>& values, std::vector<uint64_t>& scratchKeys, std::vector<int>& scratchValues);
+
+public:
+	std::vector<RenderCommand> m_commands;
+	std::vector<uint64_t> m_sortKeys;
+	std::vector<int> m_sortedCommandIndexes;
+	std::vector<uint64_t> m_scratchKeys;
+	std::vector<int> m_scratchIndexes;
+
+	// IDs only exist to make the sort keys small, so they are handed out in order of first use and kept across frames
+	std::vector<Shader*> m_shaders;
+	std::vector<Texture*> m_textures;
+
+	int m_numDrawCallsLastFrame = 0;
+	int m_numStateChangesLastFrame = 0;
+};
@@ -0,0 +1,146 @@
+#include "Game/RenderStateCache.hpp"
+
+#include "Game/GameCommon.hpp"
+#include "Game/RenderBackend.hpp"
+
+#include <cstring>
+
+
+void RenderStateCache::Reset()
+{
+	m_blendMode = BlendMode::OPAQUE;
+	m_depthMode = DepthMode::ENABLED;
+	m_cullMode = RasterizerCullMode::CULL_NONE;
+	m_fillMode = RasterizerFillMode::SOLID;
+	m_samplerMode = SamplerMode::POINT_CLAMP;
+	m_shader = nullptr;
+	m_texture = nullptr;
+	m_modelMatrix = Mat44();
+	m_modelColor = Rgba8::WHITE;
+
+	g_renderBackend->SetBlendMode(m_blendMode);
+	g_renderBackend->SetDepthMode(m_depthMode);
+	g_renderBackend->SetRasterizerCullMode(m_cullMode);
+	g_renderBackend->SetRasterizerFillMode(m_fillMode);
+	g_renderBackend->SetSamplerMode(m_samplerMode);
+	g_renderBackend->BindShader(m_shader);
+	g_renderBackend->BindTexture(m_texture);
+	g_renderBackend->SetModelConstants(m_modelMatrix, m_modelColor);
+	m_numStateChanges = NUM_RESET_STATE_CHANGES;
+
+	// Constant buffers are left bound; forgetting them only means the next bind to each slot always goes through
+	for (int slot = 0; slot < MAX_CONSTANT_BUFFER_SLOTS; slot++)
+	{
+		m_constantBuffers[slot] = nullptr;
+	}
+}
+
+void RenderStateCache::SetBlendMode(BlendMode blendMode)
+{
+	if (m_blendMode == blendMode)
+	{
+		return;
+	}
+
+	m_blendMode = blendMode;
+	g_renderBackend->SetBlendMode(blendMode);
+	m_numStateChanges++;
+}
+
+void RenderStateCache::SetDepthMode(DepthMode depthMode)
+{
+	if (m_depthMode == depthMode)
+	{
+		return;
+	}
+
+	m_depthMode = depthMode;
+	g_renderBackend->SetDepthMode(depthMode);
+	m_numStateChanges++;
+}
+
+void RenderStateCache::SetRasterizerCullMode(RasterizerCullMode cullMode)
+{
+	if (m_cullMode == cullMode)
+	{
+		return;
+	}
+
+	m_cullMode = cullMode;
+	g_renderBackend->SetRasterizerCullMode(cullMode);
+	m_numStateChanges++;
+}
+
+void RenderStateCache::SetRasterizerFillMode(RasterizerFillMode fillMode)
+{
+	if (m_fillMode == fillMode)
+	{
+		return;
+	}
+
+	m_fillMode = fillMode;
+	g_renderBackend->SetRasterizerFillMode(fillMode);
+	m_numStateChanges++;
+}
+
+void RenderStateCache::SetSamplerMode(SamplerMode samplerMode)
+{
+	if (m_samplerMode == samplerMode)
+	{
+		return;
+	}
+
+	m_samplerMode = samplerMode;
+	g_renderBackend->SetSamplerMode(samplerMode);
+	m_numStateChanges++;
+}
+
+void RenderStateCache::BindShader(Shader* shader)
+{
+	if (m_shader == shader)
+	{
+		return;
+	}
+
+	m_shader = shader;
+	g_renderBackend->BindShader(shader);
+	m_numStateChanges++;
+}
+
+void RenderStateCache::BindTexture(Texture* texture)
+{
+	if (m_texture == texture)
+	{
+		return;
+	}
+
+	m_texture = texture;
+	g_renderBackend->BindTexture(texture);
+	m_numStateChanges++;
+}
+
+void RenderStateCache::BindConstantBuffer(int slot, ConstantBuffer* constantBuffer)
+{
+	if (m_constantBuffers[slot] == constantBuffer)
+	{
+		return;
+	}
+
+	m_constantBuffers[slot] = constantBuffer;
+	g_renderBackend->BindConstantBuffer(slot, constantBuffer);
+	m_numStateChanges++;
+}
+
+void RenderStateCache::SetModelConstants(Mat44 const& modelMatrix, Rgba8 const& modelColor)
+{
+	bool isSameColor = m_modelColor.r == modelColor.r && m_modelColor.g == modelColor.g && m_modelColor.b == modelColor.b && m_modelColor.a == modelColor.a;
+	if (isSameColor && memcmp(&m_modelMatrix, &modelMatrix, sizeof(Mat44)) == 0)
+	{
+		return;
+	}
+
+	m_modelMatrix = modelMatrix;
+	m_modelColor = modelColor;
+	g_renderBackend->SetModelConstants(modelMatrix, modelColor);
+	m_numStateChanges++;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Engine/Core/Rgba8.hpp"
+#include "Engine/Math/Mat44.hpp"
+#include "Engine/Renderer/Renderer.hpp"
+
+class ConstantBuffer;
+class Shader;
+class Texture;
+
+
+// Sits in front of the render backend's state setters and forwards a state only when it differs from the one last set through the cache
+// Anything else may touch the renderer between frames, so Reset puts the backend back into the cache's known state before use
+// Reset also starts the frame's count of state changes, which includes the states it forces
+class RenderStateCache
+{
+public:
+	static constexpr int MAX_CONSTANT_BUFFER_SLOTS = 16;
+	static constexpr int NUM_RESET_STATE_CHANGES = 8;
+
+public:
+	~RenderStateCache() = default;
+	RenderStateCache() = default;
+
+	void Reset();
+
+	void SetBlendMode(BlendMode blendMode);
+	void SetDepthMode(DepthMode depthMode);
+	void SetRasterizerCullMode(RasterizerCullMode cullMode);
+	void SetRasterizerFillMode(RasterizerFillMode fillMode);
+	void SetSamplerMode(SamplerMode samplerMode);
+	void BindShader(Shader* shader);
+	void BindTexture(Texture* texture);
+	void BindConstantBuffer(int slot, ConstantBuffer* constantBuffer);
+	void SetModelConstants(Mat44 const& modelMatrix, Rgba8 const& modelColor);
+
+public:
+	BlendMode m_blendMode = BlendMode::OPAQUE;
+	DepthMode m_depthMode = DepthMode::ENABLED;
+	RasterizerCullMode m_cullMode = RasterizerCullMode::CULL_NONE;
+	RasterizerFillMode m_fillMode = RasterizerFillMode::SOLID;
+	SamplerMode m_samplerMode = SamplerMode::POINT_CLAMP;
+	Shader* m_shader = nullptr;
+	Texture* m_texture = nullptr;
+	ConstantBuffer* m_constantBuffers[MAX_CONSTANT_BUFFER_SLOTS] = {};
+	Mat44 m_modelMatrix;
+	Rgba8 m_modelColor = Rgba8::WHITE;
+	int m_numStateChanges = 0;
+};
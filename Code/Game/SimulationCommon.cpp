@@ -0,0 +1,12 @@
+#include "Game/SimulationCommon.hpp"
+
+
+unsigned int HashBytes(unsigned int hash, void const* data, size_t numBytes)
+{
+	unsigned char const* bytes = reinterpret_cast<unsigned char const*>(data);
+	for (size_t byteIndex = 0; byteIndex < numBytes; byteIndex++)
+	{
+		hash = (hash ^ bytes[byteIndex]) * 16777619u;
+	}
+	return hash;
+}
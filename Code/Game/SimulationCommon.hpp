@@ -0,0 +1,10 @@
+#pragma once
+
+#include <cstddef>
+
+
+// Shared by the simulation library and the game, so it only pulls in the standard library
+
+// 32-bit FNV-1a, chained by passing the previous result back in; start a new hash from FNV_OFFSET_BASIS
+constexpr unsigned int FNV_OFFSET_BASIS = 2166136261u;
+unsigned int HashBytes(unsigned int hash, void const* data, size_t numBytes);
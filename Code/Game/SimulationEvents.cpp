@@ -0,0 +1,50 @@
+#include "Game/SimulationEvents.hpp"
+
+#include "Engine/Core/EngineCommon.hpp"
+
+
+void NullSimulationEvents::OnTowerPlaced(Tower const& tower)
+{
+	UNUSED(tower);
+}
+
+void NullSimulationEvents::OnTowerUnaffordable()
+{
+}
+
+void NullSimulationEvents::OnTowerFired(Tower const& tower)
+{
+	UNUSED(tower);
+}
+
+void NullSimulationEvents::OnEnemyDied(Enemy const& enemy)
+{
+	UNUSED(enemy);
+}
+
+void NullSimulationEvents::OnEnemyDeathAnimationFinished(Enemy const& enemy)
+{
+	UNUSED(enemy);
+}
+
+void NullSimulationEvents::OnEnemyStatusEffectPulse(Enemy const& enemy)
+{
+	UNUSED(enemy);
+}
+
+void NullSimulationEvents::OnEnemyReachedGoal(Enemy const& enemy)
+{
+	UNUSED(enemy);
+}
+
+void NullSimulationEvents::OnLifeLost()
+{
+}
+
+void NullSimulationEvents::OnLevelFailed()
+{
+}
+
+void NullSimulationEvents::OnLevelComplete()
+{
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+
+class Enemy;
+class Tower;
+
+
+// What the fixed-step simulation tells its presentation about: sounds, particles, popups and camera shake all hang off these
+// Nothing here may feed back into the simulation, so a run with NullSimulationEvents plays out exactly like a rendered one
+class SimulationEvents
+{
+public:
+	virtual ~SimulationEvents() = default;
+
+	virtual void OnTowerPlaced(Tower const& tower) = 0;
+	virtual void OnTowerUnaffordable() = 0;
+	virtual void OnTowerFired(Tower const& tower) = 0;
+	virtual void OnEnemyDied(Enemy const& enemy) = 0;
+	virtual void OnEnemyDeathAnimationFinished(Enemy const& enemy) = 0;
+	virtual void OnEnemyStatusEffectPulse(Enemy const& enemy) = 0;
+	virtual void OnEnemyReachedGoal(Enemy const& enemy) = 0;
+	virtual void OnLifeLost() = 0;
+	virtual void OnLevelFailed() = 0;
+	virtual void OnLevelComplete() = 0;
+};
+
+
+// Ignores everything, for headless maps and the reytd-sim command line runner
+class NullSimulationEvents : public SimulationEvents
+{
+public:
+	~NullSimulationEvents() = default;
+	NullSimulationEvents() = default;
+
+	void OnTowerPlaced(Tower const& tower) override;
+	void OnTowerUnaffordable() override;
+	void OnTowerFired(Tower const& tower) override;
+	void OnEnemyDied(Enemy const& enemy) override;
+	void OnEnemyDeathAnimationFinished(Enemy const& enemy) override;
+	void OnEnemyStatusEffectPulse(Enemy const& enemy) override;
+	void OnEnemyReachedGoal(Enemy const& enemy) override;
+	void OnLifeLost() override;
+	void OnLevelFailed() override;
+	void OnLevelComplete() override;
+};
@@ -0,0 +1,24 @@
+#include "Game/SimulationRNG.hpp"
+
+#include "ThirdParty/Squirrel/RawNoise.hpp"
+
+
+SimulationRNG::SimulationRNG(unsigned int seed)
+	: m_seed(seed)
+{
+}
+
+float SimulationRNG::RollRandomFloatZeroToOne()
+{
+	return Get1dNoiseZeroToOne(m_position++, m_seed);
+}
+
+float SimulationRNG::RollRandomFloatInRange(float minInclusive, float maxInclusive)
+{
+	return minInclusive + (maxInclusive - minInclusive) * RollRandomFloatZeroToOne();
+}
+
+float SimulationRNG::RollRandomFloatInRange(FloatRange const& range)
+{
+	return RollRandomFloatInRange(range.m_min, range.m_max);
+}
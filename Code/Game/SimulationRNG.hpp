@@ -0,0 +1,23 @@
+#pragma once
+
+#include "Engine/Math/FloatRange.hpp"
+
+
+// Seeded random stream for rolls that change the outcome of a level, such as damage and damage over time
+// It keeps its own position in Squirrel noise rather than sharing g_RNG with particles, clouds and camera shake,
+// so a headless run that skips every cosmetic roll still draws the same gameplay rolls as a rendered run
+class SimulationRNG
+{
+public:
+	~SimulationRNG() = default;
+	SimulationRNG() = default;
+	explicit SimulationRNG(unsigned int seed);
+
+	float RollRandomFloatZeroToOne();
+	float RollRandomFloatInRange(float minInclusive, float maxInclusive);
+	float RollRandomFloatInRange(FloatRange const& range);
+
+public:
+	unsigned int m_seed = 0;
+	int m_position = 0;
+};
@@ -0,0 +1,118 @@
+#include "Game/SimulationScript.hpp"
+
+#include "Game/MapDefinition.hpp"
+#include "Game/MapSimulation.hpp"
+#include "Game/TowerDefinition.hpp"
+
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Core/StringUtils.hpp"
+#include "Engine/Math/MathUtils.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+
+SimulationScript::SimulationScript(XmlElement const* element)
+{
+	m_mapName = ParseXmlAttribute(*element, "map", m_mapName);
+	m_maxSimulatedSeconds = ParseXmlAttribute(*element, "maxSeconds", m_maxSimulatedSeconds);
+
+	XmlElement const* towerXmlElement = element->FirstChildElement("Tower");
+	while (towerXmlElement)
+	{
+		SimulationTowerPlacement placement;
+		placement.m_towerName = ParseXmlAttribute(*towerXmlElement, "name", placement.m_towerName);
+		placement.m_blockCoords = ParseXmlAttribute(*towerXmlElement, "coords", placement.m_blockCoords);
+		placement.m_placeTime = ParseXmlAttribute(*towerXmlElement, "time", placement.m_placeTime);
+
+		if (TowerDefinition::s_towerDefs.find(placement.m_towerName) == TowerDefinition::s_towerDefs.end())
+		{
+			ERROR_AND_DIE(Stringf("Simulation script references unknown tower \"%s\"", placement.m_towerName.c_str()));
+		}
+
+		m_towerPlacements.push_back(placement);
+		towerXmlElement = towerXmlElement->NextSiblingElement("Tower");
+	}
+
+	std::stable_sort(m_towerPlacements.begin(), m_towerPlacements.end(), [](SimulationTowerPlacement const& a, SimulationTowerPlacement const& b)
+		{
+			return a.m_placeTime < b.m_placeTime;
+		});
+}
+
+SimulationResult SimulationScript::Run(JobSystem* jobSystem) const
+{
+	SimulationResult result;
+
+	auto mapDefIter = MapDefinition::s_mapDefs.find(m_mapName);
+	if (mapDefIter == MapDefinition::s_mapDefs.end())
+	{
+		return result;
+	}
+
+	// Timed with the standard clock rather than the engine's, which the simulation library does not link
+	std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+	MapSimulation* map = new MapSimulation(mapDefIter->second, jobSystem);
+	map->Initialize();
+	int maxTicks = RoundDownToInt(m_maxSimulatedSeconds / MapSimulation::FIXED_PHYSICS_TIMESTEP);
+	int nextPlacementIndex = 0;
+	result.m_outcome = SimulationOutcome::TIMED_OUT;
+
+	for (int tickIndex = 0; tickIndex < maxTicks; tickIndex++)
+	{
+		float simulatedSeconds = (float)tickIndex * MapSimulation::FIXED_PHYSICS_TIMESTEP;
+
+		// Placements are applied in order; a placement that is not yet affordable holds back the ones after it
+		while (nextPlacementIndex < (int)m_towerPlacements.size() && m_towerPlacements[nextPlacementIndex].m_placeTime <= simulatedSeconds)
+		{
+			SimulationTowerPlacement const& placement = m_towerPlacements[nextPlacementIndex];
+			if (TowerDefinition::s_towerDefs[placement.m_towerName].m_cost > map->m_money)
+			{
+				break;
+			}
+
+			if (map->PlaceTowerAtBlock(placement.m_towerName, placement.m_blockCoords))
+			{
+				result.m_numTowersPlaced++;
+			}
+			nextPlacementIndex++;
+		}
+
+		map->FixedUpdate(MapSimulation::FIXED_PHYSICS_TIMESTEP);
+		map->DeleteDestroyedEnemies();
+		result.m_numTicks++;
+
+		if (map->IsLevelFailed())
+		{
+			result.m_outcome = SimulationOutcome::LOST;
+			break;
+		}
+		if (map->IsLevelComplete())
+		{
+			result.m_outcome = SimulationOutcome::WON;
+			break;
+		}
+	}
+
+	result.m_wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+	result.m_simulatedSeconds = (float)result.m_numTicks * MapSimulation::FIXED_PHYSICS_TIMESTEP;
+	result.m_remainingLives = map->m_remainingLives;
+	result.m_money = map->m_money;
+	result.m_score = map->m_score;
+	result.m_stars = map->m_stars;
+
+	delete map;
+	return result;
+}
+
+char const* SimulationScript::GetOutcomeName(SimulationOutcome outcome)
+{
+	switch (outcome)
+	{
+		case SimulationOutcome::WON:		return "Won";
+		case SimulationOutcome::LOST:		return "Lost";
+		case SimulationOutcome::TIMED_OUT:	return "Timed out";
+		default:							return "Invalid";
+	}
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "Engine/Core/XMLUtils.hpp"
+#include "Engine/Math/IntVec2.hpp"
+
+#include <string>
+#include <vector>
+
+
+class JobSystem;
+
+
+struct SimulationTowerPlacement
+{
+public:
+	std::string m_towerName = "";
+	IntVec2 m_blockCoords = IntVec2::ZERO;
+	float m_placeTime = 0.f;
+};
+
+
+enum class SimulationOutcome
+{
+	INVALID = -1,
+	WON,
+	LOST,
+	TIMED_OUT,
+	COUNT
+};
+
+
+struct SimulationResult
+{
+public:
+	SimulationOutcome m_outcome = SimulationOutcome::INVALID;
+	int m_numTicks = 0;
+	float m_simulatedSeconds = 0.f;
+	double m_wallSeconds = 0.0;
+	int m_remainingLives = 0;
+	int m_money = 0;
+	int m_score = 0;
+	int m_stars = 0;
+	int m_numTowersPlaced = 0;
+};
+
+
+// Scripted, input-free playthrough of a level used to exercise the simulation without rendering or audio
+// Part of the simulation library; the game runs it from the SimulateLevel console command and reytd-sim from the command line
+class SimulationScript
+{
+public:
+	~SimulationScript() = default;
+	SimulationScript() = default;
+	explicit SimulationScript(XmlElement const* element);
+
+	SimulationResult Run(JobSystem* jobSystem) const;
+
+	static char const* GetOutcomeName(SimulationOutcome outcome);
+
+public:
+	std::string m_mapName = "";
+	float m_maxSimulatedSeconds = 600.f;
+	std::vector<SimulationTowerPlacement> m_towerPlacements;
+};
@@ -1,73 +1,111 @@
 #include "Game/StatusEffects.hpp"
 
 #include "Game/Enemy.hpp"
-#include "Game/Game.hpp"
-#include "Game/Map.hpp"
-#include "Game/Tower.hpp"
+#include "Game/MapSimulation.hpp"
 
-StatusEffect::StatusEffect(Enemy* enemy, float duration, StatusEffectType type)
-	: m_enemy(enemy)
-	, m_type(type)
+#include "Engine/Math/MathUtils.hpp"
+
+
+unsigned int GetStatusEffectFlag(StatusEffectType type)
 {
-	m_durationTimer = new Stopwatch(&m_enemy->m_map->m_mapClock, duration);
-	m_durationTimer->Start();
+	return 1u << (unsigned int)type;
 }
 
-// Enemy Freeze
-EnemyFreezeDebuff::EnemyFreezeDebuff(Enemy* enemy, float duration, float speedMultiplier)
-	: StatusEffect(enemy, duration, StatusEffectType::FREEZE)
-	, m_speedMultiplier(speedMultiplier)
+bool EnemyStatusEffects::Apply(StatusEffectType type, float magnitude, float durationSeconds)
 {
+	if (IsImmuneTo(type))
+	{
+		return false;
+	}
+
+	StatusEffectSlot& slot = m_slots[(int)type];
+	if (slot.m_remainingTicks > 0 && !DoesMagnitudeAExceedB(type, magnitude, slot.m_magnitude))
+	{
+		return false;
+	}
+
+	// The effect is applied on every tick of its duration and expires on the tick after
+	slot.m_magnitude = magnitude;
+	slot.m_remainingTicks = RoundDownToInt(durationSeconds / MapSimulation::FIXED_PHYSICS_TIMESTEP) + 1;
+	return true;
 }
 
-void EnemyFreezeDebuff::Update(float deltaSeconds)
+void EnemyStatusEffects::Update(Enemy* enemy, float deltaSeconds)
 {
-	UNUSED(deltaSeconds);
+	StatusEffectSlot& freezeSlot = m_slots[(int)StatusEffectType::FREEZE];
+	if (freezeSlot.m_remainingTicks > 0)
+	{
+		freezeSlot.m_remainingTicks--;
+		if (freezeSlot.m_remainingTicks == 0)
+		{
+			enemy->SetSpeed(enemy->m_definition->m_speed);
+		}
+		else
+		{
+			enemy->SetSpeed(enemy->m_definition->m_speed * freezeSlot.m_magnitude * enemy->m_definition->m_slowMultiplier);
+		}
+	}
 
-	if (m_durationTimer->HasDurationElapsed())
+	StatusEffectType const damageOverTimeTypes[] = { StatusEffectType::BURN, StatusEffectType::POISON };
+	for (int typeIndex = 0; typeIndex < 2; typeIndex++)
 	{
-		m_enemy->m_speed = m_enemy->m_definition.m_speed;
-		m_isActive = false;
-		return;
+		StatusEffectSlot& slot = m_slots[(int)damageOverTimeTypes[typeIndex]];
+		if (slot.m_remainingTicks <= 0)
+		{
+			continue;
+		}
+
+		slot.m_remainingTicks--;
+		if (slot.m_remainingTicks > 0 && !enemy->m_isDead)
+		{
+			enemy->TakeStatusEffectDamage(slot.m_magnitude * deltaSeconds);
+		}
 	}
+}
 
-	m_enemy->m_speed = m_enemy->m_definition.m_speed * m_speedMultiplier * m_enemy->m_definition.m_slowMultiplier;
+void EnemyStatusEffects::Clear()
+{
+	for (int typeIndex = 0; typeIndex < (int)StatusEffectType::COUNT; typeIndex++)
+	{
+		m_slots[typeIndex] = StatusEffectSlot();
+	}
 }
 
+bool EnemyStatusEffects::IsImmuneTo(StatusEffectType type) const
+{
+	return (m_immunityFlags & GetStatusEffectFlag(type)) != 0;
+}
 
-// Enemy Burn
-EnemyBurnDebuff::EnemyBurnDebuff(Enemy* enemy, float duration, float damagePerSecond)
-	: StatusEffect(enemy, duration, StatusEffectType::BURN)
-	, m_damagePerSecond(damagePerSecond)
+bool EnemyStatusEffects::IsActive(StatusEffectType type) const
 {
+	return m_slots[(int)type].m_remainingTicks > 0;
 }
 
-void EnemyBurnDebuff::Update(float deltaSeconds)
+bool EnemyStatusEffects::IsAnyActive() const
 {
-	if (m_durationTimer->HasDurationElapsed())
+	for (int typeIndex = 0; typeIndex < (int)StatusEffectType::COUNT; typeIndex++)
 	{
-		m_isActive = false;
-		return;
+		if (m_slots[typeIndex].m_remainingTicks > 0)
+		{
+			return true;
+		}
 	}
 
-	m_enemy->TakeStatusEffectDamage(m_damagePerSecond * deltaSeconds);
+	return false;
 }
 
-
-// Enemy Poison
-EnemyPoisonDebuff::EnemyPoisonDebuff(Enemy* enemy, float duration, float damagePerSecond)
-	: StatusEffect(enemy, duration, StatusEffectType::POISON)
-	, m_damagePerSecond(damagePerSecond)
+float EnemyStatusEffects::GetMagnitude(StatusEffectType type) const
 {
+	return m_slots[(int)type].m_magnitude;
 }
 
-void EnemyPoisonDebuff::Update(float deltaSeconds)
+bool EnemyStatusEffects::DoesMagnitudeAExceedB(StatusEffectType type, float magnitudeA, float magnitudeB)
 {
-	if (m_durationTimer->HasDurationElapsed())
+	switch (type)
 	{
-		m_isActive = false;
-		return;
+		case StatusEffectType::FREEZE:		return magnitudeA < magnitudeB;
+		case StatusEffectType::BURN:		return magnitudeA > magnitudeB;
+		case StatusEffectType::POISON:		return magnitudeA < magnitudeB;
+		default:							return magnitudeA > magnitudeB;
 	}
-
-	m_enemy->TakeStatusEffectDamage(m_damagePerSecond * deltaSeconds);
 }
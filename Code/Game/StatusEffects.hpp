@@ -1,10 +1,7 @@
 #pragma once
 
-#include "Engine/Core/Stopwatch.hpp"
-
 
 class Enemy;
-class Tower;
 
 
 enum class StatusEffectType
@@ -20,46 +17,34 @@ enum class StatusEffectType
 	COUNT
 };
 
-struct StatusEffect
-{
-public:
-	StatusEffectType m_type = StatusEffectType::INVALID;
-	Enemy* m_enemy = nullptr;
-	Stopwatch* m_durationTimer;
-	bool m_isActive = true;
+unsigned int GetStatusEffectFlag(StatusEffectType type);
 
-public:
-	virtual ~StatusEffect() = default;
-	StatusEffect(Enemy* enemy, float duration, StatusEffectType type = StatusEffectType::INVALID);
-	virtual void Update(float deltaSeconds) = 0;
-};
 
-struct EnemyFreezeDebuff : public StatusEffect
+struct StatusEffectSlot
 {
 public:
-	float m_speedMultiplier = 1.f;
-
-public:
-	EnemyFreezeDebuff(Enemy* enemy, float duration, float speedMultiplier);
-	virtual void Update(float deltaSeconds) override;
+	float m_magnitude = 0.f; // Speed multiplier for FREEZE, damage per second for BURN and POISON
+	int m_remainingTicks = 0;
 };
 
-struct EnemyBurnDebuff : public StatusEffect
+
+// Status effects on a single enemy, stored inline with one slot per type so applying and expiring effects never allocates
+// A new effect only replaces the active one of the same type if it is stronger
+struct EnemyStatusEffects
 {
 public:
-	float m_damagePerSecond = 0.f;
+	StatusEffectSlot m_slots[(int)StatusEffectType::COUNT];
+	unsigned int m_immunityFlags = 0;
 
 public:
-	EnemyBurnDebuff(Enemy* enemy, float duration, float damagePerSecond);
-	virtual void Update(float deltaSeconds) override;
-};
+	bool Apply(StatusEffectType type, float magnitude, float durationSeconds);
+	void Update(Enemy* enemy, float deltaSeconds);
+	void Clear();
 
-struct EnemyPoisonDebuff : public StatusEffect
-{
-public:
-	float m_damagePerSecond = 0.f;
+	bool IsImmuneTo(StatusEffectType type) const;
+	bool IsActive(StatusEffectType type) const;
+	bool IsAnyActive() const;
+	float GetMagnitude(StatusEffectType type) const;
 
-public:
-	EnemyPoisonDebuff(Enemy* enemy, float duration, float damagePerSecond);
-	virtual void Update(float deltaSeconds) override;
+	static bool DoesMagnitudeAExceedB(StatusEffectType type, float magnitudeA, float magnitudeB);
 };
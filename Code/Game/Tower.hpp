@@ -1,34 +1,34 @@
 #pragma once
 
+#include "Game/EnemySlotMap.hpp"
+#include "Game/FixedStepTimer.hpp"
 #include "Game/TowerDefinition.hpp"
 
-#include "Engine/Core/Stopwatch.hpp"
 #include "Engine/Math/EulerAngles.hpp"
 #include "Engine/Math/Vec3.hpp"
 
-class Map;
 class Enemy;
+class MapSimulation;
 
 class Tower
 {
 public:
 	~Tower() = default;
 	Tower() = default;
-	Tower(Map* map, TowerDefinition towerDef, Vec3 const& position);
+	Tower(MapSimulation* map, TowerDefinition towerDef, Vec3 const& position);
 
 	void Update();
-	void FixedUpdate(float deltaSeconds);
-	void Render() const;
-	void RenderOverlay() const;
+	Enemy* GatherTarget() const;
+	void FixedUpdate(float deltaSeconds, Enemy* target);
 
-	void Fire();
+	void Fire(Enemy* target);
 
 public:
-	Map* m_map = nullptr;
+	MapSimulation* m_map = nullptr;
 	TowerDefinition m_definition;
 	float m_turretZOrientation = 0.f;
 	Vec3 m_position;
-	Enemy* m_target = nullptr;
+	EnemyHandle m_target;
 	float m_damageMultiplier = 1.f;
 	bool m_isSelected = false;
 	bool m_canFire = true;
@@ -36,6 +36,6 @@ public:
 
 	float m_turretScaleXY = 1.f;
 	float m_turretScaleZ = 1.f;
-	Stopwatch m_fireAnimationTimer;
+	FixedStepTimer m_fireAnimationTimer;
 };
 
@@ -1,8 +1,9 @@
 #include "Game/TowerDefinition.hpp"
 
-#include "Engine/Math/Mat44.hpp"
+#include "Game/AssetBackend.hpp"
 
-#include "Game/GameCommon.hpp"
+#include "Engine/Core/ErrorWarningAssert.hpp"
+#include "Engine/Math/Mat44.hpp"
 
 
 std::map<std::string, TowerDefinition> TowerDefinition::s_towerDefs;
@@ -59,7 +60,7 @@ TowerDefinition::TowerDefinition(XmlElement const* element)
 	std::string modelName = ParseXmlAttribute(*element, "model", "");
 	if (!modelName.empty())
 	{
-		m_model = g_modelLoader->CreateOrGetModelFromObj(modelName.c_str(), modelTransformMatrix);
+		m_model = g_assetBackend->CreateOrGetModel(modelName, modelTransformMatrix);
 	}
 
 	Mat44 turretTransformMatrix = Mat44::IDENTITY;
@@ -71,14 +72,10 @@ TowerDefinition::TowerDefinition(XmlElement const* element)
 	std::string turretModelName = ParseXmlAttribute(*element, "turretModel", "");
 	if (!turretModelName.empty())
 	{
-		m_turretModel = g_modelLoader->CreateOrGetModelFromObj(turretModelName.c_str(), turretTransformMatrix);
+		m_turretModel = g_assetBackend->CreateOrGetModel(turretModelName, turretTransformMatrix);
 	}
 
-	std::string fireSoundName = ParseXmlAttribute(*element, "fireSFX", "");
-	if (!fireSoundName.empty())
-	{
-		m_fireSound = g_audio->CreateOrGetSound(fireSoundName, true);
-	}
+	m_fireSoundPath = ParseXmlAttribute(*element, "fireSFX", m_fireSoundPath);
 
 	m_firedParticleOffset = ParseXmlAttribute(*element, "firedParticlePosition", m_firedParticleOffset);
 	m_firedParticleName = ParseXmlAttribute(*element, "firedParticle", m_firedParticleName);
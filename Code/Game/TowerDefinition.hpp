@@ -1,14 +1,16 @@
 #pragma once
 
-#include "Engine/Audio/AudioSystem.hpp"
-#include "Engine/Core/Models/Model.hpp"
 #include "Engine/Core/Rgba8.hpp"
 #include "Engine/Core/XMLUtils.hpp"
 #include "Engine/Math/FloatRange.hpp"
+#include "Engine/Math/Vec3.hpp"
 
+#include <climits>
 #include <string>
 #include <map>
 
+class Model;
+
 class TowerDefinition
 {
 public:
@@ -43,7 +45,8 @@ public:
 	Model* m_model = nullptr;
 	Model* m_turretModel = nullptr;
 	int m_cost = INT_MAX;
-	SoundID m_fireSound = MISSING_SOUND_ID;
+	// Loaded by the map that plays it, since the simulation library has no audio
+	std::string m_fireSoundPath = "";
 
 	static std::map<std::string, TowerDefinition> s_towerDefs;
 	
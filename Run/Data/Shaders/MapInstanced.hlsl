@@ -0,0 +1,125 @@
+//------------------------------------------------------------------------------------------------
+struct vs_input_t
+{
+	float3 localPosition : POSITION;
+	float4 color : COLOR;
+	float2 uv : TEXCOORD;
+	float3 localTangent : TANGENT;
+	float3 localBitangent : BITANGENT;
+	float3 localNormal : NORMAL;
+};
+
+//------------------------------------------------------------------------------------------------
+struct v2p_t
+{
+	float4 position : SV_Position;
+	float4 color : COLOR;
+	float2 uv : TEXCOORD;
+	float4 tangent : TANGENT;
+	float4 bitangent : BITANGENT;
+	float4 normal : NORMAL;
+	float4 worldPosition : WORLD_POSITION;
+};
+
+//------------------------------------------------------------------------------------------------
+cbuffer LightConstants : register(b1)
+{
+	float3 SunDirection;
+	float SunIntensity;
+	float AmbientIntensity;
+};
+
+//------------------------------------------------------------------------------------------------
+cbuffer CameraConstants : register(b2)
+{
+	float4x4 ViewMatrix;
+	float4x4 ProjectionMatrix;
+};
+
+//------------------------------------------------------------------------------------------------
+cbuffer ModelConstants : register(b3)
+{
+	float4x4 ModelMatrix;
+	float4 ModelColor;
+};
+
+//------------------------------------------------------------------------------------------------
+cbuffer ReyTDConstants : register(b8)
+{
+	float4 b_skyColor;
+	float4 b_mapCenter;
+	float b_fogStartDistance;
+	float b_fogEndDistance;
+	float b_fogMaxAlpha;
+	float b_padding0;
+};
+
+
+//------------------------------------------------------------------------------------------------
+#define MAX_INSTANCES_PER_DRAW 32
+
+struct InstanceData
+{
+	float4x4 InstanceModelMatrix;
+	float4 InstanceColor;
+};
+
+cbuffer InstanceConstants : register(b9)
+{
+	InstanceData Instances[MAX_INSTANCES_PER_DRAW];
+	uint NumVertsPerInstance;
+	float3 InstancePadding;
+};
+
+//------------------------------------------------------------------------------------------------
+Texture2D diffuseTexture : register(t0);
+
+//------------------------------------------------------------------------------------------------
+SamplerState diffuseSampler : register(s0);
+
+//------------------------------------------------------------------------------------------------
+v2p_t VertexMain(vs_input_t input, uint vertexID : SV_VertexID)
+{
+	// The batch vertex buffer repeats the model's triangle list once per instance, and every draw starts at its first vertex
+	uint instanceIndex = vertexID / NumVertsPerInstance;
+	InstanceData instance = Instances[instanceIndex];
+	float4 localPosition = float4(input.localPosition, 1);
+	float4 worldPosition = mul(ModelMatrix, mul(instance.InstanceModelMatrix, localPosition));
+	float4 viewPosition = mul(ViewMatrix, worldPosition);
+	float4 clipPosition = mul(ProjectionMatrix, viewPosition);
+	float4 localNormal = float4(input.localNormal, 0);
+	float4 worldNormal = mul(ModelMatrix, mul(instance.InstanceModelMatrix, localNormal));
+
+	v2p_t v2p;
+	v2p.position = clipPosition;
+	v2p.color = input.color * instance.InstanceColor;
+	v2p.uv = input.uv;
+	v2p.tangent = float4(0, 0, 0, 0);
+	v2p.bitangent = float4(0, 0, 0, 0);
+	v2p.normal = worldNormal;
+	v2p.worldPosition = worldPosition;
+	return v2p;
+}
+
+//------------------------------------------------------------------------------------------------
+float4 PixelMain(v2p_t input) : SV_Target0
+{
+	float ambient = AmbientIntensity;
+	float directional = SunIntensity * saturate(dot(normalize(input.normal.xyz), -SunDirection));
+	float4 lightColor = float4((ambient + directional).xxx, 1);
+	float4 textureColor = diffuseTexture.Sample(diffuseSampler, input.uv);
+	float4 vertexColor = input.color;
+	float4 modelColor = ModelColor;
+	float4 color = lightColor * textureColor * vertexColor * modelColor;
+	clip(color.a - 0.01f);
+	
+	// Compute the fog
+	float3 dispMapCenterToPixel = input.worldPosition.xyz - b_mapCenter.xyz;
+	float distMapCenterToPixel = length( dispMapCenterToPixel );
+	float fogDensity = b_fogMaxAlpha * saturate( (distMapCenterToPixel - b_fogStartDistance) / (b_fogEndDistance - b_fogStartDistance) );
+	float3 finalRGB = lerp( color.rgb, b_skyColor.rgb, fogDensity );
+	float finalAlpha = saturate( color.a + fogDensity ); // fog can add opacity
+	float4 finalColor = float4( finalRGB, finalAlpha );
+	
+	return finalColor;
+}
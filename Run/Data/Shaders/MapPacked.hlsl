@@ -0,0 +1,120 @@
+//------------------------------------------------------------------------------------------------
+// Vertex_MapPacked read through the VERTEX_PCU layout; each position float is a whole number, 1 more than a 24-bit payload, and its sign is one more bit
+// x: quantized x | normal x byte << 16, sign bitangent flip; y: quantized y | normal y byte << 16, sign tangent angle bit 8; z: quantized z | tangent angle low byte << 16, sign tangent angle bit 9
+struct vs_input_t
+{
+	float3 packedPosition : POSITION;
+	float4 color : COLOR;
+	float2 uv : TEXCOORD;
+};
+
+//------------------------------------------------------------------------------------------------
+struct v2p_t
+{
+	float4 position : SV_Position;
+	float4 color : COLOR;
+	float2 uv : TEXCOORD;
+	float4 tangent : TANGENT;
+	float4 bitangent : BITANGENT;
+	float4 normal : NORMAL;
+	float4 worldPosition : WORLD_POSITION;
+};
+
+//------------------------------------------------------------------------------------------------
+cbuffer LightConstants : register(b1)
+{
+	float3 SunDirection;
+	float SunIntensity;
+	float AmbientIntensity;
+};
+
+//------------------------------------------------------------------------------------------------
+cbuffer CameraConstants : register(b2)
+{
+	float4x4 ViewMatrix;
+	float4x4 ProjectionMatrix;
+};
+
+//------------------------------------------------------------------------------------------------
+cbuffer ModelConstants : register(b3)
+{
+	float4x4 ModelMatrix;
+	float4 ModelColor;
+};
+
+//------------------------------------------------------------------------------------------------
+cbuffer ReyTDConstants : register(b8)
+{
+	float4 b_skyColor;
+	float4 b_mapCenter;
+	float b_fogStartDistance;
+	float b_fogEndDistance;
+	float b_fogMaxAlpha;
+	float b_padding0;
+};
+
+
+//------------------------------------------------------------------------------------------------
+Texture2D diffuseTexture : register(t0);
+
+//------------------------------------------------------------------------------------------------
+SamplerState diffuseSampler : register(s0);
+
+//------------------------------------------------------------------------------------------------
+// Must stay in step with DecodeOctahedral in PackedMapVertex.cpp
+float3 DecodeOctahedral(uint octDirection)
+{
+	float2 oct = (float2(octDirection & 0xFF, (octDirection >> 8) & 0xFF) - 128.0) / 127.0;
+	float3 direction = float3(oct, 1.0 - abs(oct.x) - abs(oct.y));
+	float fold = saturate(-direction.z);
+	direction.xy += (direction.xy >= 0.0) ? -fold : fold;
+	return normalize(direction);
+}
+
+//------------------------------------------------------------------------------------------------
+v2p_t VertexMain(vs_input_t input)
+{
+	// The words are exact whole numbers, so converting them back to integers loses nothing
+	uint3 packedWords = (uint3)abs(input.packedPosition) - 1;
+	float3 quantizedPosition = float3(packedWords & 0xFFFF);
+	// Lighting only needs the normal; the tangent angle and bitangent sign are left for shaders that sample normal maps
+	float3 worldNormal = DecodeOctahedral((packedWords.x >> 16) | ((packedWords.y >> 16) << 8));
+
+	// The model matrix only scales and offsets quantized positions, so it is not applied to the already world space directions
+	float4 worldPosition = mul(ModelMatrix, float4(quantizedPosition, 1));
+	float4 viewPosition = mul(ViewMatrix, worldPosition);
+	float4 clipPosition = mul(ProjectionMatrix, viewPosition);
+
+	v2p_t v2p;
+	v2p.position = clipPosition;
+	v2p.color = input.color;
+	v2p.uv = input.uv;
+	v2p.tangent = float4(0, 0, 0, 0);
+	v2p.bitangent = float4(0, 0, 0, 0);
+	v2p.normal = float4(worldNormal, 0);
+	v2p.worldPosition = worldPosition;
+	return v2p;
+}
+
+//------------------------------------------------------------------------------------------------
+float4 PixelMain(v2p_t input) : SV_Target0
+{
+	float ambient = AmbientIntensity;
+	float directional = SunIntensity * saturate(dot(normalize(input.normal.xyz), -SunDirection));
+	float4 lightColor = float4((ambient + directional).xxx, 1);
+	float4 textureColor = diffuseTexture.Sample(diffuseSampler, input.uv);
+	float4 vertexColor = input.color;
+	float4 modelColor = ModelColor;
+	float4 color = lightColor * textureColor * vertexColor * modelColor;
+	clip(color.a - 0.01f);
+	
+	// Compute the fog
+	float3 dispMapCenterToPixel = input.worldPosition.xyz - b_mapCenter.xyz;
+	float distMapCenterToPixel = length( dispMapCenterToPixel );
+	float fogDensity = b_fogMaxAlpha * saturate( (distMapCenterToPixel - b_fogStartDistance) / (b_fogEndDistance - b_fogStartDistance) );
+	float3 finalRGB = lerp( color.rgb, b_skyColor.rgb, fogDensity );
+	float finalAlpha = saturate( color.a + fogDensity ); // fog can add opacity
+	float4 finalColor = float4( finalRGB, finalAlpha );
+	
+	return finalColor;
+}